@@ -2,6 +2,10 @@
 #include <vector>
 #include <utility>
 #include <array>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
 
 struct FaceProperties {
     double area;
@@ -11,6 +15,18 @@ struct FaceProperties {
 };
 
 namespace cgal_tools {
+	namespace detail {
+		template <typename Scalar, typename Index> struct MeshingBuffers;
+	}
+
+	/// ؽ Scalarfloat / double Index ʵ
+	/// Index ֧ std::uint32_tstd::uint64_tԼɽӿʹõ int
+	/// float  + uint32 Ļ double + uint64 Լ֮һ 2^32 ߵģ uint64
+	template <typename Scalar, typename Index> class BasicMeshingWorkspace;
+
+	// ɽӿʹõĹdouble ꡢint 
+	using MeshingWorkspace = BasicMeshingWorkspace<double, int>;
+
 	/// <summary>
 	/// Ϣmesh
 	/// </summary>
@@ -18,8 +34,160 @@ namespace cgal_tools {
 	/// <param name="edges">ά[num_edges, 3]ʾnum_edgesߵɵ㣬Լñǲǻ</param>
 	/// <param name="edges_info">ά[num_edges, 3]߱ϵֱ꣨ȫΪ0</param>
 	/// <returns>pair (faces[num_faces, n], properties) properties ֶΪarea, center_x, center_y, center_z</returns>
-	std::pair<std::vector<std::vector<int>>, std::vector<FaceProperties>>  
+	std::pair<std::vector<std::vector<int>>, std::vector<FaceProperties>>
 		reconstruct_meshes(const std::vector<std::array<double, 3>>& points,
 							const std::vector<std::array<int, 3>>& edges,
 							const std::vector<std::array<double, 3>>& edges_info);
-}
\ No newline at end of file
+
+	/// <summary>
+	/// ͬϣм仺ڿɸõ workspace С
+	/// ͬһ workspace ʱ㹻ٲѷ䡣
+	/// 2 *  Index ıʾΧʱ׳ std::length_error
+	/// </summary>
+	/// <param name="workspace"> CSR ʽ棺face_offsets()[f] ~ face_offsets()[f+1] Ϊ f  face_indices() еķΧ</param>
+	template <typename Scalar, typename Index>
+	void reconstruct_meshes(const std::vector<std::array<Scalar, 3>>& points,
+							const std::vector<std::array<Index, 3>>& edges,
+							const std::vector<std::array<Scalar, 3>>& edges_info,
+							BasicMeshingWorkspace<Scalar, Index>& workspace);
+
+	// ɽӿڣת reconstruct_meshes<double, int>
+	void reconstruct_meshes(const std::vector<std::array<double, 3>>& points,
+							const std::vector<std::array<int, 3>>& edges,
+							const std::vector<std::array<double, 3>>& edges_info,
+							MeshingWorkspace& workspace);
+
+	/// <summary>
+	/// õοʱ㷨ȡ  - centerʱڹ originΪ normal ƽ
+	/// Ĭÿεֿؽʱʹģ͵Ĳοؽƴ
+	/// </summary>
+	struct MeshingReference {
+		bool planar = false;
+		std::array<double, 3> center{};  // ȫ
+		std::array<double, 3> origin{};  // ߵĵ
+		std::array<double, 3> normal{};  // ƽĵλ򣨲һ棩
+	};
+
+	/// <summary>
+	///  reconstruct_meshes ͬĹ MeshingReferenceԴӴʽȡ
+	///   MeshingReferenceBuilder rb;
+	///   do { for (ÿ) rb.add(x, y, z, used); } while (rb.next_pass());
+	/// used ʾõһߣÿһ鶼ͬ˳ȫ㣬
+	/// </summary>
+	class MeshingReferenceBuilder {
+	public:
+		MeshingReferenceBuilder();
+		void add(double x, double y, double z, bool used);
+		// ǰһ飬ǷҪٱһ
+		bool next_pass();
+		const MeshingReference& result() const { return m_ref; }
+
+	private:
+		int m_pass = 0;
+		std::size_t m_count = 0;
+		std::size_t m_used = 0;
+		double m_sum[3] = {};
+		double m_usedSum[3] = {};
+		double m_lo[3];
+		double m_hi[3];
+		double m_cov[6] = {}; // xx xy xz yy yz zz
+		double m_tolerance = 0.0;
+		bool m_withinTolerance = true;
+		MeshingReference m_ref;
+	};
+
+	/// <summary>
+	/// ߵļ P1յ P2һ M ȷ
+	/// ÿֻһΣơʰȡʱͬһ double 
+	/// </summary>
+	struct ArcGeometry {
+		std::array<double, 3> center{};  // Բģ㹲ʱΪ NaN
+		std::array<double, 3> normal{};  // (P2 - P1) x (M - P1)δһֶ -normal  P1  M ת P2
+		double radius = 0.0;             // ʱΪ 0
+		double sweep = 0.0;              //  P1  M  P2 ԲĽǣȣ0 ~ 2PIʱΪ 0
+		double segment_area = 0.0;       // ֮ĹΪʱΪ 0
+	};
+
+	struct ArcPoints {
+		std::array<double, 3> p1, p2, m;
+	};
+
+	// 㻡߼SIMD֧ʱ˻رout  arcs һһӦ
+	void compute_arc_geometry(const std::vector<ArcPoints>& arcs, std::vector<ArcGeometry>& out);
+
+	/// <summary>
+	/// ؽĹڽӱ򻷡ʱǡȻͳһڴ˸
+	/// </summary>
+	template <typename Scalar, typename Index>
+	class BasicMeshingWorkspace {
+	public:
+		BasicMeshingWorkspace();
+		~BasicMeshingWorkspace();
+		BasicMeshingWorkspace(BasicMeshingWorkspace&&) noexcept;
+		BasicMeshingWorkspace& operator=(BasicMeshingWorkspace&&) noexcept;
+		BasicMeshingWorkspace(const BasicMeshingWorkspace&) = delete;
+		BasicMeshingWorkspace& operator=(const BasicMeshingWorkspace&) = delete;
+
+		// /Ԥ״εʱ
+		void reserve(std::size_t num_points, std::size_t num_edges);
+		// ͷȫ湤̣߳ˮλ¼
+		void release();
+
+		// ǰռõĻֽ capacity ƣ
+		std::size_t reserved_bytes() const;
+		// εлֵֽ滮
+		std::size_t high_water_bytes() const;
+
+		// һεõĽ
+		std::size_t face_count() const;
+		const std::vector<Index>& face_offsets() const;
+		const std::vector<Index>& face_indices() const;
+		//  face_indices() һһӦе i 㵽һ㣨һصһ㣩ı edges е
+		const std::vector<Index>& face_edges() const;
+		const std::vector<FaceProperties>& face_properties() const;
+		// һεõǷ棨ʱͳһƽϵ򣬲ȥ߽磩
+		bool planar() const;
+		// һεʹõĲο
+		const MeshingReference& reference() const;
+		// ָοΪգΪʱÿεڵڼЧ
+		void set_reference(const MeshingReference* reference);
+		// ָԤõĻ߼Ϊգ edges лֵ߳˳ÿһ
+		// 뻡һʱֱ㣬ճ edges_info 㡣ڵڼЧ
+		void set_arc_geometry(const std::vector<ArcGeometry>* arcs);
+
+		// ȡǣΪգ߳λ󣬽еؽ췵ؿս
+		void set_cancel_flag(const std::atomic<bool>* flag);
+		// һεǷȡ;
+		bool cancelled() const;
+
+		// 棨ȡ棩ʹõ߳0 ΪԶӲ߳1 Ϊ̡߳
+		// ʱǵ̣߳߳̽뵥߳ȫͬ
+		// ߳״ζ߳ʱ֮ workspace иã
+		// ̵߳ĻСֻȡ룬ͬô
+		void set_thread_count(int threads);
+		int thread_count() const;
+
+		using Buffers = detail::MeshingBuffers<Scalar, Index>;
+
+	private:
+		template <typename S, typename I>
+		friend void reconstruct_meshes(const std::vector<std::array<S, 3>>&,
+									   const std::vector<std::array<I, 3>>&,
+									   const std::vector<std::array<S, 3>>&,
+									   BasicMeshingWorkspace<S, I>&);
+		std::unique_ptr<Buffers> m_buf;
+		std::size_t m_highWater = 0;
+		const std::atomic<bool>* m_cancel = nullptr;
+		const MeshingReference* m_reference = nullptr;
+		const std::vector<ArcGeometry>* m_arcGeometry = nullptr;
+		bool m_cancelled = false;
+		int m_threads = 0;
+	};
+
+	// ʵ geometry_utils.cpp ʽ
+	extern template class BasicMeshingWorkspace<double, int>;
+	extern template class BasicMeshingWorkspace<float, std::uint32_t>;
+	extern template class BasicMeshingWorkspace<double, std::uint32_t>;
+	extern template class BasicMeshingWorkspace<float, std::uint64_t>;
+	extern template class BasicMeshingWorkspace<double, std::uint64_t>;
+}
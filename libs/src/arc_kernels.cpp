@@ -0,0 +1,261 @@
+#include "arc_kernels.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define ARC_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ARC_KERNELS_AVX2_TARGET
+#else
+#define ARC_KERNELS_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+// 公式说明（标量与 SIMD 实现相同）：
+//   外心用重心坐标 alpha : beta : gamma，与原来逐条计算的 getCircleCenter 一致；
+//   半径 R = abc / (2|n|)，|n| 为三角形面积的两倍；
+//   M 处的内角 theta 满足 sweep = 2PI - 2 theta（圆周角定理），即 sweep = 2 atan2(|n|, -(P1-M)·(P2-M))，
+//   只需一次 atan2，不再对两段分别求 acos，小角度时也不会像 acos 那样丢精度；
+//   弓形面积 = R^2 / 2 * (sweep - sin(sweep))，sin(sweep) = -2 |n| ((P1-M)·(P2-M)) / (a^2 b^2)，
+//   劣弧、优弧不用分情况。sweep 很小时 sweep - sin(sweep) 相消严重，改用泰勒展开
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kEps = 1e-12;
+// sweep 小于此值时用泰勒展开计算 sweep - sin(sweep)（截断误差约 1e-15，相对）
+constexpr double kSeriesLimit = 0.1;
+
+// t - sin(t) 的展开：t^3/6 (1 - t^2/20 (1 - t^2/42 (1 - t^2/72)))
+inline double sweep_minus_sin_series(double t) {
+    const double t2 = t * t;
+    return t * t2 / 6.0 * (1.0 - t2 / 20.0 * (1.0 - t2 / 42.0 * (1.0 - t2 / 72.0)));
+}
+
+void compute_scalar(arc_kernels::ArcSoA& a, std::size_t begin, std::size_t end) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = begin; i < end; ++i) {
+        const double p1x = a.p1x[i], p1y = a.p1y[i], p1z = a.p1z[i];
+        const double p2x = a.p2x[i], p2y = a.p2y[i], p2z = a.p2z[i];
+        const double mx = a.mx[i], my = a.my[i], mz = a.mz[i];
+
+        // n = (P2 - P1) x (M - P1)
+        const double v1x = p2x - p1x, v1y = p2y - p1y, v1z = p2z - p1z;
+        const double v2x = mx - p1x, v2y = my - p1y, v2z = mz - p1z;
+        const double nx = v1y * v2z - v1z * v2y;
+        const double ny = v1z * v2x - v1x * v2z;
+        const double nz = v1x * v2y - v1y * v2x;
+        a.nx[i] = nx;
+        a.ny[i] = ny;
+        a.nz[i] = nz;
+        const double area2 = std::sqrt(nx * nx + ny * ny + nz * nz);
+
+        // u = P1 - M, w = P2 - M
+        const double ux = p1x - mx, uy = p1y - my, uz = p1z - mz;
+        const double wx = p2x - mx, wy = p2y - my, wz = p2z - mz;
+        const double a2 = wx * wx + wy * wy + wz * wz;
+        const double b2 = ux * ux + uy * uy + uz * uz;
+        const double c2 = v1x * v1x + v1y * v1y + v1z * v1z;
+
+        const double alpha = a2 * (b2 + c2 - a2);
+        const double beta = b2 * (c2 + a2 - b2);
+        const double gamma = c2 * (a2 + b2 - c2);
+        const double sum = alpha + beta + gamma;
+
+        if (area2 < kEps || std::abs(sum) < kEps) {
+            // 三点几乎共线，当作直线处理
+            a.cx[i] = a.cy[i] = a.cz[i] = nan;
+            a.radius[i] = a.sweep[i] = a.segment_area[i] = 0.0;
+            continue;
+        }
+
+        a.cx[i] = (alpha * p1x + beta * p2x + gamma * mx) / sum;
+        a.cy[i] = (alpha * p1y + beta * p2y + gamma * my) / sum;
+        a.cz[i] = (alpha * p1z + beta * p2z + gamma * mz) / sum;
+
+        const double r2 = a2 * b2 * c2 / (4.0 * area2 * area2);
+        const double dot = ux * wx + uy * wy + uz * wz;
+        const double sweep = 2.0 * std::atan2(area2, -dot);
+        const double sin_sweep = -2.0 * area2 * dot / (a2 * b2);
+
+        a.radius[i] = std::sqrt(r2);
+        a.sweep[i] = sweep;
+        a.segment_area[i] = 0.5 * r2 * (sweep < kSeriesLimit ? sweep_minus_sin_series(sweep) : sweep - sin_sweep);
+    }
+}
+
+#ifdef ARC_KERNELS_X86
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx) return false;
+    // 操作系统需要保存 YMM 寄存器
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+// atan(t)，t 在 [0, 1]。Cephes atan 的有理逼近，双精度误差约 1 ulp
+ARC_KERNELS_AVX2_TARGET
+inline __m256d atan01_avx2(__m256d t) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    // t > 0.66 时用 atan(t) = PI/4 + atan((t-1)/(t+1))
+    const __m256d big = _mm256_cmp_pd(t, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+    const __m256d reduced = _mm256_div_pd(_mm256_sub_pd(t, one), _mm256_add_pd(t, one));
+    const __m256d x = _mm256_blendv_pd(t, reduced, big);
+    const __m256d base = _mm256_and_pd(big, _mm256_set1_pd(kPi / 4.0));
+    const __m256d morebits = _mm256_and_pd(big, _mm256_set1_pd(0.5 * 6.123233995736765886130e-17));
+
+    const __m256d z = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.615753718733365076637e1));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-7.500855792314704667340e1));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.228866684490136173410e2));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-6.485021904942025371773e1));
+    __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.650270098316988542046e2));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.328810604912902668951e2));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.853903996359136964868e2));
+    q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.945506571482613964425e2));
+
+    // x + x * z * P(z) / Q(z)
+    const __m256d r = _mm256_fmadd_pd(_mm256_mul_pd(x, z), _mm256_div_pd(p, q), x);
+    return _mm256_add_pd(base, _mm256_add_pd(r, morebits));
+}
+
+// atan2(s, c)，s >= 0，结果在 [0, PI]。先把比值约到 [0, 1] 再求 atan
+ARC_KERNELS_AVX2_TARGET
+inline __m256d atan2_upper_avx2(__m256d s, __m256d c) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d ac = _mm256_andnot_pd(sign, c);
+    const __m256d swap = _mm256_cmp_pd(s, ac, _CMP_GT_OQ);
+    const __m256d num = _mm256_blendv_pd(s, ac, swap);
+    const __m256d den = _mm256_blendv_pd(ac, s, swap);
+    __m256d angle = atan01_avx2(_mm256_div_pd(num, den));
+    // |c| < s：atan2 = PI/2 - atan(|c|/s)
+    angle = _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(kPi / 2.0), angle), swap);
+    // c < 0：对称到第二象限
+    const __m256d negative = _mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_LT_OQ);
+    return _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(kPi), angle), negative);
+}
+
+ARC_KERNELS_AVX2_TARGET
+void compute_avx2(arc_kernels::ArcSoA& a, std::size_t count) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d eps = _mm256_set1_pd(kEps);
+    const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d p1x = _mm256_loadu_pd(&a.p1x[i]), p1y = _mm256_loadu_pd(&a.p1y[i]), p1z = _mm256_loadu_pd(&a.p1z[i]);
+        const __m256d p2x = _mm256_loadu_pd(&a.p2x[i]), p2y = _mm256_loadu_pd(&a.p2y[i]), p2z = _mm256_loadu_pd(&a.p2z[i]);
+        const __m256d mx = _mm256_loadu_pd(&a.mx[i]), my = _mm256_loadu_pd(&a.my[i]), mz = _mm256_loadu_pd(&a.mz[i]);
+
+        const __m256d v1x = _mm256_sub_pd(p2x, p1x), v1y = _mm256_sub_pd(p2y, p1y), v1z = _mm256_sub_pd(p2z, p1z);
+        const __m256d v2x = _mm256_sub_pd(mx, p1x), v2y = _mm256_sub_pd(my, p1y), v2z = _mm256_sub_pd(mz, p1z);
+        const __m256d nx = _mm256_fmsub_pd(v1y, v2z, _mm256_mul_pd(v1z, v2y));
+        const __m256d ny = _mm256_fmsub_pd(v1z, v2x, _mm256_mul_pd(v1x, v2z));
+        const __m256d nz = _mm256_fmsub_pd(v1x, v2y, _mm256_mul_pd(v1y, v2x));
+        _mm256_storeu_pd(&a.nx[i], nx);
+        _mm256_storeu_pd(&a.ny[i], ny);
+        _mm256_storeu_pd(&a.nz[i], nz);
+        const __m256d area2 = _mm256_sqrt_pd(
+            _mm256_fmadd_pd(nx, nx, _mm256_fmadd_pd(ny, ny, _mm256_mul_pd(nz, nz))));
+
+        const __m256d ux = _mm256_sub_pd(p1x, mx), uy = _mm256_sub_pd(p1y, my), uz = _mm256_sub_pd(p1z, mz);
+        const __m256d wx = _mm256_sub_pd(p2x, mx), wy = _mm256_sub_pd(p2y, my), wz = _mm256_sub_pd(p2z, mz);
+        const __m256d a2 = _mm256_fmadd_pd(wx, wx, _mm256_fmadd_pd(wy, wy, _mm256_mul_pd(wz, wz)));
+        const __m256d b2 = _mm256_fmadd_pd(ux, ux, _mm256_fmadd_pd(uy, uy, _mm256_mul_pd(uz, uz)));
+        const __m256d c2 = _mm256_fmadd_pd(v1x, v1x, _mm256_fmadd_pd(v1y, v1y, _mm256_mul_pd(v1z, v1z)));
+
+        const __m256d alpha = _mm256_mul_pd(a2, _mm256_sub_pd(_mm256_add_pd(b2, c2), a2));
+        const __m256d beta = _mm256_mul_pd(b2, _mm256_sub_pd(_mm256_add_pd(c2, a2), b2));
+        const __m256d gamma = _mm256_mul_pd(c2, _mm256_sub_pd(_mm256_add_pd(a2, b2), c2));
+        const __m256d sum = _mm256_add_pd(_mm256_add_pd(alpha, beta), gamma);
+
+        const __m256d valid = _mm256_and_pd(_mm256_cmp_pd(area2, eps, _CMP_GE_OQ),
+                                            _mm256_cmp_pd(_mm256_andnot_pd(sign, sum), eps, _CMP_GE_OQ));
+
+        const __m256d inv_sum = _mm256_div_pd(_mm256_set1_pd(1.0), sum);
+        const __m256d cx = _mm256_mul_pd(_mm256_fmadd_pd(alpha, p1x, _mm256_fmadd_pd(beta, p2x, _mm256_mul_pd(gamma, mx))), inv_sum);
+        const __m256d cy = _mm256_mul_pd(_mm256_fmadd_pd(alpha, p1y, _mm256_fmadd_pd(beta, p2y, _mm256_mul_pd(gamma, my))), inv_sum);
+        const __m256d cz = _mm256_mul_pd(_mm256_fmadd_pd(alpha, p1z, _mm256_fmadd_pd(beta, p2z, _mm256_mul_pd(gamma, mz))), inv_sum);
+
+        const __m256d r2 = _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(a2, b2), c2),
+                                         _mm256_mul_pd(_mm256_set1_pd(4.0), _mm256_mul_pd(area2, area2)));
+        const __m256d dot = _mm256_fmadd_pd(ux, wx, _mm256_fmadd_pd(uy, wy, _mm256_mul_pd(uz, wz)));
+        const __m256d sweep = _mm256_mul_pd(_mm256_set1_pd(2.0), atan2_upper_avx2(area2, _mm256_xor_pd(dot, sign)));
+        const __m256d sin_sweep = _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(-2.0), _mm256_mul_pd(area2, dot)),
+                                                _mm256_mul_pd(a2, b2));
+        const __m256d t2 = _mm256_mul_pd(sweep, sweep);
+        __m256d series = _mm256_fnmadd_pd(t2, _mm256_set1_pd(1.0 / 72.0), _mm256_set1_pd(1.0));
+        series = _mm256_fnmadd_pd(_mm256_mul_pd(t2, _mm256_set1_pd(1.0 / 42.0)), series, _mm256_set1_pd(1.0));
+        series = _mm256_fnmadd_pd(_mm256_mul_pd(t2, _mm256_set1_pd(1.0 / 20.0)), series, _mm256_set1_pd(1.0));
+        series = _mm256_mul_pd(_mm256_mul_pd(sweep, t2), _mm256_mul_pd(_mm256_set1_pd(1.0 / 6.0), series));
+        const __m256d small = _mm256_cmp_pd(sweep, _mm256_set1_pd(kSeriesLimit), _CMP_LT_OQ);
+        const __m256d shape = _mm256_blendv_pd(_mm256_sub_pd(sweep, sin_sweep), series, small);
+        const __m256d segment = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), r2), shape);
+
+        // 共线的通道：圆心 NaN，其余为 0
+        _mm256_storeu_pd(&a.cx[i], _mm256_blendv_pd(nan, cx, valid));
+        _mm256_storeu_pd(&a.cy[i], _mm256_blendv_pd(nan, cy, valid));
+        _mm256_storeu_pd(&a.cz[i], _mm256_blendv_pd(nan, cz, valid));
+        _mm256_storeu_pd(&a.radius[i], _mm256_blendv_pd(zero, _mm256_sqrt_pd(r2), valid));
+        _mm256_storeu_pd(&a.sweep[i], _mm256_blendv_pd(zero, sweep, valid));
+        _mm256_storeu_pd(&a.segment_area[i], _mm256_blendv_pd(zero, segment, valid));
+    }
+    compute_scalar(a, i, count);
+}
+
+#endif // ARC_KERNELS_X86
+
+}
+
+namespace arc_kernels {
+
+void ArcSoA::resize(std::size_t n) {
+    for (auto* v : { &p1x, &p1y, &p1z, &p2x, &p2y, &p2z, &mx, &my, &mz,
+                     &cx, &cy, &cz, &radius, &sweep, &segment_area, &nx, &ny, &nz }) {
+        v->resize(n);
+    }
+}
+
+std::size_t ArcSoA::bytes() const {
+    // 18 个数组容量相同
+    return 18 * p1x.capacity() * sizeof(double);
+}
+
+Isa detected_isa() {
+#ifdef ARC_KERNELS_X86
+    static const Isa isa = cpu_has_avx2() ? Isa::Avx2 : Isa::Scalar;
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+void compute(ArcSoA& arcs, Isa isa) {
+#ifdef ARC_KERNELS_X86
+    if (isa == Isa::Avx2 && detected_isa() == Isa::Avx2) {
+        compute_avx2(arcs, arcs.size());
+        return;
+    }
+#endif
+    (void)isa;
+    compute_scalar(arcs, 0, arcs.size());
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+// geometry_utils 内部使用：批量计算弧线的圆心、半径、圆心角和弓形面积
+#include <cstddef>
+#include <vector>
+
+namespace arc_kernels {
+
+// 一批弧线，结构数组（每个数组长度相同），便于按 SIMD 宽度连续读取
+struct ArcSoA {
+    // 输入：起点 P1、终点 P2、弧上一点 M
+    std::vector<double> p1x, p1y, p1z;
+    std::vector<double> p2x, p2y, p2z;
+    std::vector<double> mx, my, mz;
+
+    // 输出：圆心、半径、圆心角（弧度，0 ~ 2PI，经过 M 的那段弧）、弓形面积（弧与弦之间，恒为正）
+    // 三点共线时圆心为 NaN，半径、圆心角、面积为 0
+    std::vector<double> cx, cy, cz;
+    std::vector<double> radius, sweep, segment_area;
+    // (P2 - P1) x (M - P1)，与面法向点乘判断弧线凸凹；P1、P2 交换时取反
+    std::vector<double> nx, ny, nz;
+
+    void resize(std::size_t n);
+    std::size_t size() const { return p1x.size(); }
+    std::size_t bytes() const;
+};
+
+enum class Isa {
+    Scalar,
+    Avx2
+};
+
+// 运行时检测到的最优指令集（只检测一次）
+Isa detected_isa();
+
+// 计算全部弧线。默认用 detected_isa()，传 Isa::Scalar 可强制走标量实现（对照用）；
+// 请求的指令集当前 CPU 不支持时退回标量
+void compute(ArcSoA& arcs, Isa isa = detected_isa());
+
+}
@@ -1,26 +1,34 @@
 #include "geometry_utils.h"
+#include "arc_kernels.h"
 // #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <cmath>
 #include <vector>
-#include <map>
+#include <limits>
 #include <iostream>
 #include <utility>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
 
 // #define DATA_PATH "C:/WorkSpace/11_17/codes/CGAL-test/data/"
 constexpr auto PI = 3.1415926536;
 
 struct Vector_3;
 
-struct Point_3 {
-    double _x, _y, _z;
-    Point_3() : _x(0), _y(0), _z(0) {}
-    Point_3(double x, double y, double z) : _x(x), _y(y), _z(z) {}
+// 点，按输入的坐标类型存储（float 输入时省一半内存），读取时一律转为 double 参与计算
+template <typename Scalar>
+struct Point3 {
+    Scalar _x, _y, _z;
+    Point3() : _x(0), _y(0), _z(0) {}
+    Point3(Scalar x, Scalar y, Scalar z) : _x(x), _y(y), _z(z) {}
 
     double x() const { return _x; }
     double y() const { return _y; }
     double z() const { return _z; }
 };
+using Point_3 = Point3<double>;
 
 // 简单向量类型
 struct Vector_3 {
@@ -34,7 +42,8 @@ struct Vector_3 {
 };
 
 // 点-点 得到向量
-inline Vector_3 operator-(const Point_3& a, const Point_3& b) {
+template <typename A, typename B>
+inline Vector_3 operator-(const Point3<A>& a, const Point3<B>& b) {
     return Vector_3(a.x() - b.x(), a.y() - b.y(), a.z() - b.z());
 }
 
@@ -72,24 +81,29 @@ inline Point_3 operator+(const Point_3& p, const Vector_3& v) {
 // typedef CGAL::Surface_mesh<Point_3> Mesh;
 
 // 储存边信息，包括点索引、是否弧线，第三点坐标
-struct Edge { 
-    int point1, point2; 
+template <typename Scalar, typename Index>
+struct EdgeT {
+    Index point1, point2;
 	int is_arc = 0; // 0 直线，1 弧线
-	Point_3 arc_center;
+	Point3<Scalar> arc_center;
 	// double arc_angle = 0.0; // 弧度
     // 构造直线边
-    Edge(int p1, int p2)
+    EdgeT(Index p1, Index p2)
         : point1(p1), point2(p2),
         is_arc(0), arc_center(0, 0, 0) {
     }
 
     // 构造弧线边
-    Edge(int p1, int p2, int isarc, const Point_3& center)
+    EdgeT(Index p1, Index p2, int isarc, const Point3<Scalar>& center)
         : point1(p1), point2(p2),
         is_arc(isarc), arc_center(center){
     }
 };
 
+// 索引数组中的"无"（不存在的环位置、块等）。索引可能是无符号类型，不用 -1
+template <typename Index>
+constexpr Index kNone = std::numeric_limits<Index>::max();
+
 static constexpr double EPS = 1e-6;
 
 // 向量运算
@@ -114,21 +128,725 @@ static double vecDot(const Vector_3& a, const Vector_3& b) {
     return a.x * b.x + a.y * b.y + a.z * b.z;
 }
 
-static double vecNorm(const Vector_3& a) {
-    return std::sqrt(a.squared_length());
+
+// 排序环时每个邻居在切平面中的方向（只比较方向，不求极角）
+template <typename Index>
+struct NeighborDir {
+    Index idx;
+    Index slot; // 该邻居在 CSR 邻接表中的位置
+    int half;   // 所在区间，见 dir_half
+    double x, y;
+};
+
+// 把方向按 atan2(y, x) 的取值分成四段：0 为 (-PI, 0)，1 为零向量（atan2 = 0），
+// 2 为 [0, PI)（不含零向量），3 为负 x 轴（PI）。同一段内任意两个方向夹角小于 PI，可以直接比叉积
+static inline int dir_half(double x, double y) {
+    if (y < 0.0) return 0;
+    if (y > 0.0) return 2;
+    return x > 0.0 ? 2 : (x < 0.0 ? 3 : 1);
+}
+
+// 按极角升序比较，与按 atan2 排序的顺序一致，但不做三角运算。
+// 方向相同（共线同向、重复边）时按邻接表位置，结果与排序算法无关
+template <typename Index>
+static inline bool dir_less(const NeighborDir<Index>& a, const NeighborDir<Index>& b) {
+    if (a.half != b.half) return a.half < b.half;
+    double cross = a.x * b.y - a.y * b.x;
+    if (cross != 0.0) return cross > 0.0;
+    return a.slot < b.slot;
+}
+
+// 度数 <= 8（绝大多数点）时用插入排序，比 std::sort 的通用路径快
+template <typename Index>
+static void sort_dirs(NeighborDir<Index>* d, int n) {
+    if (n > 8) {
+        std::sort(d, d + n, dir_less<Index>);
+        return;
+    }
+    for (int i = 1; i < n; ++i) {
+        NeighborDir<Index> key = d[i];
+        int j = i - 1;
+        while (j >= 0 && dir_less(key, d[j])) {
+            d[j + 1] = d[j];
+            --j;
+        }
+        d[j + 1] = key;
+    }
+}
+
+// 常驻工作线程：首次需要时创建，之后每次 run 只唤醒，不再创建线程。
+// run(threads, fn) 让调用线程执行 fn(0)，工作线程分别执行 fn(1) .. fn(threads - 1)，全部结束后返回
+struct WorkerPool {
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& th : m_workers) th.join();
+    }
+
+    template <typename Fn>
+    void run(int threads, Fn& fn) {
+        const int helpers = threads - 1;
+        while ((int)m_workers.size() < helpers) {
+            const int index = (int)m_workers.size();
+            const std::size_t generation = m_generation;
+            m_workers.emplace_back([this, index, generation]() { loop(index, generation); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = [](void* context, int t) { (*static_cast<Fn*>(context))(t); };
+            m_context = &fn;
+            m_active = helpers;
+            m_pending = helpers;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_pending == 0; });
+    }
+
+private:
+    void loop(int index, std::size_t seen) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [&]() { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+            if (index >= m_active) continue; // 本轮用不到这个线程
+            void (*task)(void*, int) = m_task;
+            void* context = m_context;
+            lock.unlock();
+            task(context, index + 1);
+            lock.lock();
+            if (--m_pending == 0) m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake, m_done;
+    std::size_t m_generation = 0;
+    int m_active = 0;  // 本轮参与的工作线程数（不含调用线程）
+    int m_pending = 0; // 本轮还没做完的工作线程数
+    void (*m_task)(void*, int) = nullptr;
+    void* m_context = nullptr;
+    bool m_stop = false;
+};
+
+// BasicMeshingWorkspace 的全部缓冲。坐标按 Scalar 存储，点、边、环位置等编号一律为 Index。
+// 所有数组都只 clear/assign/resize，不 shrink，复用时保留已有容量
+template <typename Scalar, typename Index>
+struct cgal_tools::detail::MeshingBuffers {
+    using Point = Point3<Scalar>;
+    using Edge = EdgeT<Scalar, Index>;
+
+    // 输入副本
+    std::vector<Point> points;
+    std::vector<Edge> edges;
+
+    // CSR 邻接表：adj[adj_offsets[v] .. adj_offsets[v+1]) 为 v 的邻居，按边的输入顺序排列
+    std::vector<Index> adj_offsets;
+    std::vector<Index> adj;
+    std::vector<Index> adj_fill;   // 填充游标
+    std::vector<Index> slot_twin;  // 邻接位置 -> 同一条边另一端的邻接位置
+    std::vector<Index> edge_slot;  // edge_slot[2*e] 为 p1->p2 的邻接位置，[2*e+1] 为 p2->p1
+
+    // 排序环，与 adj 共用偏移；ring_deg[v] == 0 表示该点不参与走面（度数 < 2）
+    std::vector<Index> ring;
+    std::vector<Index> ring_deg;
+    std::vector<Index> ring_of_slot; // 邻接位置 -> 排序环中的位置
+    std::vector<Index> ring_canon;   // 环位置 -> 同一邻居在环中最后出现的位置（重复边时取最后一条）
+    std::vector<Index> ring_twin;    // 环位置(v->u) -> u 的环中 v 的规范位置，u 无环时为 kNone
+    std::vector<Index> ring_edge;    // 环位置 -> 对应的边索引（规范位置即重复边中的最后一条）
+    std::vector<char> visited;     // 以规范环位置标记有向边 prev->cur 是否已用于某个面
+    std::vector<NeighborDir<Index>> dirs;
+    std::vector<Scalar> plane_x, plane_y; // 平面输入时各点的平面坐标
+    cgal_tools::MeshingReference reference; // 最近一次使用的参考
+    const std::vector<cgal_tools::ArcGeometry>* arc_geometry = nullptr; // 调用方给的弧线几何量（可为空）
+    bool planar = false;
+    std::vector<std::pair<Index, Index>> canon_scratch;
+
+    // 多线程走面（见 trace_faces_parallel）
+    struct StartFace {
+        std::size_t begin, end; // 该起点走出的面在 block_indices 中的范围
+    };
+    WorkerPool pool;
+    std::unique_ptr<std::atomic<Index>[]> uf_parent; // 并查集，长度 uf_capacity
+    std::size_t uf_capacity = 0;
+    std::vector<Index> start_block;   // 起点 -> 所在块（块以其中最小的环位置编号）
+    std::vector<Index> block_offsets; // 块 -> block_starts 中的范围
+    std::vector<Index> block_starts;
+    std::vector<Index> block_fill;
+    std::vector<Index> blocks;        // 非空的块，升序
+    std::vector<Index> block_indices; // 各块的走面输出区，块 c 占 [2 * block_offsets[c], 2 * block_offsets[c+1])
+    std::vector<Index> block_edges;   // 与 block_indices 一一对应
+    std::vector<StartFace> start_faces; // 与 block_starts 一一对应
+
+    // 属性计算
+    std::vector<Point_3> face_points;
+    std::vector<Index> arc_slot;     // 边 -> arcs 中的位置，直线为 kNone
+    arc_kernels::ArcSoA arcs;      // 全部弧线的几何量，一次批量算好
+
+    // 结果
+    std::vector<Index> face_offsets;
+    std::vector<Index> face_indices;
+    std::vector<Index> face_edges;   // 与 face_indices 一一对应：第 i 个点到下一个点经过的边
+    std::vector<FaceProperties> face_props;
+
+    template <typename T>
+    static std::size_t bytesOf(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+
+    std::size_t bytes() const {
+        return bytesOf(points) + bytesOf(edges)
+            + bytesOf(adj_offsets) + bytesOf(adj) + bytesOf(adj_fill) + bytesOf(slot_twin) + bytesOf(edge_slot)
+            + bytesOf(ring) + bytesOf(ring_deg) + bytesOf(ring_of_slot) + bytesOf(ring_canon) + bytesOf(ring_twin)
+            + bytesOf(ring_edge) + bytesOf(visited) + bytesOf(dirs) + bytesOf(plane_x) + bytesOf(plane_y) + bytesOf(canon_scratch)
+            + uf_capacity * sizeof(std::atomic<Index>) + bytesOf(start_block) + bytesOf(block_offsets)
+            + bytesOf(block_starts) + bytesOf(block_fill) + bytesOf(blocks)
+            + bytesOf(block_indices) + bytesOf(block_edges) + bytesOf(start_faces)
+            + bytesOf(face_points) + bytesOf(arc_slot) + arcs.bytes()
+            + bytesOf(face_offsets) + bytesOf(face_indices) + bytesOf(face_edges) + bytesOf(face_props);
+    }
+};
+
+namespace cgal_tools {
+    template <typename Scalar, typename Index>
+    BasicMeshingWorkspace<Scalar, Index>::BasicMeshingWorkspace() : m_buf(new Buffers) {}
+    template <typename Scalar, typename Index>
+    BasicMeshingWorkspace<Scalar, Index>::~BasicMeshingWorkspace() = default;
+    template <typename Scalar, typename Index>
+    BasicMeshingWorkspace<Scalar, Index>::BasicMeshingWorkspace(BasicMeshingWorkspace&&) noexcept = default;
+    template <typename Scalar, typename Index>
+    BasicMeshingWorkspace<Scalar, Index>& BasicMeshingWorkspace<Scalar, Index>::operator=(BasicMeshingWorkspace&&) noexcept = default;
+
+    template <typename Scalar, typename Index>
+    void BasicMeshingWorkspace<Scalar, Index>::reserve(std::size_t num_points, std::size_t num_edges) {
+        Buffers& b = *m_buf;
+        b.points.reserve(num_points);
+        b.edges.reserve(num_edges);
+        b.adj_offsets.reserve(num_points + 1);
+        b.adj.reserve(num_edges * 2);
+        b.adj_fill.reserve(num_points);
+        b.slot_twin.reserve(num_edges * 2);
+        b.edge_slot.reserve(num_edges * 2);
+        b.ring.reserve(num_edges * 2);
+        b.ring_deg.reserve(num_points);
+        b.ring_of_slot.reserve(num_edges * 2);
+        b.ring_canon.reserve(num_edges * 2);
+        b.ring_twin.reserve(num_edges * 2);
+        b.ring_edge.reserve(num_edges * 2);
+        b.visited.reserve(num_edges * 2);
+        b.face_indices.reserve(num_edges * 2);
+        b.face_edges.reserve(num_edges * 2);
+        if (b.bytes() > m_highWater) m_highWater = b.bytes();
+    }
+
+    template <typename Scalar, typename Index>
+    void BasicMeshingWorkspace<Scalar, Index>::release() {
+        m_buf.reset(new Buffers);
+    }
+
+    template <typename Scalar, typename Index>
+    std::size_t BasicMeshingWorkspace<Scalar, Index>::reserved_bytes() const { return m_buf->bytes(); }
+    template <typename Scalar, typename Index>
+    std::size_t BasicMeshingWorkspace<Scalar, Index>::high_water_bytes() const { return m_highWater; }
+
+    template <typename Scalar, typename Index>
+    std::size_t BasicMeshingWorkspace<Scalar, Index>::face_count() const {
+        return m_buf->face_offsets.empty() ? 0 : m_buf->face_offsets.size() - 1;
+    }
+    template <typename Scalar, typename Index>
+    const std::vector<Index>& BasicMeshingWorkspace<Scalar, Index>::face_offsets() const { return m_buf->face_offsets; }
+    template <typename Scalar, typename Index>
+    const std::vector<Index>& BasicMeshingWorkspace<Scalar, Index>::face_indices() const { return m_buf->face_indices; }
+    template <typename Scalar, typename Index>
+    const std::vector<Index>& BasicMeshingWorkspace<Scalar, Index>::face_edges() const { return m_buf->face_edges; }
+    template <typename Scalar, typename Index>
+    const std::vector<FaceProperties>& BasicMeshingWorkspace<Scalar, Index>::face_properties() const { return m_buf->face_props; }
+    template <typename Scalar, typename Index>
+    bool BasicMeshingWorkspace<Scalar, Index>::planar() const { return m_buf->planar; }
+    template <typename Scalar, typename Index>
+    const MeshingReference& BasicMeshingWorkspace<Scalar, Index>::reference() const { return m_buf->reference; }
+    template <typename Scalar, typename Index>
+    void BasicMeshingWorkspace<Scalar, Index>::set_reference(const MeshingReference* reference) { m_reference = reference; }
+    template <typename Scalar, typename Index>
+    void BasicMeshingWorkspace<Scalar, Index>::set_arc_geometry(const std::vector<ArcGeometry>* arcs) { m_arcGeometry = arcs; }
+
+    template <typename Scalar, typename Index>
+    void BasicMeshingWorkspace<Scalar, Index>::set_cancel_flag(const std::atomic<bool>* flag) { m_cancel = flag; }
+    template <typename Scalar, typename Index>
+    bool BasicMeshingWorkspace<Scalar, Index>::cancelled() const { return m_cancelled; }
+
+    template <typename Scalar, typename Index>
+    void BasicMeshingWorkspace<Scalar, Index>::set_thread_count(int threads) { m_threads = threads < 0 ? 0 : threads; }
+    template <typename Scalar, typename Index>
+    int BasicMeshingWorkspace<Scalar, Index>::thread_count() const { return m_threads; }
+}
+
+// ---------------- 走面 ----------------
+
+// 从有向边 s（s = 2*ei + di，di = 0 为 point1->point2）出发走一个面，点序列追加到 faces，
+// 每个点到下一个点经过的边同步追加到 edges（最后一条为回到起点的边）。
+// 返回是否得到有效面（闭合且至少 3 个点），否则 faces、edges 恢复原样。
+// 只读写 visited 中与起始有向边同属一个"走面连通块"的位置（见 trace_faces_parallel）。
+// Out 为 std::vector<Index> 或 SliceOut<Index>
+template <typename Scalar, typename Index, typename Out>
+static bool trace_face(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b, Index s, Index max_face_edges,
+                       Out& faces, Out& edges) {
+    const auto& e = b.edges[s >> 1];
+    const Index start_u = (s & 1) ? e.point2 : e.point1;
+    const Index start_v = (s & 1) ? e.point1 : e.point2;
+
+    // 点没有邻接环（孤立或度数过小），跳过
+    if (b.ring_deg[start_v] == 0) {
+        return false;
+    }
+
+    // start_u 在 start_v 环中的位置
+    Index pos = b.ring_canon[b.ring_of_slot[b.slot_twin[b.edge_slot[s]]]];
+
+    // 如果这条有向边已经属于某个面了，就跳过
+    auto& visited_directed_edges = b.visited;
+    if (visited_directed_edges[pos]) {
+        return false;
+    }
+
+    size_t face_begin = faces.size();
+    Index face_size = 0;
+
+    Index cur = start_v;
+
+    faces.push_back(start_u);
+    ++face_size;
+    bool closed = false;
+    bool failed = false;
+
+    while (true) {
+        // 加入当前点
+        faces.push_back(cur);
+        edges.push_back(b.ring_edge[pos]);
+        ++face_size;
+
+        // 标记当前有向边 prev->cur 已被使用
+        visited_directed_edges[pos] = 1;
+
+        Index deg = b.ring_deg[cur];
+        Index idx = pos - b.adj_offsets[cur];
+
+        // 一直逆时针walk：取 prev 在环中的前一个邻居
+        Index next_pos = b.adj_offsets[cur] + (idx == 0 ? deg - 1 : idx - 1);
+        Index next = b.ring[next_pos];
+        Index next_twin = b.ring_twin[next_pos];
+
+        // 如果下一条边的终点回到起始点 start_u，则闭合
+        if (next == start_u) {
+            // 最后这条边 cur->start_u 也属于这个面，标记已访问
+            if (next_twin != kNone<Index>) visited_directed_edges[next_twin] = 1;
+            edges.push_back(b.ring_edge[b.ring_canon[next_pos]]);
+            closed = true;
+            break;
+        }
+
+        // 下一点没有邻接环，在它的环里找不到 cur，walk 失败
+        if (next_twin == kNone<Index>) {
+            failed = true;
+            break;
+        }
+
+        // 如果下一条有向边已经被用在别的面里了，这条 walk 放弃
+        if (visited_directed_edges[next_twin]) {
+            failed = true;
+            break;
+        }
+        // 超过限定的边数
+        if (face_size > max_face_edges) {
+            failed = true;
+            break;
+        }
+
+        cur = next;
+        pos = next_twin;
+    }
+
+    if (closed && !failed && face_size >= 3) {
+        return true;
+    }
+    faces.resize(face_begin);
+    edges.resize(face_begin);
+    return false;
+}
+
+// 边数达到此值才多线程走面，小图线程开销不划算
+static constexpr std::size_t kParallelMinEdges = 200000;
+
+// 把 [0, count) 均分给 threads 个线程执行 fn(begin, end)
+template <typename N, typename Fn>
+static void parallel_for(WorkerPool& pool, int threads, N count, Fn fn) {
+    const N chunk = (count + threads - 1) / threads;
+    auto task = [&](int t) {
+        const N begin = std::min<N>(count, N(t) * chunk);
+        fn(begin, std::min<N>(count, begin + chunk));
+    };
+    pool.run(threads, task);
+}
+
+// 写入调用方预先分配好的定长区域，接口与 trace_face 用到的 std::vector 部分一致
+template <typename Index>
+struct SliceOut {
+    Index* data;
+    std::size_t count;
+    void push_back(Index v) { data[count++] = v; }
+    std::size_t size() const { return count; }
+    void resize(std::size_t n) { count = n; }
+};
+
+// 并查集（无锁）：总是把较大的根挂到较小的根下，结束后每个集合的根就是其中最小的元素，与线程调度无关
+template <typename Index>
+static Index uf_find(std::atomic<Index>* parent, Index x) {
+    while (true) {
+        Index p = parent[x].load(std::memory_order_relaxed);
+        if (p == x) return x;
+        Index gp = parent[p].load(std::memory_order_relaxed);
+        if (gp != p) parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed); // 路径减半
+        x = gp;
+    }
+}
+
+template <typename Index>
+static void uf_unite(std::atomic<Index>* parent, Index a, Index b) {
+    while (true) {
+        a = uf_find(parent, a);
+        b = uf_find(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        Index expected = a;
+        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+    }
+}
+
+// 多线程走面，结果与单线程逐条有向边走完全相同（包括面的顺序和每个面的起点）。
+//
+// 单线程的走面从有向边 h 只会走到 next(h)（cur 环中 prev 的前一个邻居对应的有向边），
+// 标记也只落在这条链上。把 h 与 next(h) 合并得到的连通块互不相交：
+// 一个块里的走面结果只取决于块内起点的处理顺序，与其它块无关。
+// 因此按块分组、块内按原顺序走，各块可以放心交给不同线程，
+// 最后按起点编号把面拼回单线程的顺序。
+// 合并用原子并查集，各块的起点列表按起点编号计数排序得到。
+// 块内每次走面只追加起点和新标记的有向边，而块内每个规范环位置都是块内某个起点的起始位置，
+// 所以块 c 的输出不超过 2 * 起点数。各块按此上限在共用缓冲里预先分好区域，
+// 缓冲大小只取决于输入，与块在线程间怎么分配无关
+template <typename Scalar, typename Index, typename CancelFn>
+static bool trace_faces_parallel(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b, int threads, Index max_face_edges,
+                                 CancelFn cancelRequested) {
+    const Index none = kNone<Index>;
+    const Index num_half = (Index)b.edges.size() * 2;
+
+    // 1. 合并每个规范环位置与它的 next
+    if (b.uf_capacity < (std::size_t)num_half) {
+        b.uf_parent.reset(new std::atomic<Index>[num_half]);
+        b.uf_capacity = num_half;
+    }
+    std::atomic<Index>* parent = b.uf_parent.get();
+    parallel_for(b.pool, threads, num_half, [&](Index begin, Index end) {
+        for (Index i = begin; i < end; ++i) parent[i].store(i, std::memory_order_relaxed);
+    });
+    const Index num_points = (Index)b.points.size();
+    parallel_for(b.pool, threads, num_points, [&](Index begin, Index end) {
+        for (Index v = begin; v < end; ++v) {
+            const Index deg = b.ring_deg[v];
+            const Index base = b.adj_offsets[v];
+            for (Index i = 0; i < deg; ++i) {
+                const Index r = base + i;
+                if (b.ring_canon[r] != r) continue;
+                const Index next_twin = b.ring_twin[base + (i == 0 ? deg - 1 : i - 1)];
+                if (next_twin != none) uf_unite(parent, r, next_twin);
+            }
+        }
+    });
+
+    // 2. 每个起点所在的块（起点无效时为 kNone）
+    auto& start_block = b.start_block;
+    start_block.resize(num_half);
+    parallel_for(b.pool, threads, num_half, [&](Index begin, Index end) {
+        for (Index s = begin; s < end; ++s) {
+            const auto& e = b.edges[s >> 1];
+            const Index start_v = (s & 1) ? e.point1 : e.point2;
+            if (b.ring_deg[start_v] == 0) {
+                start_block[s] = none;
+                continue;
+            }
+            start_block[s] = uf_find(parent, b.ring_canon[b.ring_of_slot[b.slot_twin[b.edge_slot[s]]]]);
+        }
+    });
+    if (cancelRequested()) return false;
+
+    // 3. 计数排序：按块分组，块内保持起点顺序
+    auto& block_offsets = b.block_offsets;
+    auto& block_starts = b.block_starts;
+    block_offsets.assign(num_half + 1, 0);
+    for (Index s = 0; s < num_half; ++s) {
+        if (start_block[s] != none) ++block_offsets[start_block[s] + 1];
+    }
+    auto& blocks = b.blocks;
+    blocks.clear();
+    for (Index c = 0; c < num_half; ++c) {
+        if (block_offsets[c + 1] > 0) blocks.push_back(c);
+        block_offsets[c + 1] += block_offsets[c];
+    }
+    block_starts.resize(block_offsets[num_half]);
+    b.block_fill.assign(block_offsets.begin(), block_offsets.end() - 1);
+    for (Index s = 0; s < num_half; ++s) {
+        if (start_block[s] != none) block_starts[b.block_fill[start_block[s]]++] = s;
+    }
+
+    // 4. 各线程动态领取块，块内逐个起点走面，写入块自己的输出区；
+    //    start_block 复用为 起点 -> 在 block_starts 中的位置（没走出面为 kNone），只在本块内写
+    const Index num_starts = block_offsets[num_half];
+    b.block_indices.resize(2 * (std::size_t)num_starts);
+    b.block_edges.resize(2 * (std::size_t)num_starts);
+    b.start_faces.resize(num_starts);
+    std::atomic<std::size_t> next_block{ 0 };
+    std::atomic<bool> cancelled{ false };
+    const std::size_t num_blocks = blocks.size();
+    constexpr std::size_t kBlocksPerGrab = 256;
+    auto work = [&]() {
+        while (!cancelled.load(std::memory_order_relaxed)) {
+            const std::size_t first = next_block.fetch_add(kBlocksPerGrab, std::memory_order_relaxed);
+            if (first >= num_blocks) break;
+            if (cancelRequested()) {
+                cancelled = true;
+                break;
+            }
+            const std::size_t last = std::min(num_blocks, first + kBlocksPerGrab);
+            for (std::size_t k = first; k < last; ++k) {
+                const Index c = blocks[k];
+                const std::size_t base = 2 * (std::size_t)block_offsets[c];
+                SliceOut<Index> indices{ b.block_indices.data() + base, 0 };
+                SliceOut<Index> edges{ b.block_edges.data() + base, 0 };
+                for (Index i = block_offsets[c]; i < block_offsets[c + 1]; ++i) {
+                    const Index start = block_starts[i];
+                    const std::size_t begin = indices.size();
+                    if (trace_face(b, start, max_face_edges, indices, edges)) {
+                        b.start_faces[i] = { base + begin, base + indices.size() };
+                        start_block[start] = i;
+                    }
+                    else {
+                        start_block[start] = none;
+                    }
+                }
+            }
+        }
+    };
+    parallel_for(b.pool, threads, threads, [&](int begin, int end) {
+        for (int t = begin; t < end; ++t) work();
+    });
+    if (cancelled) return false;
+
+    // 5. 按起点编号拼回单线程的顺序
+    const auto& face_of_start = start_block;
+    std::size_t total_faces = 0, total_indices = 0;
+    for (Index s = 0; s < num_half; ++s) {
+        const Index i = face_of_start[s];
+        if (i == none) continue;
+        ++total_faces;
+        total_indices += b.start_faces[i].end - b.start_faces[i].begin;
+    }
+
+    auto& face_offsets = b.face_offsets;
+    auto& faces = b.face_indices;
+    auto& face_edges = b.face_edges;
+    face_offsets.reserve(total_faces + 1);
+    faces.reserve(total_indices);
+    face_edges.reserve(total_indices);
+    for (Index s = 0; s < num_half; ++s) {
+        const Index i = face_of_start[s];
+        if (i == none) continue;
+        const auto& f = b.start_faces[i];
+        faces.insert(faces.end(), b.block_indices.begin() + f.begin, b.block_indices.begin() + f.end);
+        face_edges.insert(face_edges.end(), b.block_edges.begin() + f.begin, b.block_edges.begin() + f.end);
+        face_offsets.push_back((Index)faces.size());
+    }
+    return true;
+}
+
+// ---------------- 平面输入 ----------------
+
+// 点到拟合平面的最大距离不超过 包围盒对角线 * 此值 时按平面处理
+static constexpr double kPlanarTolerance = 1e-6;
+
+// 共面判断：最小二乘拟合平面 + 容差，分三遍（求和与包围盒、协方差、到平面的距离）
+namespace cgal_tools {
+    MeshingReferenceBuilder::MeshingReferenceBuilder() {
+        for (int i = 0; i < 3; ++i) {
+            m_lo[i] = std::numeric_limits<double>::max();
+            m_hi[i] = -std::numeric_limits<double>::max();
+        }
+    }
+
+    void MeshingReferenceBuilder::add(double x, double y, double z, bool used) {
+        if (m_pass == 0) {
+            m_sum[0] += x; m_sum[1] += y; m_sum[2] += z;
+            ++m_count;
+            if (!used) return;
+            m_usedSum[0] += x; m_usedSum[1] += y; m_usedSum[2] += z;
+            const double c[3] = { x, y, z };
+            for (int i = 0; i < 3; ++i) {
+                m_lo[i] = std::min(m_lo[i], c[i]);
+                m_hi[i] = std::max(m_hi[i], c[i]);
+            }
+            ++m_used;
+        }
+        else if (!used) {
+            return;
+        }
+        else if (m_pass == 1) {
+            // 协方差矩阵（未归一化）
+            const double dx = x - m_ref.origin[0], dy = y - m_ref.origin[1], dz = z - m_ref.origin[2];
+            m_cov[0] += dx * dx; m_cov[1] += dx * dy; m_cov[2] += dx * dz;
+            m_cov[3] += dy * dy; m_cov[4] += dy * dz; m_cov[5] += dz * dz;
+        }
+        else {
+            const double dist = (x - m_ref.origin[0]) * m_ref.normal[0] + (y - m_ref.origin[1]) * m_ref.normal[1]
+                + (z - m_ref.origin[2]) * m_ref.normal[2];
+            if (std::abs(dist) > m_tolerance) m_withinTolerance = false;
+        }
+    }
+
+    bool MeshingReferenceBuilder::next_pass() {
+        if (m_pass == 0) {
+            if (m_count > 0) {
+                for (int i = 0; i < 3; ++i) m_ref.center[i] = m_sum[i] / m_count;
+            }
+            if (m_used < 3) return false;
+            for (int i = 0; i < 3; ++i) m_ref.origin[i] = m_usedSum[i] / m_used;
+            m_pass = 1;
+            return true;
+        }
+        if (m_pass == 1) {
+            const double xx = m_cov[0], xy = m_cov[1], xz = m_cov[2], yy = m_cov[3], yz = m_cov[4], zz = m_cov[5];
+            // 法向取最小特征值对应的方向：选行列式最大的 2x2 子式求解，点严格共面时结果精确
+            const double det_x = yy * zz - yz * yz;
+            const double det_y = xx * zz - xz * xz;
+            const double det_z = xx * yy - xy * xy;
+            const double det_max = std::max(det_x, std::max(det_y, det_z));
+            if (!(det_max > 0.0)) return false; // 全部共线或重合
+            Vector_3 n;
+            if (det_max == det_x) {
+                n = Vector_3(det_x, xz * yz - xy * zz, xy * yz - xz * yy);
+            }
+            else if (det_max == det_y) {
+                n = Vector_3(xz * yz - xy * zz, det_y, xy * xz - yz * xx);
+            }
+            else {
+                n = Vector_3(xy * yz - xz * yy, xy * xz - yz * xx, det_z);
+            }
+            n = n / n.length();
+            m_ref.normal = { n.x, n.y, n.z };
+
+            const double diag = Vector_3(m_hi[0] - m_lo[0], m_hi[1] - m_lo[1], m_hi[2] - m_lo[2]).length();
+            m_tolerance = diag * kPlanarTolerance;
+            m_pass = 2;
+            return true;
+        }
+        if (m_pass == 2) {
+            m_ref.planar = m_withinTolerance;
+            m_pass = 3;
+        }
+        return false;
+    }
+}
+
+// 由本次输入求参考：全部点的中心，以及参与连线的点是否共面
+template <typename Scalar, typename Index>
+static cgal_tools::MeshingReference compute_reference(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b) {
+    const Index num_points = (Index)b.points.size();
+    cgal_tools::MeshingReferenceBuilder builder;
+    do {
+        for (Index v = 0; v < num_points; ++v) {
+            const auto& p = b.points[v];
+            builder.add(p.x(), p.y(), p.z(), b.adj_offsets[v + 1] > b.adj_offsets[v]);
+        }
+    } while (builder.next_pass());
+    return builder.result();
 }
 
-std::map<std::pair<int, int>, int> buildEdgeMap(const std::vector<Edge>& cgal_edges) {
-    std::map<std::pair<int, int>, int> edge_map;
-    for (size_t i = 0; i < cgal_edges.size(); ++i) {
-        int p1 = cgal_edges[i].point1;
-        int p2 = cgal_edges[i].point2;
-        if (p1 > p2) std::swap(p1, p2); // 保证无向查找
-        edge_map[{p1, p2}] = i;
+// 共面时把每个点投影到平面坐标系，结果写入 b.plane_x / b.plane_y，坐标系满足 e1 x e2 = 法向
+template <typename Scalar, typename Index>
+static void project_to_plane(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b, const cgal_tools::MeshingReference& ref) {
+    const Index num_points = (Index)b.points.size();
+    const Vector_3 n(ref.normal[0], ref.normal[1], ref.normal[2]);
+    const double cx = ref.origin[0], cy = ref.origin[1], cz = ref.origin[2];
+
+    // 平面坐标系：e1 取与法向最不平行的坐标轴叉乘得到
+    Vector_3 axis(1.0, 0.0, 0.0);
+    if (std::abs(n.y) < std::abs(n.x) && std::abs(n.y) <= std::abs(n.z)) axis = Vector_3(0.0, 1.0, 0.0);
+    else if (std::abs(n.z) < std::abs(n.x)) axis = Vector_3(0.0, 0.0, 1.0);
+    Vector_3 e1 = vecCross(axis, n);
+    e1 = e1 / e1.length();
+    const Vector_3 e2 = vecCross(n, e1);
+
+    b.plane_x.resize(num_points);
+    b.plane_y.resize(num_points);
+    for (Index v = 0; v < num_points; ++v) {
+        const Vector_3 d(b.points[v].x() - cx, b.points[v].y() - cy, b.points[v].z() - cz);
+        b.plane_x[v] = (Scalar)vecDot(d, e1);
+        b.plane_y[v] = (Scalar)vecDot(d, e2);
     }
-    return edge_map;
 }
 
+// 平面输入时，走面得到的有界面都是逆时针（有向面积为正），每个连通块的外边界是顺时针的，
+// 与里面的面重复，去掉。有向面积要算上弧线的弓形：顶点共线的面（如直径上有中点的半圆）只靠弧线围出面积。
+// given 为调用方给的弧线几何量，为空时用 b.arcs（见 prepare_arc_geometry）
+template <typename Scalar, typename Index>
+static void drop_outer_faces(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b, const cgal_tools::ArcGeometry* given) {
+    const auto& arcs = b.arcs;
+    const auto& n = b.reference.normal;
+    auto& offsets = b.face_offsets;
+    auto& indices = b.face_indices;
+    const std::size_t num_faces = offsets.size() - 1;
+    std::size_t kept = 0;
+    Index write = 0;
+    for (std::size_t f = 0; f < num_faces; ++f) {
+        const Index begin = offsets[f], end = offsets[f + 1];
+        // 鞋带公式（以第一个点为参考，减小大坐标的误差）
+        const double x0 = b.plane_x[indices[begin]], y0 = b.plane_y[indices[begin]];
+        double area2 = 0.0;
+        for (Index i = begin + 1; i + 1 < end; ++i) {
+            const double ax = b.plane_x[indices[i]] - x0, ay = b.plane_y[indices[i]] - y0;
+            const double bx = b.plane_x[indices[i + 1]] - x0, by = b.plane_y[indices[i + 1]] - y0;
+            area2 += ax * by - ay * bx;
+        }
+        // 弧线修正：平面坐标系满足 e1 x e2 = 法向，(P2-P1)x(M-P1) 与法向同向即 M 在 P1->P2 左侧，
+        // 沿 P1->P2 走时弓形在左侧则面积减小，反向走时相反（与 caculate_properties 一致）
+        for (Index i = begin; i < end; ++i) {
+            const Index edge_idx = b.face_edges[i];
+            const auto& e = b.edges[edge_idx];
+            if (!e.is_arc) continue;
+            const Index k = b.arc_slot[edge_idx];
+            const double area_segment = given ? given[k].segment_area : arcs.segment_area[k];
+            if (area_segment == 0.0) continue;
+            double dir = given ? given[k].normal[0] * n[0] + given[k].normal[1] * n[1] + given[k].normal[2] * n[2]
+                               : arcs.nx[k] * n[0] + arcs.ny[k] * n[1] + arcs.nz[k] * n[2];
+            if (indices[i] != e.point1) dir = -dir;
+            area2 += dir > 0 ? -2.0 * area_segment : 2.0 * area_segment;
+        }
+        if (area2 <= 0.0) continue;
+        for (Index i = begin; i < end; ++i) {
+            b.face_edges[write] = b.face_edges[i];
+            indices[write++] = indices[i];
+        }
+        offsets[++kept] = write;
+    }
+    offsets.resize(kept + 1);
+    indices.resize(write);
+    b.face_edges.resize(write);
+}
 
 // 属性计算
 // 计算三角形面积
@@ -153,68 +871,6 @@ static Point_3 computeCentroid(const std::vector<Point_3>& points) {
     return Point_3(sum_x / n, sum_y / n, sum_z / n);
 }
 
-// 计算两向量夹角 (0 到 PI)
-static double getVecAngle(const Vector_3& a, const Vector_3& b) {
-    double n_a = a.length();
-    double n_b = b.length();
-    if (n_a < 1e-12 || n_b < 1e-12) return 0.0;
-
-    double cos_theta = vecDot(a, b) / (n_a * n_b);
-    // 防止浮点误差导致 acos 越界
-    if (cos_theta > 1.0) cos_theta = 1.0;
-    if (cos_theta < -1.0) cos_theta = -1.0;
-
-    return std::acos(cos_theta);
-}
-
-Point_3 getCircleCenter(const Point_3& p1, const Point_3& p2, const Point_3& M) {
-    Vector_3 v1 = p2 - p1;
-    Vector_3 v2 = M - p1;
-
-    // 法向量检查：三点是否共线
-    Vector_3 n = vecCross(v1, v2);
-    double area2 = vecNorm(n);
-    if (area2 < 1e-12) {
-        // 三点几乎共线，无圆心
-        return Point_3(std::numeric_limits<double>::quiet_NaN(),
-            std::numeric_limits<double>::quiet_NaN(),
-            std::numeric_limits<double>::quiet_NaN());
-    }
-
-    // 三边长度
-    double a = vecNorm(p2 - M);
-    double b = vecNorm(p1 - M);
-    double c = vecNorm(p1 - p2);
-
-    double a2 = a * a;
-    double b2 = b * b;
-    double c2 = c * c;
-
-    // 外心 barycentric 系数
-    double alpha = a2 * (b2 + c2 - a2);
-    double beta = b2 * (c2 + a2 - b2);
-    double gamma = c2 * (a2 + b2 - c2);
-
-    double sum = alpha + beta + gamma;
-
-    // 防止除0
-    if (std::abs(sum) < 1e-12) {
-        return Point_3(std::numeric_limits<double>::quiet_NaN(),
-            std::numeric_limits<double>::quiet_NaN(),
-            std::numeric_limits<double>::quiet_NaN());
-    }
-
-    // 得到圆心
-    Point_3 C(
-        (alpha * p1.x() + beta * p2.x() + gamma * M.x()) / sum,
-        (alpha * p1.y() + beta * p2.y() + gamma * M.y()) / sum,
-        (alpha * p1.z() + beta * p2.z() + gamma * M.z()) / sum
-    );
-
-    return C;
-}
- 
-
 // 计算多边形面积(直线)，鞋带公式
 static Vector_3 computePolygonArea3D_line_vector(const std::vector<Point_3>& pts)
 {
@@ -245,27 +901,71 @@ static Vector_3 computePolygonArea3D_line_vector(const std::vector<Point_3>& pts
 }
 
 
-static std::pair<std::vector<std::vector<int>>, std::vector<FaceProperties>>
-caculate_properties(const std::vector<std::vector<int>>& faces,
-    const std::vector<Point_3>& cgal_points,
-    const std::vector<Edge>& cgal_edges) {
 
-	// 建立边查找表
-    auto edge_lookup = buildEdgeMap(cgal_edges);
+// 全部弧线的圆心、圆心角、弓形面积一次批量计算（SIMD，不支持时退回标量），
+// 每条弧只算一次，不再在每个面里逐条重复计算；调用方已经算好时直接使用。
+// 返回调用方给的几何量，没有给或数量不符时返回空，结果在 b.arcs 中；arc_slot 为边 -> 弧线序号
+template <typename Scalar, typename Index>
+static const cgal_tools::ArcGeometry* prepare_arc_geometry(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b) {
+    const auto& cgal_points = b.points;
+    const auto& cgal_edges = b.edges;
+    auto& arcs = b.arcs;
+    b.arc_slot.assign(cgal_edges.size(), kNone<Index>);
+    std::size_t num_arcs = 0;
+    for (const auto& e : cgal_edges) {
+        if (e.is_arc) ++num_arcs;
+    }
+    const cgal_tools::ArcGeometry* given =
+        b.arc_geometry && b.arc_geometry->size() == num_arcs ? b.arc_geometry->data() : nullptr;
+    if (!given) arcs.resize(num_arcs);
+    Index k = 0;
+    for (std::size_t i = 0; i < cgal_edges.size(); ++i) {
+        const auto& e = cgal_edges[i];
+        if (!e.is_arc) continue;
+        b.arc_slot[i] = k;
+        if (!given) {
+            const auto& p1 = cgal_points[e.point1];
+            const auto& p2 = cgal_points[e.point2];
+            arcs.p1x[k] = p1.x(); arcs.p1y[k] = p1.y(); arcs.p1z[k] = p1.z();
+            arcs.p2x[k] = p2.x(); arcs.p2y[k] = p2.y(); arcs.p2z[k] = p2.z();
+            // 注意：Edge 结构中 arc_center 实际上存的是弧上一点 M
+            arcs.mx[k] = e.arc_center.x(); arcs.my[k] = e.arc_center.y(); arcs.mz[k] = e.arc_center.z();
+        }
+        ++k;
+    }
+    if (!given) arc_kernels::compute(arcs);
+    return given;
+}
+
+// 面积、中心一律按 double 计算，与输入的坐标类型无关。given 为 prepare_arc_geometry 的返回值
+template <typename Scalar, typename Index>
+static void caculate_properties(cgal_tools::detail::MeshingBuffers<Scalar, Index>& b, const cgal_tools::ArcGeometry* given) {
+    const auto& cgal_points = b.points;
+    const auto& cgal_edges = b.edges;
+    const auto& arcs = b.arcs;
+
     // 创建面属性数组（目前是计算面积和中心点）
-    std::vector<FaceProperties> face_props;
-    for (const auto& face_indices : faces) {
-        if (face_indices.size() < 3) {
+    auto& face_props = b.face_props;
+    auto& face_points = b.face_points;
+    face_props.clear();
+    const std::size_t num_faces = b.face_offsets.size() - 1;
+    for (std::size_t f = 0; f < num_faces; ++f) {
+        const Index* face_indices = b.face_indices.data() + b.face_offsets[f];
+        const Index* face_edges = b.face_edges.data() + b.face_offsets[f];
+        Index n_pts = b.face_offsets[f + 1] - b.face_offsets[f];
+        if (n_pts < 3) {
             // 无效面默认属性
             face_props.push_back({ 0.0, 0.0, 0.0, 0.0 });
             continue;
         }
 
         // 将索引转换为实际坐标点
-        std::vector<Point_3> face_points;
-        for (int idx : face_indices) {
-            if (idx >= 0 && idx < cgal_points.size()) {
-                face_points.push_back(cgal_points[idx]);
+        face_points.clear();
+        for (Index i = 0; i < n_pts; ++i) {
+            Index idx = face_indices[i];
+            if (static_cast<std::size_t>(idx) < cgal_points.size()) { // int 索引为负时转换后同样越界
+                const auto& p = cgal_points[idx];
+                face_points.push_back(Point_3(p.x(), p.y(), p.z()));
             }
         }
 
@@ -288,92 +988,47 @@ caculate_properties(const std::vector<std::vector<int>>& faces,
 
         // --- 步骤 2: 计算弧线修正面积 ---
         double area_correction = 0.0;
-        int n_pts = face_indices.size();
-
-        for (int i = 0; i < n_pts; ++i) {
-            int idx1 = face_indices[i];
-            int idx2 = face_indices[(i + 1) % n_pts]; // 下一点，形成闭环
-
-            // 在 lookup 中查找边 (无向)
-            int p1_key = idx1;
-            int p2_key = idx2;
-            if (p1_key > p2_key) std::swap(p1_key, p2_key);
-
-            auto it = edge_lookup.find({ p1_key, p2_key });
-            if (it != edge_lookup.end()) {
-                const Edge& e = cgal_edges[it->second];
-
-                // 如果是弧线
-                if (e.is_arc) {
-                    Point_3 P1 = cgal_points[idx1];
-                    Point_3 P2 = cgal_points[idx2];
-                    // 注意：Edge 结构中 arc_center 实际上存的是弧上一点 M
-                    Point_3 M = e.arc_center;
-
-                    // A. 计算圆心
-                    Point_3 C = getCircleCenter(P1, P2, M);
-
-                    // 检查圆心是否有效 (NaN check)
-                    if (std::isnan(C.x())) {
-                        continue; // 三点共线或无效，当做直线处理，无修正
-                    }
 
-                    // B. 计算半径
-                    double R = (P1 - C).length();
-
-                    // C. 计算圆心角 (Total Angle)
-                    // 必须分为 P1->M 和 M->P2 两段计算，以正确处理 > 180 度的优弧
-                    Vector_3 v_C_P1 = P1 - C;
-                    Vector_3 v_C_M = M - C;
-                    Vector_3 v_C_P2 = P2 - C;
-
-                    double angle1 = getVecAngle(v_C_P1, v_C_M);
-                    double angle2 = getVecAngle(v_C_M, v_C_P2);
-                    double total_angle = angle1 + angle2;
-
-                    // D. 计算弓形面积 (Area Segment)
-                    // 扇形面积
-                    double area_sector = 0.5 * R * R * total_angle;
-
-                    // 三角形(C, P1, P2) 面积
-                    // 使用叉乘模长计算，结果恒为正
-                    double area_tri_cp1p2 = 0.5 * vecCross(v_C_P1, v_C_P2).length();
-
-                    // 几何修正：
-                    // 如果角度 < 180 (M_PI)，弓形面积 = 扇形 - 三角形
-                    // 如果角度 > 180 (M_PI)，弓形面积 = 扇形 + 三角形 (因为三角形面积计算结果是正的，但此时弦将圆切成了两部分，优弧部分包含了圆心)
-                    double area_segment = 0.0;
-                    if (total_angle > PI) {
-                        area_segment = area_sector + area_tri_cp1p2;
-                    }
-                    else {
-                        area_segment = area_sector - area_tri_cp1p2;
-                    }
+        for (Index i = 0; i < n_pts; ++i) {
+            // 走面时已记下 idx1 -> 下一点 经过的边，直接取用
+            Index idx1 = face_indices[i];
+            Index edge_idx = face_edges[i];
+            const auto& e = cgal_edges[edge_idx];
 
-                    // E. 判断正负号 (加还是减)
-                    // 依据：弧线是向内凹(减) 还是 向外凸(加)
-                    // 方法：计算 (P2-P1) x (M-P1) 与 面法向 的点乘
-                    // P1->P2 是当前多边形的边方向
-                    Vector_3 v_chord = P2 - P1;
-                    Vector_3 v_mid_vec = M - P1;
-                    Vector_3 cross_check = vecCross(v_chord, v_mid_vec);
-
-                    double dir = vecDot(cross_check, face_normal);
-
-                    // 逻辑：
-                    // 标准逆时针(CCW)多边形，法向朝上。
-                    // 向量叉积 (P2-P1)x(M-P1) 服从右手定则。
-                    // 如果 M 在 P1->P2 左侧（多边形内部），叉积向上，Dot > 0。
-                    // -> 弧线内凹 -> 面积减小。
-                    // 如果 M 在 P1->P2 右侧（多边形外部），叉积向下，Dot < 0。
-                    // -> 弧线外凸 -> 面积增加。
-
-                    if (dir > 0) {
-                        area_correction -= area_segment;
-                    }
-                    else {
-                        area_correction += area_segment;
-                    }
+            // 如果是弧线（几何量已在前面批量算好）
+            if (e.is_arc) {
+                const Index k = b.arc_slot[edge_idx];
+
+                // 三点共线或无效时弓形面积为 0，当做直线处理，无修正
+                double area_segment = given ? given[k].segment_area : arcs.segment_area[k];
+                if (area_segment == 0.0) {
+                    continue;
+                }
+
+                // 判断正负号 (加还是减)
+                // 依据：弧线是向内凹(减) 还是 向外凸(加)
+                // 方法：计算 (P2-P1) x (M-P1) 与 面法向 的点乘，P1->P2 是当前多边形的边方向。
+                // 批量计算时按边的 point1->point2 方向，面沿反方向经过这条边时叉积取反
+                double dir = given ? given[k].normal[0] * face_normal.x + given[k].normal[1] * face_normal.y
+                                         + given[k].normal[2] * face_normal.z
+                                   : arcs.nx[k] * face_normal.x + arcs.ny[k] * face_normal.y + arcs.nz[k] * face_normal.z;
+                if (idx1 != e.point1) {
+                    dir = -dir;
+                }
+
+                // 逻辑：
+                // 标准逆时针(CCW)多边形，法向朝上。
+                // 向量叉积 (P2-P1)x(M-P1) 服从右手定则。
+                // 如果 M 在 P1->P2 左侧（多边形内部），叉积向上，Dot > 0。
+                // -> 弧线内凹 -> 面积减小。
+                // 如果 M 在 P1->P2 右侧（多边形外部），叉积向下，Dot < 0。
+                // -> 弧线外凸 -> 面积增加。
+
+                if (dir > 0) {
+                    area_correction -= area_segment;
+                }
+                else {
+                    area_correction += area_segment;
                 }
             }
         }
@@ -390,284 +1045,338 @@ caculate_properties(const std::vector<std::vector<int>>& faces,
 
         face_props.push_back({ total_area, centroid.x(), centroid.y(), centroid.z() });
     }
-
-    return std::make_pair(faces, face_props);
 }
 
 
 namespace cgal_tools {
-    std::pair<std::vector<std::vector<int>>, std::vector<FaceProperties>> 
+    void compute_arc_geometry(const std::vector<ArcPoints>& arcs, std::vector<ArcGeometry>& out) {
+        arc_kernels::ArcSoA soa;
+        soa.resize(arcs.size());
+        for (std::size_t i = 0; i < arcs.size(); ++i) {
+            const ArcPoints& a = arcs[i];
+            soa.p1x[i] = a.p1[0]; soa.p1y[i] = a.p1[1]; soa.p1z[i] = a.p1[2];
+            soa.p2x[i] = a.p2[0]; soa.p2y[i] = a.p2[1]; soa.p2z[i] = a.p2[2];
+            soa.mx[i] = a.m[0]; soa.my[i] = a.m[1]; soa.mz[i] = a.m[2];
+        }
+        arc_kernels::compute(soa);
+        out.resize(arcs.size());
+        for (std::size_t i = 0; i < arcs.size(); ++i) {
+            ArcGeometry& g = out[i];
+            g.center = {soa.cx[i], soa.cy[i], soa.cz[i]};
+            g.normal = {soa.nx[i], soa.ny[i], soa.nz[i]};
+            g.radius = soa.radius[i];
+            g.sweep = soa.sweep[i];
+            g.segment_area = soa.segment_area[i];
+        }
+    }
+
+    std::pair<std::vector<std::vector<int>>, std::vector<FaceProperties>>
         reconstruct_meshes(const std::vector<std::array<double, 3>>& points,
-            const std::vector<std::array<int, 3>>& edges, 
+            const std::vector<std::array<int, 3>>& edges,
             const std::vector<std::array<double, 3>>& edges_info) {
 
-		int num_points = points.size();
-		int num_edges = edges.size();
-		std::vector<Edge>     cagl_edges;
-		std::vector<Point_3>  cgal_points;
+        MeshingWorkspace workspace;
+        reconstruct_meshes(points, edges, edges_info, workspace);
+
+        // 把 CSR 结果展开成 faces[num_faces, n]
+        const auto& offsets = workspace.face_offsets();
+        const auto& indices = workspace.face_indices();
+        std::vector<std::vector<int>> faces(workspace.face_count());
+        for (size_t f = 0; f < faces.size(); ++f) {
+            faces[f].assign(indices.begin() + offsets[f], indices.begin() + offsets[f + 1]);
+        }
+        return std::make_pair(std::move(faces), workspace.face_properties());
+    }
+
+    void reconstruct_meshes(const std::vector<std::array<double, 3>>& points,
+        const std::vector<std::array<int, 3>>& edges,
+        const std::vector<std::array<double, 3>>& edges_info,
+        MeshingWorkspace& workspace) {
+        reconstruct_meshes<double, int>(points, edges, edges_info, workspace);
+    }
+
+    template <typename Scalar, typename Index>
+    void reconstruct_meshes(const std::vector<std::array<Scalar, 3>>& points,
+        const std::vector<std::array<Index, 3>>& edges,
+        const std::vector<std::array<Scalar, 3>>& edges_info,
+        BasicMeshingWorkspace<Scalar, Index>& workspace) {
+
+        using Buffers = typename BasicMeshingWorkspace<Scalar, Index>::Buffers;
+        using Point = typename Buffers::Point;
+        using Edge = typename Buffers::Edge;
+        constexpr Index none = kNone<Index>;
+        Buffers& b = *workspace.m_buf;
+
+        // 有向边（2 * 边数）与点都要能用 Index 编号，kNone 保留
+        if (points.size() >= (std::size_t)none || edges.size() >= (std::size_t)none / 2) {
+            throw std::length_error("reconstruct_meshes: 点数或边数超出索引类型的范围，请使用更宽的 Index");
+        }
+
+        // 取消检查：每处理一批点/边看一次标记，取消时清空结果直接返回
+        constexpr int kCancelCheckMask = 4095;
+        workspace.m_cancelled = false;
+        auto cancelRequested = [&]() {
+            return workspace.m_cancel && workspace.m_cancel->load(std::memory_order_relaxed);
+        };
+        auto abandon = [&]() {
+            b.face_offsets.assign(1, 0);
+            b.face_indices.clear();
+            b.face_edges.clear();
+            b.face_props.clear();
+            workspace.m_cancelled = true;
+        };
+
+		const Index num_points = (Index)points.size();
+		const Index num_edges = (Index)edges.size();
+		auto& cagl_edges = b.edges;
+		auto& cgal_points = b.points;
+		cagl_edges.clear();
+		cgal_points.clear();
 
 		// 转化为CGAL point3
 		for (const auto& point : points) {
-			cgal_points.emplace_back(Point_3(point[0], point[1], point[2]));
+			cgal_points.emplace_back(Point(point[0], point[1], point[2]));
 		}
 		// 获取边
-        for (int i = 0; i < num_edges; i++) {
+        for (Index i = 0; i < num_edges; i++) {
 			cagl_edges.emplace_back(Edge{
-                edges[i][0], edges[i][1], edges[i][2], // 
-                Point_3(edges_info[i][0], edges_info[i][1], edges_info[i][2]),
+                edges[i][0], edges[i][1], (int)edges[i][2], //
+                Point(edges_info[i][0], edges_info[i][1], edges_info[i][2]),
                 });
 		}
-		// 建立每个点的邻接表
-		std::vector<std::vector<int>> adj(num_points);
-		for (auto& e : cagl_edges) {
-			adj[e.point1].push_back(e.point2);
-			adj[e.point2].push_back(e.point1); // 无向
-		}
+		// 建立每个点的邻接表 (CSR)，邻居顺序与边的输入顺序一致
+        auto& adj_offsets = b.adj_offsets;
+        auto& adj = b.adj;
+        adj_offsets.assign(num_points + 1, 0);
+        for (const auto& e : cagl_edges) {
+            ++adj_offsets[e.point1 + 1];
+            ++adj_offsets[e.point2 + 1];
+        }
+        for (Index v = 0; v < num_points; ++v) {
+            adj_offsets[v + 1] += adj_offsets[v];
+        }
+        b.adj_fill.assign(adj_offsets.begin(), adj_offsets.end() - 1);
+        adj.resize(num_edges * 2);
+        b.slot_twin.resize(num_edges * 2);
+        b.edge_slot.resize(num_edges * 2);
+        for (Index ei = 0; ei < num_edges; ++ei) {
+            const auto& e = cagl_edges[ei];
+            Index s_uv = b.adj_fill[e.point1]++;
+            adj[s_uv] = e.point2;
+            Index s_vu = b.adj_fill[e.point2]++;
+            adj[s_vu] = e.point1; // 无向
+            b.slot_twin[s_uv] = s_vu;
+            b.slot_twin[s_vu] = s_uv;
+            b.edge_slot[2 * ei] = s_uv;
+            b.edge_slot[2 * ei + 1] = s_vu;
+        }
         // std::cout << "111" << std::endl;
-		// 计算模型中心，以确定后续各点法向量
-        Point_3 center = computeCentroid(cgal_points);
-		/*Point_3 center(0.0, 0.0, 0.0);
-		for (int i = 0; i < num_points; ++i) {
-			center = Point_3(
-				center.x() + cgal_points[i].x(),
-				center.y() + cgal_points[i].y(),
-				center.z() + cgal_points[i].z()
-			);
-		}
-		center = Point_3(
-			center.x() / num_points,
-			center.y() / num_points,
-			center.z() / num_points
-		);*/
+        // 排序环的参考：调用方给定时直接使用（分块重建时为整个模型的参考），否则由本次输入求出。
+        // 共面的输入（大多数二维线框）所有点共用一个法向，在同一个平面坐标系里排序：
+        // 环的方向处处一致，也省去每个点建立局部坐标系
+        b.reference = workspace.m_reference ? *workspace.m_reference : compute_reference(b);
+        b.arc_geometry = workspace.m_arcGeometry;
+        b.planar = b.reference.planar;
+        if (b.planar) {
+            project_to_plane(b, b.reference);
+        }
 
-        // 遍历每个点，为其相邻点按 从内到外的法向 逆时针排序
-        std::vector<std::vector<int>> sorted_ring(num_points);
+		// 模型中心，以确定后续各点法向量
+        Point_3 center(b.reference.center[0], b.reference.center[1], b.reference.center[2]);
 
-        for (int v = 0; v < num_points; ++v) {
-            const auto& neis = adj[v];
-            int deg = static_cast<int>(neis.size());
+        // 遍历每个点，为其相邻点按 从内到外的法向 逆时针排序
+        auto& sorted_ring = b.ring;
+        sorted_ring.resize(num_edges * 2);
+        b.ring_deg.assign(num_points, 0);
+        b.ring_of_slot.assign(num_edges * 2, none);
+
+        for (Index v = 0; v < num_points; ++v) {
+            if ((v & kCancelCheckMask) == 0 && cancelRequested()) {
+                abandon();
+                return;
+            }
+            const Index* neis = adj.data() + adj_offsets[v];
+            Index deg = adj_offsets[v + 1] - adj_offsets[v];
             if (deg == 0) continue;      // 孤立点，忽略
             if (deg == 1) {              // 只有一条边，可忽略
-                // sorted_ring[v] = neis; 
+                // sorted_ring[v] = neis;
                 continue;
             }
-            // 设置模型中心为参考 计算该点向量
-            Vector_3 n_v = cgal_points[v] - center;
-            if (n_v.squared_length() < EPS) {
-                // 退化：顶点刚好等于中心，给个默认方向
-                n_v = Vector_3(0.0, 0.0, 1.0);
-            }
-            n_v = n_v / std::sqrt(n_v.squared_length());
-
-            // 在 n_v 垂直平面上建立局部坐标系 (e1, e2)
-            // 先选一条邻接边方向做初始切向方向
-            Vector_3 e1 = cgal_points[neis[0]] - cgal_points[v];
-            // 投影到切平面
-            double proj = vecDot(e1, n_v);
-            // std::cout << "dot" << proj << std::endl;
-            e1 = e1 - proj * n_v;
-            if (e1.squared_length() < EPS && deg >= 2) {
-                e1 = cgal_points[neis[1]] - cgal_points[v];
-                proj = vecDot(e1, n_v);
-                e1 = e1 - proj * n_v;
+            auto& tmp = b.dirs;
+            tmp.clear();
+
+            if (b.planar) {
+                for (Index k = 0; k < deg; ++k) {
+                    Index u = neis[k];
+                    double x = (double)b.plane_x[u] - b.plane_x[v];
+                    double y = (double)b.plane_y[u] - b.plane_y[v];
+                    tmp.push_back({ u, adj_offsets[v] + k, dir_half(x, y), x, y });
+                }
             }
-            if (e1.squared_length() < EPS) {
-                // 再退一步给个固定方向并投影
-                e1 = Vector_3(1.0, 0.0, 0.0);
-                proj = vecDot(e1, n_v);
+            else {
+                // 设置模型中心为参考 计算该点向量
+                Vector_3 n_v = cgal_points[v] - center;
+                if (n_v.squared_length() < EPS) {
+                    // 退化：顶点刚好等于中心，给个默认方向
+                    n_v = Vector_3(0.0, 0.0, 1.0);
+                }
+                n_v = n_v / std::sqrt(n_v.squared_length());
+
+                // 在 n_v 垂直平面上建立局部坐标系 (e1, e2)
+                // 先选一条邻接边方向做初始切向方向
+                Vector_3 e1 = cgal_points[neis[0]] - cgal_points[v];
+                // 投影到切平面
+                double proj = vecDot(e1, n_v);
+                // std::cout << "dot" << proj << std::endl;
                 e1 = e1 - proj * n_v;
+                if (e1.squared_length() < EPS && deg >= 2) {
+                    e1 = cgal_points[neis[1]] - cgal_points[v];
+                    proj = vecDot(e1, n_v);
+                    e1 = e1 - proj * n_v;
+                }
+                if (e1.squared_length() < EPS) {
+                    // 再退一步给个固定方向并投影
+                    e1 = Vector_3(1.0, 0.0, 0.0);
+                    proj = vecDot(e1, n_v);
+                    e1 = e1 - proj * n_v;
+                }
+                e1 = e1 / std::sqrt(e1.squared_length());
+                Vector_3 e2 = vecCross(n_v, e1);
+                e2 = e2 / std::sqrt(e2.squared_length());
+
+                // 计算每个邻居的方向（在以 n_v 为法向的切平面中）
+                for (Index k = 0; k < deg; ++k) {
+                    Index u = neis[k];
+                    Vector_3 d = cgal_points[u] - cgal_points[v];
+                    // 投影到切平面
+                    double proj_n = vecDot(d, n_v);
+                    Vector_3 d_tan = d - proj_n * n_v;
+                    double x = vecDot(d_tan, e1);
+                    double y = vecDot(d_tan, e2);
+
+                    tmp.push_back({ u, adj_offsets[v] + k, dir_half(x, y), x, y });
+                }
             }
-            e1 = e1 / std::sqrt(e1.squared_length());
-            Vector_3 e2 = vecCross(n_v, e1);
-            e2 = e2 / std::sqrt(e2.squared_length());
-
-            // 计算每个邻居的极角（在以 n_v 为法向的切平面中）
-            struct NeighborAngle {
-                int idx;
-                double angle;
-            };
-            std::vector<NeighborAngle> tmp;
-            tmp.reserve(deg);
-
-            for (int u : neis) {
-                Vector_3 d = cgal_points[u] - cgal_points[v];
-                // 投影到切平面
-                double proj_n = vecDot(d, n_v);
-                Vector_3 d_tan = d - proj_n * n_v;
-                double x = vecDot(d_tan, e1);
-                double y = vecDot(d_tan, e2);
-                double angle = std::atan2(y, x);
 
-                tmp.push_back({ u, angle });
-            }
+            // 按极角逆时针排序
+            sort_dirs(tmp.data(), (int)deg);
 
-            std::sort(tmp.begin(), tmp.end(),
-                [](const NeighborAngle& a, const NeighborAngle& b) {
-                    return a.angle < b.angle;
-                });
-
-            sorted_ring[v].resize(deg);
-            for (int i = 0; i < deg; ++i) {
-                sorted_ring[v][i] = tmp[i].idx;
+            b.ring_deg[v] = deg;
+            for (Index i = 0; i < deg; ++i) {
+                sorted_ring[adj_offsets[v] + i] = tmp[i].idx;
+                b.ring_of_slot[tmp[i].slot] = adj_offsets[v] + i;
             }
         }
 
-       for (int idx = 0; idx < num_points; ++idx) {
-            std::cout << "\n点" << idx << "的排序环: ";
-            for (int nb : sorted_ring[idx]) {
-                std::cout << nb << " ";
+       //for (int idx = 0; idx < num_points; ++idx) {
+       //     std::cout << "\n点" << idx << "的排序环: ";
+       //     for (int nb : sorted_ring[idx]) {
+       //         std::cout << nb << " ";
+       //     }
+       // }
+       // std::cout << std::endl;
+
+        // 记录在每个顶点 v 上，每个邻居 u 在环中的位置。
+        // 重复边会让同一个邻居出现多次，统一取最后一次出现的位置
+        auto& ring_canon = b.ring_canon;
+        ring_canon.resize(num_edges * 2);
+        for (Index v = 0; v < num_points; ++v) {
+            Index deg = b.ring_deg[v];
+            if (deg == 0) continue;
+            Index base = adj_offsets[v];
+            auto& scratch = b.canon_scratch;
+            scratch.clear();
+            for (Index i = 0; i < deg; ++i) {
+                scratch.push_back({ sorted_ring[base + i], base + i });
+            }
+            std::sort(scratch.begin(), scratch.end());
+            for (Index i = deg; i-- > 0;) {
+                Index last = (i + 1 < deg && scratch[i + 1].first == scratch[i].first)
+                    ? ring_canon[scratch[i + 1].second] : scratch[i].second;
+                ring_canon[scratch[i].second] = last;
             }
         }
-        std::cout << std::endl;
-
-        // 构造半边
-        int num_halfedges = num_edges * 2;
-        std::vector<int> he_tail(num_halfedges);
-        std::vector<int> he_head(num_halfedges);
-        std::vector<int> he_twin(num_halfedges);
-        // (u,v) -> 半边 id
-        std::map<std::pair<int, int>, int> halfedge_id;
-
-        for (int ei = 0; ei < num_edges; ++ei) {
-            int u = cagl_edges[ei].point1;
-            int v = cagl_edges[ei].point2;
-
-            int h_uv = 2 * ei;      // 有向边 u->v
-            int h_vu = 2 * ei + 1;  // 有向边 v->u
-
-            he_tail[h_uv] = u;
-            he_head[h_uv] = v;
-            he_tail[h_vu] = v;
-            he_head[h_vu] = u;
-
-            he_twin[h_uv] = h_vu;
-            he_twin[h_vu] = h_uv;
-
-            halfedge_id[{u, v}] = h_uv;
-            halfedge_id[{v, u}] = h_vu;
+        // 环位置 v->u 对应的反向位置：u 的环中 v 的规范位置
+        auto& ring_twin = b.ring_twin;
+        ring_twin.assign(num_edges * 2, none);
+        for (Index s = 0; s < num_edges * 2; ++s) {
+            Index r = b.ring_of_slot[s];
+            if (r == none) continue;
+            Index t = b.ring_of_slot[b.slot_twin[s]];
+            if (t != none) ring_twin[r] = ring_canon[t];
         }
-
-        // 把 sorted_ring[v] 转为“按顺序的出半边”
-        std::vector<std::vector<int>> out_halfedges(num_points);
-        for (int v = 0; v < num_points; ++v) {
-            for (int u : sorted_ring[v]) {
-                int h = halfedge_id[{v, u}];     // v->u 这条半边
-                out_halfedges[v].push_back(h);   // 以 v 为 tail 的半边，按环顺序
-            }
+        // 环位置 -> 边索引。走面只经过规范位置，重复边因此取最后一条
+        auto& ring_edge = b.ring_edge;
+        ring_edge.resize(num_edges * 2);
+        for (Index s = 0; s < num_edges * 2; ++s) {
+            Index r = b.ring_of_slot[b.edge_slot[s]];
+            if (r != none) ring_edge[r] = s >> 1;
         }
 
-
-        // 记录在每个顶点 v 上，每个邻居 u 在 sorted_ring[v] 中的位置
-        std::vector<std::map<int, int>> pos_in_ring(num_points);
-        for (int v = 0; v < num_points; ++v) {
-            const auto& ring = sorted_ring[v];
-            for (int i = 0; i < (int)ring.size(); ++i) {
-                int u = ring[i];
-                pos_in_ring[v][u] = i;
-            }
-        }
-        // 记录每条有向边是否已被用于某个面： (u,v) -> visited
-        std::map<std::pair<int, int>, bool> visited_directed_edges;
+        // 记录每条有向边是否已被用于某个面，以 cur 环中 prev 的规范位置为键
+        // （cur 无环时这条有向边走到 cur 必然失败，无需记录）
+        auto& visited_directed_edges = b.visited;
+        visited_directed_edges.assign(num_edges * 2, 0);
 
         // 存所有找到的面
-        std::vector<std::vector<int>> faces;
+        auto& face_offsets = b.face_offsets;
+        auto& faces = b.face_indices;
+        auto& face_edges = b.face_edges;
+        face_offsets.assign(1, 0);
+        faces.clear();
+        face_edges.clear();
 
         // 设置最大面边数
-        int max_face_edges = num_edges * 2;
-
-        // 遍历每条有向边 u->v 和 v->u都要走一次
-        for (const auto& e : cagl_edges) {
-            int a = e.point1;
-            int b = e.point2;
-
-            int dirs[2][2] = { {a, b}, {b, a} };
-
-            for (int di = 0; di < 2; ++di) {
-                int start_u = dirs[di][0];
-                int start_v = dirs[di][1];
-
-                // 如果这条有向边已经属于某个面了，就跳过
-                if (visited_directed_edges[{start_u, start_v}]) {
-                    continue;
-                }
+        Index max_face_edges = num_edges * 2;
 
-                // 点没有邻接环（孤立或度数过小），跳过
-                if (sorted_ring[start_v].empty()) {
-                    continue;
+        int threads = workspace.m_threads > 0 ? workspace.m_threads : (int)std::thread::hardware_concurrency();
+        if (threads > 1 && (std::size_t)num_edges >= kParallelMinEdges) {
+            if (!trace_faces_parallel(b, threads, max_face_edges, cancelRequested)) {
+                abandon();
+                return;
+            }
+        }
+        else {
+            // 遍历每条有向边 u->v 和 v->u都要走一次
+            for (Index ei = 0; ei < num_edges; ++ei) {
+                if ((ei & kCancelCheckMask) == 0 && cancelRequested()) {
+                    abandon();
+                    return;
                 }
-
-                std::vector<int> face;
-                face.reserve(16);
-
-                int prev = start_u;
-                int cur = start_v;
-
-                face.push_back(start_u);
-                bool closed = false;
-                bool failed = false;
-
-                while (true) {
-                    // 加入当前点
-                    face.push_back(cur);
-
-                    // 标记当前有向边 prev->cur 已被使用
-                    visited_directed_edges[{prev, cur}] = true;
-
-                    // 在 cur 的环里找到 prev 所在的位置
-                    auto it_pos = pos_in_ring[cur].find(prev);
-                    if (it_pos == pos_in_ring[cur].end()) {
-                        failed = true;
-                        break;
+                for (Index di = 0; di < 2; ++di) {
+                    if (trace_face(b, 2 * ei + di, max_face_edges, faces, face_edges)) {
+                        face_offsets.push_back((Index)faces.size());
                     }
-
-                    const auto& ring = sorted_ring[cur];
-                    int deg = (int)ring.size();
-                    int idx = it_pos->second;
-
-                    // 一直逆时针walk：取 prev 在环中的前一个邻居
-                    int next_idx = (idx - 1 + deg) % deg;
-                    int next = ring[next_idx];
-
-                    // 如果下一条边的终点回到起始点 start_u，则闭合
-                    if (next == start_u) {
-                        // 最后这条边 cur->start_u 也属于这个面，标记已访问
-                        visited_directed_edges[{cur, start_u}] = true;
-                        closed = true;
-                        break;
-                    }
-
-                    // 如果下一条有向边已经被用在别的面里了，这条 walk 放弃
-                    if (visited_directed_edges[{cur, next}]) {
-                        failed = true;
-                        break;
-                    }
-                    // 超过限定的边数
-                    if ((int)face.size() > max_face_edges) {
-                        failed = true;
-                        break;
-                    }
-
-                    prev = cur;
-                    cur = next;
-                }
-
-                if (closed && !failed && (int)face.size() >= 3) {
-                    faces.push_back(face);
                 }
             }
         }
+        const cgal_tools::ArcGeometry* arc_geometry = prepare_arc_geometry(b);
+        if (b.planar) {
+            drop_outer_faces(b, arc_geometry);
+        }
         //std::cout << "\n找到的面数量: " << faces.size() << "\n";
-        //for (int i = 0; i < (int)faces.size(); ++i) {
-        //    const auto& f = faces[i];
-        //    std::cout << "面-" << i << " (" << f.size() << "个顶点): ";
-        //    for (int v : f) {
-        //        std::cout << v << " ";
-        //    }
-        //    std::cout << "\n";
-        //}
         // faces [n_meshes, n] n是点索引
         // 计算面积和中心点坐标并返回
-       
-        return caculate_properties(faces, cgal_points, cagl_edges);
+        if (cancelRequested()) {
+            abandon();
+            return;
+        }
+        caculate_properties(b, arc_geometry);
+
+        if (b.bytes() > workspace.m_highWater) workspace.m_highWater = b.bytes();
 	}
+
+    // 显式实例化：double + int 供旧接口使用，其余为 float / double 与 32 / 64 位无符号索引的组合
+#define CGAL_TOOLS_INSTANTIATE(Scalar, Index)                                                 \
+    template class BasicMeshingWorkspace<Scalar, Index>;                                     \
+    template void reconstruct_meshes<Scalar, Index>(const std::vector<std::array<Scalar, 3>>&, \
+        const std::vector<std::array<Index, 3>>&, const std::vector<std::array<Scalar, 3>>&,   \
+        BasicMeshingWorkspace<Scalar, Index>&);
+
+    CGAL_TOOLS_INSTANTIATE(double, int)
+    CGAL_TOOLS_INSTANTIATE(float, std::uint32_t)
+    CGAL_TOOLS_INSTANTIATE(double, std::uint32_t)
+    CGAL_TOOLS_INSTANTIATE(float, std::uint64_t)
+    CGAL_TOOLS_INSTANTIATE(double, std::uint64_t)
+#undef CGAL_TOOLS_INSTANTIATE
 }
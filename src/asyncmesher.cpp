@@ -0,0 +1,100 @@
+#include "asyncmesher.h"
+#include <QThread>
+#include <QElapsedTimer>
+#include <atomic>
+
+// 一次生成面任务。工作线程只读写这里的成员，线程结束后界面线程再读取结果
+struct AsyncMesher::Job {
+    MeshingInput input;
+    quint64 revision = 0;
+    std::atomic<bool> cancelled{false};
+    std::vector<Face> faces;
+    bool ok = false;
+    double seconds = 0.0;
+};
+
+AsyncMesher::AsyncMesher(QObject *parent)
+    : QObject(parent)
+{
+}
+
+AsyncMesher::~AsyncMesher()
+{
+    m_pending.reset();
+    if (m_thread) {
+        m_thread->disconnect(this);
+        m_running->cancelled = true;
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+void AsyncMesher::request(const MeshData& data)
+{
+    // 快照在界面线程里做，工作线程不会再碰 MeshData
+    auto job = std::make_unique<Job>();
+    data.fillMeshingInput(job->input);
+    job->revision = data.revision();
+
+    if (m_thread) {
+        // 旧请求作废：打断正在算的，排队的直接替换
+        m_running->cancelled = true;
+        m_pending = std::move(job);
+        return;
+    }
+    start(std::move(job));
+}
+
+void AsyncMesher::cancel()
+{
+    m_pending.reset();
+    if (m_running) m_running->cancelled = true;
+}
+
+std::vector<Face> AsyncMesher::takeFaces()
+{
+    std::vector<Face> faces;
+    faces.swap(m_result);
+    return faces;
+}
+
+void AsyncMesher::start(std::unique_ptr<Job> job)
+{
+    m_running = std::move(job);
+    Job* j = m_running.get();
+    m_workspace.set_cancel_flag(&j->cancelled);
+
+    m_thread = QThread::create([this, j]() {
+        QElapsedTimer timer;
+        timer.start();
+        j->ok = MeshData::computeFaces(j->input, m_workspace, j->faces);
+        j->seconds = timer.nsecsElapsed() / 1e9;
+    });
+    connect(m_thread, &QThread::finished, this, &AsyncMesher::onThreadFinished);
+    m_thread->start();
+
+    emit meshingStarted();
+}
+
+void AsyncMesher::onThreadFinished()
+{
+    std::unique_ptr<Job> job = std::move(m_running);
+    m_thread->deleteLater();
+    m_thread = nullptr;
+    m_workspace.set_cancel_flag(nullptr);
+
+    // 有更新的请求在排队：这次的结果不要了，直接开始新的
+    if (m_pending) {
+        start(std::move(m_pending));
+        return;
+    }
+
+    if (job->cancelled) {
+        emit meshingCancelled();
+    } else if (!job->ok) {
+        emit meshingFailed();
+    } else {
+        m_result.swap(job->faces);
+        emit meshingFinished(job->revision, static_cast<int>(m_result.size()), job->seconds);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef ASYNCMESHER_H
+#define ASYNCMESHER_H
+
+#include <QObject>
+#include <memory>
+#include <vector>
+#include "meshdata.h"
+
+class QThread;
+
+// 在后台线程生成面。
+// request() 在界面线程对 MeshData 取快照（节点坐标、边），工作线程只读快照，
+// 计算期间界面可以继续操作视图和编辑数据；结果通过 meshingFinished 信号发回界面线程。
+// 同一时间只算一个请求：计算中再次 request() 会取消当前任务，并在它退出后开始最新的请求
+class AsyncMesher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncMesher(QObject *parent = nullptr);
+    ~AsyncMesher();
+
+    // 取快照并开始（或排队）生成面
+    void request(const MeshData& data);
+    // 取消正在计算和排队的请求
+    void cancel();
+    bool isBusy() const { return m_thread != nullptr; }
+
+    // meshingFinished 之后取走结果
+    std::vector<Face> takeFaces();
+
+signals:
+    void meshingStarted();
+    // revision: 取快照时的 MeshData::revision()，与当前不一致说明数据已经改过，结果作废
+    void meshingFinished(quint64 revision, int faceCount, double seconds);
+    void meshingCancelled();
+    void meshingFailed();
+
+private slots:
+    void onThreadFinished();
+
+private:
+    struct Job;
+    void start(std::unique_ptr<Job> job);
+
+    std::unique_ptr<Job> m_running;
+    std::unique_ptr<Job> m_pending; // 只保留最新的一个
+    QThread *m_thread = nullptr;
+
+    // 只在工作线程中使用；任务串行执行，缓冲在多次 Mesh 之间复用
+    cgal_tools::MeshingWorkspace m_workspace;
+    std::vector<Face> m_result;
+};
+
+#endif // ASYNCMESHER_H
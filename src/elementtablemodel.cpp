@@ -1,14 +1,24 @@
 #include "elementtablemodel.h"
+#include <algorithm>
+
+constexpr int kTextCacheRows = 4096;
 
 ElementTableModel::ElementTableModel(MeshData *data, QObject *parent)
-    : QAbstractTableModel(parent), m_data(data)
+    : QAbstractTableModel(parent), m_data(data), m_text(kTextCacheRows)
+{
+    m_rowCount = static_cast<int>(m_data->getElements().size());
+    m_data->addObserver(this);
+}
+
+ElementTableModel::~ElementTableModel()
 {
+    m_data->removeObserver(this);
 }
 
 int ElementTableModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid()) return 0;
-    return static_cast<int>(m_data->getElements().size());
+    return m_rowCount;
 }
 
 int ElementTableModel::columnCount(const QModelIndex &parent) const
@@ -22,16 +32,33 @@ QVariant ElementTableModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || role != Qt::DisplayRole)
         return QVariant();
 
-    const auto& elem = m_data->getElements()[index.row()];
+    const int row = index.row();
+    if (row >= static_cast<int>(m_data->getElements().size()))
+        return QVariant();
+
+    const auto& elem = m_data->getElements()[row];
+
+    static const QString lineText = QStringLiteral("Line");
+    static const QString arcText = QStringLiteral("Arc");
 
     switch (index.column()) {
     case 0: return elem.id;
-    case 1: return (elem.type == TYPE_LINE) ? "Line" : "Arc";
+    case 1: return (elem.type == TYPE_LINE) ? lineText : arcText;
     case 2: return elem.startNodeId;
     case 3: return elem.endNodeId;
-    case 4: return elem.midX;
-    case 5: return elem.midY;
-    case 6: return elem.midZ;
+    default: break;
+    }
+
+    RowText *text = m_text.object(row);
+    if (!text) {
+        text = new RowText{QString::number(elem.midX), QString::number(elem.midY), QString::number(elem.midZ)};
+        m_text.insert(row, text);
+    }
+
+    switch (index.column()) {
+    case 4: return text->midX;
+    case 5: return text->midY;
+    case 6: return text->midZ;
     default: return QVariant();
     }
 }
@@ -55,12 +82,49 @@ QVariant ElementTableModel::headerData(int section, Qt::Orientation orientation,
 
 void ElementTableModel::refresh()
 {
-    beginResetModel();
-    endResetModel();
+    resetRows();
 }
 void ElementTableModel::removeRow(int row)
 {
-    beginRemoveRows(QModelIndex(), row, row);
-    m_data->removeElementAtIndex(row); // 调用数据层的删除
-    endRemoveRows();
+    m_data->removeElementAtIndex(row); // 调用数据层的删除，由 meshChanged 通知 View
+}
+
+void ElementTableModel::meshChanged(const MeshChangeSet& changes)
+{
+    if (changes.reset) {
+        resetRows();
+        return;
+    }
+    for (const MeshRowRange& r : changes.elements) {
+        if (!r.inserted || r.first < m_rowCount) m_text.clear();
+        if (r.inserted) {
+            beginInsertRows(QModelIndex(), r.first, r.last);
+            m_rowCount += r.last - r.first + 1;
+            endInsertRows();
+        } else {
+            beginRemoveRows(QModelIndex(), r.first, r.last);
+            m_rowCount -= r.last - r.first + 1;
+            endRemoveRows();
+        }
+    }
+
+    const int first = changes.elementsModifiedFirst;
+    const int last = std::min(changes.elementsModifiedLast, m_rowCount - 1);
+    if (first >= 0 && first <= last) {
+        if (last - first + 1 > kTextCacheRows) {
+            m_text.clear();
+        } else {
+            for (int row = first; row <= last; ++row) m_text.remove(row);
+        }
+        // View 只会重读可见的单元格，范围再大也不贵
+        emit dataChanged(index(first, 0), index(last, columnCount() - 1), {Qt::DisplayRole});
+    }
+}
+
+void ElementTableModel::resetRows()
+{
+    beginResetModel();
+    m_text.clear();
+    m_rowCount = static_cast<int>(m_data->getElements().size());
+    endResetModel();
 }
@@ -2,12 +2,16 @@
 #define ELEMENTTABLEMODEL_H
 
 #include <QAbstractTableModel>
+#include <QCache>
+#include <QString>
 #include "meshdata.h"
 
-class ElementTableModel : public QAbstractTableModel
+// 单元表格，与 NodeTableModel 相同：按 MeshData 的通知增删行，中间点坐标文字缓存
+class ElementTableModel : public QAbstractTableModel, public MeshDataObserver
 {
 public:
     explicit ElementTableModel(MeshData *data, QObject *parent = nullptr);
+    ~ElementTableModel() override;
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -17,8 +21,19 @@ public:
     void refresh(); // 刷新数据
     void removeRow(int row);
 
+    // MeshDataObserver：按区间增删行，端点变化的行只通知 dataChanged
+    void meshChanged(const MeshChangeSet& changes) override;
+
 private:
+    struct RowText {
+        QString midX, midY, midZ;
+    };
+
+    void resetRows();
+
     MeshData *m_data;
+    int m_rowCount = 0;
+    mutable QCache<int, RowText> m_text;
 };
 
 #endif // ELEMENTTABLEMODEL_H
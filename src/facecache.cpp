@@ -0,0 +1,218 @@
+#include "facecache.h"
+#include <QFile>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+
+// 缓存文件布局（小端，与 .mpb 一样按 8 字节对齐）：
+//
+//   CacheHeader                 魔数、版本、键、面数、索引总数
+//   uint64[faceCount + 1]       CSR 偏移
+//   int32[indexCount]           点索引
+//   int32[indexCount]           边索引（面没有边索引时为 -1）
+//   double[faceCount][4]        area, centerX, centerY, centerZ
+constexpr char kCacheMagic[8] = {'M', 'P', 'F', 'A', 'C', 'E', 'S', '\0'};
+constexpr uint32_t kCacheVersion = 1;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t hash;
+    uint64_t nodeCount;
+    uint64_t elementCount;
+    uint64_t faceCount;
+    uint64_t indexCount;
+};
+static_assert(sizeof(CacheHeader) == 56, "CacheHeader layout");
+
+uint64_t align8(uint64_t v)
+{
+    return (v + 7) & ~uint64_t(7);
+}
+
+} // namespace
+
+FaceCache::Key FaceCache::keyOf(const MeshData& data)
+{
+    Key key;
+    key.hash = data.contentHash();
+    key.nodeCount = data.getNodes().size();
+    key.elementCount = data.getElements().size();
+    return key;
+}
+
+FaceCache::FaceCache(size_t maxBytes) : m_maxBytes(maxBytes) {}
+
+size_t FaceCache::bytesOf(const std::vector<Face>& faces)
+{
+    // 与 ReplaceDataCommand::bytes 的算法一致
+    size_t bytes = sizeof(Entry) + faces.capacity() * sizeof(Face);
+    for (const Face& f : faces) {
+        bytes += (f.nodeIndices.capacity() + f.edgeIndices.capacity()) * sizeof(int);
+    }
+    return bytes;
+}
+
+const std::vector<Face>* FaceCache::find(const Key& key)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key == key) {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            return &m_entries.front().faces;
+        }
+    }
+    return nullptr;
+}
+
+void FaceCache::insert(const Key& key, const std::vector<Face>& faces)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key == key) {
+            m_usedBytes -= it->bytes;
+            m_entries.erase(it);
+            break;
+        }
+    }
+
+    const size_t bytes = bytesOf(faces);
+    if (bytes > m_maxBytes) return;
+
+    // 从最久未用的开始淘汰，直到放得下
+    while (!m_entries.empty() && m_usedBytes + bytes > m_maxBytes) {
+        m_usedBytes -= m_entries.back().bytes;
+        m_entries.pop_back();
+    }
+    m_entries.push_front({key, faces, bytes});
+    m_usedBytes += bytes;
+}
+
+void FaceCache::clear()
+{
+    m_entries.clear();
+    m_usedBytes = 0;
+}
+
+QString FaceCache::fileFor(const QString& modelFile)
+{
+    return modelFile + ".faces";
+}
+
+bool FaceCache::save(const QString& fileName, const Key& key, const std::vector<Face>& faces,
+                     QString* errorMessage)
+{
+    CacheHeader header;
+    std::memcpy(header.magic, kCacheMagic, sizeof(header.magic));
+    header.version = kCacheVersion;
+    header.reserved = 0;
+    header.hash = key.hash;
+    header.nodeCount = key.nodeCount;
+    header.elementCount = key.elementCount;
+    header.faceCount = faces.size();
+    header.indexCount = 0;
+
+    std::vector<uint64_t> offsets;
+    offsets.reserve(faces.size() + 1);
+    offsets.push_back(0);
+    for (const Face& f : faces) {
+        header.indexCount += f.nodeIndices.size();
+        offsets.push_back(header.indexCount);
+    }
+
+    std::vector<int32_t> nodeIndices, edgeIndices;
+    nodeIndices.reserve(header.indexCount);
+    edgeIndices.reserve(header.indexCount);
+    std::vector<double> props;
+    props.reserve(faces.size() * 4);
+    for (const Face& f : faces) {
+        const bool hasEdges = f.edgeIndices.size() == f.nodeIndices.size();
+        for (size_t i = 0; i < f.nodeIndices.size(); ++i) {
+            nodeIndices.push_back(f.nodeIndices[i]);
+            edgeIndices.push_back(hasEdges ? f.edgeIndices[i] : -1);
+        }
+        props.insert(props.end(), {f.area, f.centerX, f.centerY, f.centerZ});
+    }
+
+    // 写到临时文件，成功后再替换，中途失败不会留下半个缓存文件
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = "Cannot write face cache: " + file.errorString();
+        return false;
+    }
+    static const char zeros[8] = {};
+    auto writeBlock = [&file](const void* p, uint64_t n) {
+        return n == 0 || file.write(static_cast<const char*>(p), static_cast<qint64>(n)) == static_cast<qint64>(n);
+    };
+    const uint64_t indexBytes = header.indexCount * sizeof(int32_t);
+    const uint64_t pad = align8(indexBytes) - indexBytes;
+    bool ok = writeBlock(&header, sizeof(header))
+              && writeBlock(offsets.data(), offsets.size() * sizeof(uint64_t))
+              && writeBlock(nodeIndices.data(), indexBytes) && writeBlock(zeros, pad)
+              && writeBlock(edgeIndices.data(), indexBytes) && writeBlock(zeros, pad)
+              && writeBlock(props.data(), props.size() * sizeof(double));
+    if (ok) ok = file.commit();
+    if (!ok) {
+        if (errorMessage) *errorMessage = "Cannot write face cache: " + file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    return true;
+}
+
+bool FaceCache::load(const QString& fileName, const Key& key, std::vector<Face>& faces)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const uint64_t size = static_cast<uint64_t>(file.size());
+    if (size < sizeof(CacheHeader)) return false;
+    const uchar* base = file.map(0, file.size());
+    if (!base) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(header.magic)) != 0 || header.version != kCacheVersion
+        || header.hash != key.hash || header.nodeCount != key.nodeCount
+        || header.elementCount != key.elementCount) {
+        return false;
+    }
+
+    // 按计数核对文件大小，防止截断或损坏的文件读越界
+    const uint64_t maxItems = size / sizeof(int32_t);
+    if (header.faceCount >= maxItems || header.indexCount >= maxItems) return false;
+    const uint64_t offsetBlock = sizeof(CacheHeader);
+    const uint64_t nodeBlock = offsetBlock + (header.faceCount + 1) * sizeof(uint64_t);
+    const uint64_t edgeBlock = nodeBlock + align8(header.indexCount * sizeof(int32_t));
+    const uint64_t propBlock = edgeBlock + align8(header.indexCount * sizeof(int32_t));
+    if (propBlock + header.faceCount * 4 * sizeof(double) != size) return false;
+
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + offsetBlock);
+    const int32_t* nodeIndices = reinterpret_cast<const int32_t*>(base + nodeBlock);
+    const int32_t* edgeIndices = reinterpret_cast<const int32_t*>(base + edgeBlock);
+    const double* props = reinterpret_cast<const double*>(base + propBlock);
+    if (offsets[0] != 0 || offsets[header.faceCount] != header.indexCount) return false;
+
+    std::vector<Face> loaded(header.faceCount);
+    for (uint64_t i = 0; i < header.faceCount; ++i) {
+        const uint64_t first = offsets[i];
+        const uint64_t last = offsets[i + 1];
+        if (last < first || last > header.indexCount) return false;
+        Face& f = loaded[i];
+        f.nodeIndices.assign(nodeIndices + first, nodeIndices + last);
+        for (const int32_t n : f.nodeIndices) {
+            if (n < 0 || static_cast<uint64_t>(n) >= key.nodeCount) return false;
+        }
+        if (first < last && edgeIndices[first] >= 0) {
+            f.edgeIndices.assign(edgeIndices + first, edgeIndices + last);
+            for (const int32_t e : f.edgeIndices) {
+                if (e < 0 || static_cast<uint64_t>(e) >= key.elementCount) return false;
+            }
+        }
+        f.area = props[i * 4];
+        f.centerX = props[i * 4 + 1];
+        f.centerY = props[i * 4 + 2];
+        f.centerZ = props[i * 4 + 3];
+    }
+    faces.swap(loaded);
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef FACECACHE_H
+#define FACECACHE_H
+
+#include <QString>
+#include <cstdint>
+#include <list>
+#include <vector>
+#include "meshdata.h"
+
+// 生成面的结果缓存。
+// 以 MeshData::contentHash 和点/线数量为键保存生成的面（点索引、边索引、面积、中心），
+// 模型没变或改回原样后再点 Mesh 时直接取回，不再重新计算。
+// 内存中按最近使用淘汰，总大小不超过上限；也可以把一份结果存到模型文件旁边，下次打开同一模型时读回
+class FaceCache
+{
+public:
+    struct Key {
+        uint64_t hash = 0;
+        uint64_t nodeCount = 0;
+        uint64_t elementCount = 0;
+
+        bool operator==(const Key& other) const {
+            return hash == other.hash && nodeCount == other.nodeCount && elementCount == other.elementCount;
+        }
+    };
+    static Key keyOf(const MeshData& data);
+
+    explicit FaceCache(size_t maxBytes = size_t(256) << 20);
+
+    // 命中时返回缓存的面并标记为最近使用，否则返回 nullptr。
+    // 指针在下一次 insert / clear 之前有效
+    const std::vector<Face>* find(const Key& key);
+    // 拷贝一份存入；已有相同的键时替换。单份结果超过上限时不缓存
+    void insert(const Key& key, const std::vector<Face>& faces);
+    void clear();
+
+    size_t usedBytes() const { return m_usedBytes; }
+    size_t maxBytes() const { return m_maxBytes; }
+
+    // 磁盘缓存：modelFile 对应的缓存文件为 "<modelFile>.faces"
+    static QString fileFor(const QString& modelFile);
+    static bool save(const QString& fileName, const Key& key, const std::vector<Face>& faces,
+                     QString* errorMessage = nullptr);
+    // 文件存在、格式正确且键一致时读入 faces 并返回 true；否则 faces 不变
+    static bool load(const QString& fileName, const Key& key, std::vector<Face>& faces);
+
+private:
+    struct Entry {
+        Key key;
+        std::vector<Face> faces;
+        size_t bytes;
+    };
+    static size_t bytesOf(const std::vector<Face>& faces);
+
+    std::list<Entry> m_entries; // 最近使用的在前
+    size_t m_maxBytes;
+    size_t m_usedBytes = 0;
+};
+
+#endif // FACECACHE_H
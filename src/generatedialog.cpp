@@ -0,0 +1,117 @@
+#include "generatedialog.h"
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QSpinBox>
+
+namespace {
+
+QSpinBox *makeCount(int value, int minimum, int maximum, QWidget *parent)
+{
+    auto *box = new QSpinBox(parent);
+    box->setRange(minimum, maximum);
+    box->setValue(value);
+    return box;
+}
+
+} // namespace
+
+GenerateDialog::GenerateDialog(Kind kind, QWidget *parent)
+    : QDialog(parent), m_kind(kind)
+{
+    auto *form = new QFormLayout;
+    m_size = new QDoubleSpinBox(this);
+    m_size->setRange(0.001, 1e6);
+    m_size->setDecimals(3);
+    m_size->setValue(1.0);
+
+    switch (kind) {
+    case Grid:
+        setWindowTitle(tr("Generate Grid"));
+        m_countX = makeCount(100, 1, 10000, this);
+        m_countY = makeCount(100, 1, 10000, this);
+        form->addRow(tr("Nodes along X"), m_countX);
+        form->addRow(tr("Nodes along Y"), m_countY);
+        form->addRow(tr("Spacing"), m_size);
+        break;
+    case Lattice:
+        setWindowTitle(tr("Generate Lattice"));
+        m_countX = makeCount(20, 1, 1000, this);
+        m_countY = makeCount(20, 1, 1000, this);
+        m_countZ = makeCount(20, 1, 1000, this);
+        form->addRow(tr("Nodes along X"), m_countX);
+        form->addRow(tr("Nodes along Y"), m_countY);
+        form->addRow(tr("Nodes along Z"), m_countZ);
+        form->addRow(tr("Spacing"), m_size);
+        break;
+    case Circle:
+        setWindowTitle(tr("Generate Circle/Arc"));
+        m_segments = makeCount(64, 1, 10000000, this);
+        m_sweep = new QDoubleSpinBox(this);
+        m_sweep->setRange(0.01, 360.0);
+        m_sweep->setValue(360.0);
+        m_sweep->setSuffix(QStringLiteral("°"));
+        m_useArcs = new QCheckBox(tr("Use arc segments"), this);
+        m_size->setValue(10.0);
+        form->addRow(tr("Segments"), m_segments);
+        form->addRow(tr("Radius"), m_size);
+        form->addRow(tr("Sweep"), m_sweep);
+        form->addRow(QString(), m_useArcs);
+        // 段数下限与 meshgen::circle 一致：闭合的圆至少 3 条直线或 2 条弧线
+        {
+            auto updateMinimum = [this]() {
+                const bool closed = m_sweep->value() >= 360.0;
+                m_segments->setMinimum(closed ? (m_useArcs->isChecked() ? 2 : 3) : 1);
+            };
+            connect(m_sweep, &QDoubleSpinBox::valueChanged, this, updateMinimum);
+            connect(m_useArcs, &QCheckBox::toggled, this, updateMinimum);
+            updateMinimum();
+        }
+        break;
+    case RandomCloud:
+        setWindowTitle(tr("Generate Random Cloud"));
+        m_countX = makeCount(10000, 1, 100000000, this);
+        m_neighbours = makeCount(3, 0, 32, this);
+        m_seed = makeCount(1, 0, 2147483647, this);
+        m_size->setValue(100.0);
+        form->addRow(tr("Nodes"), m_countX);
+        form->addRow(tr("Neighbours per node"), m_neighbours);
+        form->addRow(tr("Box size"), m_size);
+        form->addRow(tr("Seed"), m_seed);
+        break;
+    }
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    form->addRow(buttons);
+    setLayout(form);
+}
+
+meshgen::GeneratedMesh GenerateDialog::generate() const
+{
+    switch (m_kind) {
+    case Grid:
+        return meshgen::grid(m_countX->value(), m_countY->value(), m_size->value());
+    case Lattice:
+        return meshgen::lattice(m_countX->value(), m_countY->value(), m_countZ->value(), m_size->value());
+    case Circle:
+        return meshgen::circle(m_segments->value(), m_size->value(), m_sweep->value(), m_useArcs->isChecked());
+    case RandomCloud:
+        return meshgen::randomCloud(m_countX->value(), m_neighbours->value(), m_size->value(),
+                                    static_cast<uint32_t>(m_seed->value()));
+    }
+    return {};
+}
+
+QString GenerateDialog::commandText() const
+{
+    switch (m_kind) {
+    case Grid: return QStringLiteral("Generate Grid");
+    case Lattice: return QStringLiteral("Generate Lattice");
+    case Circle: return QStringLiteral("Generate Circle");
+    case RandomCloud: return QStringLiteral("Generate Random Cloud");
+    }
+    return QString();
+}
@@ -0,0 +1,44 @@
+#ifndef GENERATEDIALOG_H
+#define GENERATEDIALOG_H
+
+#include <QDialog>
+#include "meshgenerator.h"
+
+class QCheckBox;
+class QDoubleSpinBox;
+class QSpinBox;
+
+// 批量生成的参数对话框，按生成类型只显示相关的参数
+class GenerateDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Grid,
+        Lattice,
+        Circle,
+        RandomCloud
+    };
+
+    explicit GenerateDialog(Kind kind, QWidget *parent = nullptr);
+
+    // 按当前参数生成（节点数上亿时可能较慢，只在确认后调用）
+    meshgen::GeneratedMesh generate() const;
+    // 用作撤销记录的名称
+    QString commandText() const;
+
+private:
+    Kind m_kind;
+    QSpinBox *m_countX = nullptr;
+    QSpinBox *m_countY = nullptr;
+    QSpinBox *m_countZ = nullptr;
+    QSpinBox *m_segments = nullptr;
+    QSpinBox *m_neighbours = nullptr;
+    QSpinBox *m_seed = nullptr;
+    QDoubleSpinBox *m_size = nullptr;
+    QDoubleSpinBox *m_sweep = nullptr;
+    QCheckBox *m_useArcs = nullptr;
+};
+
+#endif // GENERATEDIALOG_H
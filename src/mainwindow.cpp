@@ -1,9 +1,77 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "generatedialog.h"
+#include "meshweld.h"
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QFile>
 #include <QTextStream>
 #include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QThread>
+#include <QTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+// 流式导入时排队等待界面线程追加的批次上限，超过后解析线程等待
+constexpr size_t kMaxQueuedBatches = 8;
+// 界面线程每次定时器触发时追加批次的时间预算（毫秒），保证视图流畅
+constexpr qint64 kStreamAppendBudgetMs = 8;
+
+// 焊接结果的状态栏说明
+static QString weldSummary(const meshweld::WeldStats& stats)
+{
+    return QString("Welded %1 nodes, removed %2 duplicate and %3 degenerate elements (tolerance %4, %5 s).")
+        .arg(stats.mergedNodes).arg(stats.duplicateElements).arg(stats.degenerateElements)
+        .arg(stats.tolerance, 0, 'g', 3).arg(stats.seconds, 0, 'f', 2);
+}
+
+// 一次后台导入的全部状态。工作线程只读写这里的成员，
+// 线程结束（finished 信号）之后才在界面线程里读取结果
+struct MainWindow::ImportJob {
+    QString fileName;
+    QString outputFileName;     // 分块生成面的输出文件
+    ImportKind kind = ImportText;
+    MeshData data;              // 流式导入不用，直接追加进 m_meshData
+    meshio::IoStats stats;
+    meshio::TiledMeshingStats tiledStats;
+    bool weld = false;          // 读完后焊接重合的点（流式导入不支持）
+    meshweld::WeldStats weldStats;
+    meshio::IoProgress progress;
+    QString error;
+    bool ok = false;
+
+    // 流式导入：解析线程产出的批次，界面线程取走
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<meshio::StreamBatch> batches;
+
+    void cancel() {
+        progress.cancel();
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+    }
+
+    // 在工作线程里执行导入。异常逃出线程会直接 terminate，连同未保存的场景一起丢掉；
+    // 超大文件的 bad_alloc、损坏文件头导致的 length_error 等都转成导入失败，由 onImportFinished 报告
+    template <typename Work>
+    void run(Work&& work) {
+        try {
+            work();
+        } catch (const std::exception& e) {
+            ok = false;
+            error = QString("Import failed: %1").arg(QString::fromLocal8Bit(e.what()));
+        } catch (...) {
+            ok = false;
+            error = QString("Import failed with an unknown error.");
+        }
+    }
+};
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -13,6 +81,34 @@ MainWindow::MainWindow(QWidget *parent)
 
     // 1. 初始化数据
     m_meshData = new MeshData();
+    m_history = new MeshHistory(m_meshData);
+
+    // 导入进度条和取消按钮，放在状态栏右侧，导入时才显示
+    m_importProgress = new QProgressBar(this);
+    m_importProgress->setRange(0, 1000);
+    m_importProgress->setTextVisible(false);
+    m_importProgress->setMaximumWidth(200);
+    m_btnCancelImport = new QPushButton(tr("Cancel"), this);
+    ui->statusbar->addPermanentWidget(m_importProgress);
+    ui->statusbar->addPermanentWidget(m_btnCancelImport);
+    m_importProgress->hide();
+    m_btnCancelImport->hide();
+    connect(m_btnCancelImport, &QPushButton::clicked, this, &MainWindow::onCancelImport);
+
+    // 生成面在后台进行，计算中显示取消按钮
+    m_mesher = new AsyncMesher(this);
+    m_btnCancelMesh = new QPushButton(tr("Cancel Mesh"), this);
+    ui->statusbar->addPermanentWidget(m_btnCancelMesh);
+    m_btnCancelMesh->hide();
+    connect(m_btnCancelMesh, &QPushButton::clicked, m_mesher, &AsyncMesher::cancel);
+    connect(m_mesher, &AsyncMesher::meshingStarted, this, &MainWindow::onMeshingStarted);
+    connect(m_mesher, &AsyncMesher::meshingFinished, this, &MainWindow::onMeshingFinished);
+    connect(m_mesher, &AsyncMesher::meshingCancelled, this, &MainWindow::onMeshingStopped);
+    connect(m_mesher, &AsyncMesher::meshingFailed, this, &MainWindow::onMeshingStopped);
+
+    m_importTimer = new QTimer(this);
+    m_importTimer->setInterval(100);
+    connect(m_importTimer, &QTimer::timeout, this, &MainWindow::onImportProgressTick);
 
     // 2. 初始化模型，并把数据传给它
     // 点表格
@@ -36,6 +132,11 @@ MainWindow::MainWindow(QWidget *parent)
     ui->tableElements->setSelectionMode(QAbstractItemView::ExtendedSelection);
 
     // --- 2. 连接信号 ---
+    // 选中状态位图最先连接，后面的槽函数读到的就是更新后的状态
+    m_selection = new MeshSelection(this);
+    m_selection->attach(ui->tableNodes->selectionModel(), ui->tableElements->selectionModel());
+    ui->view3D->setSelection(m_selection);
+
     // 监听线表格的选择变化
     connect(ui->tableElements->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &MainWindow::onElemTableSelectionChanged);
@@ -43,18 +144,12 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->tableNodes->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &MainWindow::onTableSelectionChanged);
     connect(ui->view3D, &Plotter3D::nodeClicked, this, [=](int nodeId){
+        // 流式导入期间不响应点击（连线会往正在追加的数据里插入命令）
+        if (isStreamingImport()) return;
         // 1. 如果不是连线模式，就执行“同步选中”逻辑
         if (!m_isLineMode && !m_isArcMode) {
-            // 遍历数据，找到 ID 对应的行号 (Row Index)
-            // 注意：行号不一定等于 ID，因为删除后 ID 会断号
-            const auto& nodes = m_meshData->getNodes();
-            int targetRow = -1;
-            for (size_t i = 0; i < nodes.size(); ++i) {
-                if (nodes[i].id == nodeId) {
-                    targetRow = static_cast<int>(i);
-                    break;
-                }
-            }
+            // 找到 ID 对应的行号 (Row Index)：删除后 ID 会重排，与行号始终一致，O(1)
+            int targetRow = m_meshData->nodeIndexOf(nodeId);
 
             if (targetRow != -1) {
                 // 在表格中选中这一行
@@ -81,13 +176,16 @@ MainWindow::MainWindow(QWidget *parent)
             else {
                 // 阶段 2：选中了第二个点，连线！
                 if (m_startNodeId != nodeId) {
-                    m_meshData->addLine(m_startNodeId, nodeId);
-                    m_elemModel->refresh();
+                    Element line{};
+                    line.type = TYPE_LINE;
+                    line.startNodeId = m_startNodeId;
+                    line.endNodeId = nodeId;
+                    m_history->push(std::make_unique<AddElementCommand>(line));
+                    updateUndoActions();
 
                     // 连完后，清空状态
                     m_startNodeId = -1;
                     ui->view3D->setHighlightIndices({}); // 取消高亮
-                    ui->view3D->update(); // 重绘
 
                     ui->statusbar->showMessage(tr("Line created!"), 2000);
                 }
@@ -112,18 +210,21 @@ MainWindow::MainWindow(QWidget *parent)
                 if (nodeId == m_arcNode1 || nodeId == m_arcNode2) return;
 
                 // 1. 获取中间点的坐标 (因为 MeshData::addArc 需要坐标)
-                const auto& nodes = m_meshData->getNodes();
                 double mx=0, my=0, mz=0;
-                for(const auto& n : nodes) {
-                    if(n.id == m_arcNode2) { mx=n.x; my=n.y; mz=n.z; break; }
+                if (const Node* n = m_meshData->findNode(m_arcNode2)) {
+                    mx = n->x; my = n->y; mz = n->z;
                 }
 
                 // 2. 添加数据 (起点ID, 终点ID, 中间点坐标)
-                m_meshData->addArc(m_arcNode1, nodeId, mx, my, mz);
+                Element arc{};
+                arc.type = TYPE_ARC;
+                arc.startNodeId = m_arcNode1;
+                arc.endNodeId = nodeId;
+                arc.midX = mx; arc.midY = my; arc.midZ = mz;
+                m_history->push(std::make_unique<AddElementCommand>(arc));
+                updateUndoActions();
 
-                // 3. 刷新视图和表格
-                m_elemModel->refresh();
-                ui->view3D->update();
+                // 3. 表格和 3D 视图由 MeshData 的通知自动更新
 
                 // 4. 重置状态
                 m_arcNode1 = -1;
@@ -135,6 +236,7 @@ MainWindow::MainWindow(QWidget *parent)
         }
     });
     connect(ui->view3D, &Plotter3D::elementClicked, this, [=](int elemId){
+        if (isStreamingImport()) return;
         // 1. 如果正在连线模式，不要选线，容易误触
         if (m_isLineMode) return;
 
@@ -142,14 +244,7 @@ MainWindow::MainWindow(QWidget *parent)
         ui->tabWidget->setCurrentIndex(1);
 
         // 3. 在线表格中找到这一行并选中
-        const auto& elements = m_meshData->getElements();
-        int targetRow = -1;
-        for (size_t i = 0; i < elements.size(); ++i) {
-            if (elements[i].id == elemId) {
-                targetRow = static_cast<int>(i);
-                break;
-            }
-        }
+        int targetRow = m_meshData->elementIndexOf(elemId);
         if (targetRow != -1) {
             ui->tableElements->selectRow(targetRow);
             // (可选) 顺便让 Node 表格取消选择，避免混淆
@@ -162,11 +257,25 @@ MainWindow::MainWindow(QWidget *parent)
     // 菜单按钮
     connect(ui->actionShowFaceInfo, &QAction::toggled,
             ui->view3D, &Plotter3D::setShowFaceInfo);
+    connect(ui->actionShowRenderStats, &QAction::toggled,
+            ui->view3D, &Plotter3D::setShowStats);
     // connect(ui->actionClear, )
 }
 
 MainWindow::~MainWindow()
 {
+    // 关闭窗口时如果还在导入，先取消并等工作线程退出
+    if (m_importThread) {
+        m_importThread->disconnect(this);
+        m_importJob->cancel();
+        m_importThread->wait();
+        delete m_importThread;
+    }
+    delete m_history;
+    // 表格模型和 3D 视图都监听着 MeshData，必须先注销再删除数据
+    delete m_nodeModel;
+    delete m_elemModel;
+    ui->view3D->setMeshData(nullptr);
     delete m_meshData; // 记得手动删除非QObject对象
     delete ui;
 }
@@ -174,151 +283,389 @@ void MainWindow::on_actionImport_triggered()
 {
     // 1. 获取文件路径
     QString fileName = QFileDialog::getOpenFileName(this,
-                                                    tr("Import Mesh"), "", tr("Text Files (*.txt);;All Files (*)"));
+                                                    tr("Import Mesh"), "", tr("Text Files (*.txt *.txt.gz *.txt.zst);;All Files (*)"));
 
     if (fileName.isEmpty()) return;
 
     // 2. 提示是否覆盖当前数据（如果当前有数据）
-    if (!m_meshData->getNodes().empty()) {
-        QMessageBox::StandardButton reply;
-        reply = QMessageBox::question(this, "Import",
-                                      "Importing will clear current data. Continue?",
-                                      QMessageBox::Yes | QMessageBox::No);
-        if (reply == QMessageBox::No) return;
-    }
+    if (!confirmReplaceData()) return;
 
-    // 3. 打开文件
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Cannot open file!");
-        return;
-    }
+    // 3. 后台解析到一个新的 MeshData（内存映射 + 多线程解析），完成后替换当前场景
+    startImport(fileName, ImportText);
+}
+
+void MainWindow::on_actionImportBinary_triggered()
+{
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    tr("Import Binary Mesh"), "", tr("Mesh Binary (*.mpb *.mpb.gz *.mpb.zst);;All Files (*)"));
+
+    if (fileName.isEmpty()) return;
+    if (!confirmReplaceData()) return;
+
+    // 二进制文件直接内存映射读取，几乎没有解析开销
+    startImport(fileName, ImportBinary);
+}
 
-    // 4. 清空当前场景
-    // (确保 MeshData::clear() 同时也重置了 m_nextNodeId 和 m_nextElementId 为 0)
-    m_meshData->clearData();
+void MainWindow::on_actionMeshLargeBinary_triggered()
+{
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    tr("Mesh Large Binary File"), "", tr("Mesh Binary (*.mpb);;All Files (*)"));
+    if (fileName.isEmpty()) return;
 
-    QTextStream in(&file);
-    QString line;
-    int mode = 0; // 0=None, 1=Nodes, 2=Elements
+    const QFileInfo info(fileName);
+    QString outputName = QFileDialog::getSaveFileName(this, tr("Save Meshed Binary"),
+                                                      info.dir().filePath(info.completeBaseName() + "_faces.mpb"),
+                                                      tr("Mesh Binary (*.mpb *.mpb.gz *.mpb.zst);;All Files (*)"));
+    if (outputName.isEmpty()) return;
 
-    // 开始解析
-    while (!in.atEnd()) {
-        line = in.readLine().trimmed();
+    // 放不进内存的模型：不读进场景，在后台分块生成面并直接写到输出文件
+    startImport(fileName, MeshBinaryTiled, outputName);
+}
 
-        // 跳过空行和注释
-        if (line.isEmpty() || line.startsWith("#")) continue;
+void MainWindow::on_actionImportStreaming_triggered()
+{
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    tr("Import Mesh (Streaming)"), "", tr("Text Files (*.txt *.txt.gz *.txt.zst);;All Files (*)"));
 
-        // 检测头部关键字
-        if (line.startsWith("NODES")) {
-            mode = 1;
-            continue; //这一行是计数，跳过，直接读下一行数据
-        }
-        else if (line.startsWith("EDGES") || line.startsWith("ELEMENTS")) {
-            mode = 2;
-            continue;
-        }
+    if (fileName.isEmpty()) return;
+    if (!confirmReplaceData()) return;
 
-        // 按空格分割数据
-        QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-
-        if (mode == 1) { // 解析节点
-            // 格式: ID X Y Z
-            // 注意：因为我们刚清空了数据，addNode 会自动产生 ID。
-            // 假设文件里的 ID 是顺序排列的(0,1,2...)，那么 addNode 产生的 ID 会和文件一致。
-            if (parts.size() >= 4) {
-                double x = parts[1].toDouble();
-                double y = parts[2].toDouble();
-                double z = parts[3].toDouble();
-                m_meshData->addNode(x, y, z);
-            }
-        }
-        else if (mode == 2) { // 解析单元
-            // 格式: ID TYPE START END [midX midY midZ]
-            // Line: 0 0 0 8 0 0 0
-            // Arc:  20 1 9 10 2.5 0 2
-            if (parts.size() >= 4) {
-                // parts[0] 是 ID (我们忽略它，让 addLine 自动生成)
-                int type = parts[1].toInt();
-                int startId = parts[2].toInt();
-                int endId = parts[3].toInt();
-
-                if (type == 0) {
-                    // 直线
-                    m_meshData->addLine(startId, endId);
+    // 边读边显示：读到的数据分批追加进当前场景
+    startImport(fileName, ImportStreaming);
+}
+
+void MainWindow::on_actionImportMeshFormat_triggered()
+{
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    tr("Import OBJ/PLY"), "", tr("Mesh Files (*.obj *.ply *.obj.gz *.ply.gz *.obj.zst *.ply.zst);;All Files (*)"));
+
+    if (fileName.isEmpty()) return;
+    if (!confirmReplaceData()) return;
+
+    // 节点、线和面一起读入；面的边会补成线
+    startImport(fileName, ImportMeshFormat);
+}
+
+void MainWindow::startImport(const QString& fileName, ImportKind kind, const QString& outputFileName)
+{
+    if (m_importThread) return;
+
+    m_importJob = std::make_unique<ImportJob>();
+    m_importJob->fileName = fileName;
+    m_importJob->outputFileName = outputFileName;
+    m_importJob->kind = kind;
+    m_importJob->weld = ui->actionWeldOnImport->isChecked();
+    ImportJob* job = m_importJob.get();
+
+    if (kind == ImportStreaming) {
+        // 先把当前数据整体换进撤销记录（场景变空），之后的批次直接追加。
+        // 导入期间禁止编辑，保证文件里的点 ID 与下标一致
+        MeshData empty;
+        m_history->push(std::make_unique<ReplaceDataCommand>("Import", empty));
+        refreshAfterHistoryChange();
+        ui->view3D->beginStreaming();
+
+        m_importThread = QThread::create([job]() {
+            job->run([job]() {
+                job->ok = meshio::streamText(job->fileName, [job](meshio::StreamBatch& batch) {
+                    std::unique_lock<std::mutex> lock(job->mutex);
+                    job->cv.wait(lock, [job]() {
+                        return job->batches.size() < kMaxQueuedBatches || job->progress.isCancelled();
+                    });
+                    if (job->progress.isCancelled()) return false;
+                    job->batches.push_back(std::move(batch));
+                    return true;
+                }, &job->stats, &job->error, &job->progress);
+            });
+        });
+    } else {
+        // 工作线程不碰 m_meshData，界面在导入期间保持可用
+        m_importThread = QThread::create([job]() {
+            job->run([job]() {
+                if (job->kind == ImportBinary) {
+                    job->ok = meshio::importBinary(job->fileName, job->data, &job->stats, &job->error, &job->progress);
+                } else if (job->kind == MeshBinaryTiled) {
+                    job->ok = meshio::meshBinaryTiled(job->fileName, job->outputFileName, meshio::TiledMeshingOptions(),
+                                                      &job->tiledStats, &job->stats, &job->error, &job->progress);
+                } else if (job->kind == ImportMeshFormat) {
+                    job->ok = meshio::importMeshFormat(job->fileName, job->data, &job->stats, &job->error, &job->progress);
+                } else {
+                    job->ok = meshio::importText(job->fileName, job->data, &job->stats, &job->error, &job->progress);
                 }
-                else if (type == 1 && parts.size() >= 7) {
-                    // 弧线 (需要读取 mid 坐标)
-                    double mx = parts[4].toDouble();
-                    double my = parts[5].toDouble();
-                    double mz = parts[6].toDouble();
-                    m_meshData->addArc(startId, endId, mx, my, mz);
+                if (job->ok && job->weld && job->kind != MeshBinaryTiled) {
+                    job->weldStats = meshweld::weld(job->data);
                 }
-            }
+            });
+        });
+    }
+    connect(m_importThread, &QThread::finished, this, &MainWindow::onImportFinished);
+
+    m_importClock.start();
+    setImportRunning(true);
+    m_importThread->start();
+}
+
+void MainWindow::setImportRunning(bool running)
+{
+    const bool streaming = running && isStreamingImport();
+    ui->dockWidgetContents->setEnabled(!streaming);
+    ui->menu_2->setEnabled(!streaming);
+    // 禁用菜单不会禁用其中的动作，快捷键（Ctrl+Z 等）照样触发，要逐个禁用。
+    // 流式导入中撤销开头的 Import 会把正在追加的数据换走，之后的批次就接到了旧模型上
+    for (QAction* action : {ui->actionClear, ui->actionWeldNodes, ui->actionGenerateGrid,
+                            ui->actionGenerateLattice, ui->actionGenerateCircle, ui->actionGenerateRandom}) {
+        action->setEnabled(!streaming);
+    }
+    updateUndoActions();
+
+    ui->actionImport->setEnabled(!running);
+    ui->actionImportBinary->setEnabled(!running);
+    ui->actionImportStreaming->setEnabled(!running);
+    ui->actionImportMeshFormat->setEnabled(!running);
+    ui->actionMeshLargeBinary->setEnabled(!running);
+    m_importProgress->setValue(0);
+    m_importProgress->setVisible(running);
+    m_btnCancelImport->setEnabled(true);
+    m_btnCancelImport->setVisible(running);
+    if (running) {
+        // 流式导入要按帧追加数据，定时器更密
+        m_importTimer->setInterval(streaming ? 16 : 100);
+        m_importTimer->start();
+        onImportProgressTick();
+    } else {
+        m_importTimer->stop();
+    }
+}
+
+bool MainWindow::appendStreamedBatches(qint64 budgetMs)
+{
+    ImportJob* job = m_importJob.get();
+    QElapsedTimer timer;
+    timer.start();
+
+    // 这一轮追加的所有批次合并成一次变化通知
+    MeshData::UpdateScope scope(*m_meshData);
+    bool appended = false;
+    while (budgetMs < 0 || timer.elapsed() < budgetMs) {
+        meshio::StreamBatch batch;
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (job->batches.empty()) break;
+            batch = std::move(job->batches.front());
+            job->batches.pop_front();
+            job->cv.notify_all();
+        }
+        meshio::appendBatch(*m_meshData, batch);
+        appended = true;
+    }
+    return appended;
+}
+
+void MainWindow::onImportProgressTick()
+{
+    if (!m_importJob) return;
+
+    if (m_importJob->kind == ImportStreaming) {
+        appendStreamedBatches(kStreamAppendBudgetMs);
+    }
+
+    const meshio::IoProgress& p = m_importJob->progress;
+    const double seconds = m_importClock.nsecsElapsed() / 1e9;
+    const double mbps = seconds > 0.0 ? p.bytesDone.load() / (1024.0 * 1024.0) / seconds : 0.0;
+    m_importProgress->setValue(static_cast<int>(p.fraction() * 1000));
+    ui->statusbar->showMessage(QString(m_importJob->kind == MeshBinaryTiled ? "Meshing %1... %2% (%3 MB/s)"
+                                                                            : "Importing %1... %2% (%3 MB/s)")
+                                   .arg(QFileInfo(m_importJob->fileName).fileName())
+                                   .arg(static_cast<int>(p.fraction() * 100))
+                                   .arg(mbps, 0, 'f', 0));
+}
+
+void MainWindow::onCancelImport()
+{
+    if (!m_importJob) return;
+    m_importJob->cancel();
+    m_btnCancelImport->setEnabled(false);
+    ui->statusbar->showMessage(tr("Cancelling import..."));
+}
+
+void MainWindow::onImportFinished()
+{
+    // 线程已经结束，之后可以安全地读取 job 里的结果
+    if (m_importJob->kind == ImportStreaming) {
+        finishStreamingImport();
+        return;
+    }
+
+    std::unique_ptr<ImportJob> job = std::move(m_importJob);
+    m_importThread->deleteLater();
+    m_importThread = nullptr;
+    setImportRunning(false);
+
+    if (job->ok && job->kind == MeshBinaryTiled) {
+        // 场景不变，只报告结果
+        const meshio::TiledMeshingStats& ts = job->tiledStats;
+        QString message = QString("Meshed %1: %2 faces in %3 tiles, %4 s -> %5")
+                              .arg(QFileInfo(job->fileName).fileName())
+                              .arg(ts.faces).arg(ts.tiles)
+                              .arg(job->stats.seconds, 0, 'f', 2)
+                              .arg(QFileInfo(job->outputFileName).fileName());
+        if (ts.droppedFaces > 0) message += QString(" (%1 faces dropped at tile borders)").arg(ts.droppedFaces);
+        ui->statusbar->showMessage(message, 10000);
+    } else if (job->ok) {
+        // 新数据一次性交换进场景
+        m_modelFile = job->fileName;
+        applyImportedData(job->data, job->stats);
+        if (job->weldStats.changed()) {
+            ui->statusbar->showMessage(QString("Data imported successfully! %1 nodes, %2 elements. ")
+                                           .arg(m_meshData->getNodes().size()).arg(m_meshData->getElements().size())
+                                       + weldSummary(job->weldStats), 8000);
         }
+    } else if (job->progress.isCancelled()) {
+        ui->statusbar->showMessage(job->kind == MeshBinaryTiled ? tr("Meshing cancelled.") : tr("Import cancelled."), 3000);
+    } else {
+        ui->statusbar->clearMessage();
+        QMessageBox::critical(this, "Error", job->error);
     }
+}
 
-    file.close();
+void MainWindow::finishStreamingImport()
+{
+    // 解析线程已经退出，把剩下的批次全部追加
+    appendStreamedBatches(-1);
+
+    std::unique_ptr<ImportJob> job = std::move(m_importJob);
+    m_importThread->deleteLater();
+    m_importThread = nullptr;
+    setImportRunning(false);
+    ui->view3D->endStreaming();
+
+    if (!job->ok && !job->progress.isCancelled() && m_meshData->getNodes().empty()
+        && m_meshData->getElements().empty()) {
+        // 一批都没读到（如文件打不开）：撤回开头的替换
+        m_history->undo();
+        refreshAfterHistoryChange();
+        ui->statusbar->clearMessage();
+        QMessageBox::critical(this, "Error", job->error);
+        return;
+    }
+
+    refreshAfterHistoryChange();
+    if (job->ok) {
+        m_modelFile = job->fileName;
+        const double seconds = m_importClock.nsecsElapsed() / 1e9;
+        ui->statusbar->showMessage(QString("Data imported successfully! %1 nodes, %2 elements in %3 s (%4 MB/s)")
+                                       .arg(job->stats.nodes).arg(job->stats.elements)
+                                       .arg(seconds, 0, 'f', 2)
+                                       .arg(seconds > 0.0 ? job->stats.bytes / (1024.0 * 1024.0) / seconds : 0.0, 0, 'f', 0), 5000);
+    } else {
+        // 停止时保留已经读到的部分，可以撤销回导入前
+        ui->statusbar->showMessage(QString("Import stopped. %1 nodes, %2 elements loaded.")
+                                       .arg(m_meshData->getNodes().size())
+                                       .arg(m_meshData->getElements().size()), 5000);
+        // 中途出错（而不是用户取消）时说明原因
+        if (!job->progress.isCancelled()) QMessageBox::critical(this, "Error", job->error);
+    }
+}
+
+bool MainWindow::confirmReplaceData()
+{
+    if (m_meshData->getNodes().empty()) return true;
+
+    QMessageBox::StandardButton reply;
+    reply = QMessageBox::question(this, "Import",
+                                  "Importing will clear current data. Continue?",
+                                  QMessageBox::Yes | QMessageBox::No);
+    return reply == QMessageBox::Yes;
+}
+
+void MainWindow::applyImportedData(MeshData& imported, const meshio::IoStats& stats)
+{
+    // 旧数据整体交换进撤销记录（不拷贝），导入后可以撤销回导入前的状态
+    m_history->push(std::make_unique<ReplaceDataCommand>("Import", imported));
 
-    // 5. 刷新 UI
-    m_nodeModel->refresh();
-    m_elemModel->refresh();
+    // 刷新 UI（表格随数据整体替换自动重置）
+    updateUndoActions();
 
     // 清除任何可能的高亮残留
     ui->view3D->setHighlightIndices({});
     ui->view3D->setHighlightElementIndices({});
-    ui->view3D->update();
-
-    ui->statusbar->showMessage("Data imported successfully!", 3000);
 
+    ui->statusbar->showMessage(QString("Data imported successfully! %1 nodes, %2 elements in %3 s (%4 MB/s)")
+                                   .arg(stats.nodes).arg(stats.elements)
+                                   .arg(stats.seconds, 0, 'f', 2)
+                                   .arg(stats.megabytesPerSecond(), 0, 'f', 0), 5000);
 }
+
 void MainWindow::on_actionExport_triggered()
 {
     // 1. 打开文件保存对话框
     QString fileName = QFileDialog::getSaveFileName(this,
-                                                    tr("Export Mesh"), "", tr("Text Files (*.txt);;All Files (*)"));
+                                                    tr("Export Mesh"), "", tr("Text Files (*.txt);;Compressed Text (*.txt.gz *.txt.zst);;All Files (*)"));
 
     if (fileName.isEmpty()) return; // 用户取消了
 
-    // 2. 打开文件准备写入
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Cannot write to file!");
+    // 2. 写入点和边数据（多线程格式化，数值无损）
+    meshio::IoStats stats;
+    QString error;
+    if (!meshio::exportText(fileName, *m_meshData, &stats, &error)) {
+        QMessageBox::critical(this, "Error", error);
         return;
     }
+    m_modelFile = fileName;
 
-    QTextStream out(&file);
+    ui->statusbar->showMessage(QString("Data exported successfully! %1 nodes, %2 elements in %3 s (%4 MB/s)")
+                                   .arg(stats.nodes).arg(stats.elements)
+                                   .arg(stats.seconds, 0, 'f', 2)
+                                   .arg(stats.megabytesPerSecond(), 0, 'f', 0), 3000);
+}
+void MainWindow::on_actionExportBinary_triggered()
+{
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Export Binary Mesh"), "", tr("Mesh Binary (*.mpb);;Compressed Mesh Binary (*.mpb.gz *.mpb.zst);;All Files (*)"));
 
-    // 3. 写入点数据
-    // 格式：NODE [ID] [X] [Y] [Z]
-    const auto& nodes = m_meshData->getNodes();
-    out << "# Mesh Data Export\n";
-    out << "# Format: NODE id x y z\n";
-    out << "NODES " << nodes.size() << "\n";
+    if (fileName.isEmpty()) return;
 
-    for (const auto& node : nodes) {
-        out << node.id << " "
-            << node.x << " " << node.y << " " << node.z << "\n";
+    meshio::IoStats stats;
+    QString error;
+    if (!meshio::exportBinary(fileName, *m_meshData, &stats, &error)) {
+        QMessageBox::critical(this, "Error", error);
+        return;
     }
+    m_modelFile = fileName;
+
+    ui->statusbar->showMessage(QString("Binary data exported successfully! %1 nodes, %2 elements in %3 s (%4 MB/s)")
+                                   .arg(stats.nodes).arg(stats.elements)
+                                   .arg(stats.seconds, 0, 'f', 2)
+                                   .arg(stats.megabytesPerSecond(), 0, 'f', 0), 3000);
+}
+void MainWindow::on_actionExportMeshFormat_triggered()
+{
+    const QString triangulated = tr("Wavefront OBJ, triangulated (*.obj)");
+    const QString triangulatedPly = tr("Stanford PLY, triangulated (*.ply)");
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Export OBJ/PLY/STL"), "",
+                                                    tr("Wavefront OBJ (*.obj)") + ";;" + triangulated + ";;"
+                                                        + tr("Stanford PLY (*.ply)") + ";;" + triangulatedPly + ";;"
+                                                        + tr("Binary STL (*.stl)"),
+                                                    &selectedFilter);
 
-    // 4. 写入边数据
-    // 格式：ELEM [ID] [TYPE] [START] [END]
-    const auto& elements = m_meshData->getElements();
-    out << "\n# Format: ELEM id type(0=Line,1=Arc) start_node end_node midX midY midZ\n";
-    out << "EDGES " << elements.size() << "\n";
-
-    for (const auto& elem : elements) {
-        out << elem.id << " "
-            << elem.type << " "
-            << elem.startNodeId << " " <<
-            elem.endNodeId  << " " <<
-            elem.midX << " " <<
-            elem.midY << " " <<
-            elem.midZ << "\n";
+    if (fileName.isEmpty()) return;
+
+    // 格式按扩展名决定，是否三角化按选择的过滤器决定
+    const bool triangulate = selectedFilter == triangulated || selectedFilter == triangulatedPly;
+    meshio::IoStats stats;
+    QString error;
+    if (!meshio::exportMeshFormat(fileName, *m_meshData, triangulate, &stats, &error)) {
+        QMessageBox::critical(this, "Error", error);
+        return;
     }
+    m_modelFile = fileName;
 
-    file.close();
-    ui->statusbar->showMessage("Data exported successfully!", 3000);
+    ui->statusbar->showMessage(QString("Data exported successfully! %1 nodes, %2 elements, %3 faces in %4 s (%5 MB/s)")
+                                   .arg(stats.nodes).arg(stats.elements).arg(m_meshData->getFaces().size())
+                                   .arg(stats.seconds, 0, 'f', 2)
+                                   .arg(stats.megabytesPerSecond(), 0, 'f', 0), 3000);
 }
 // 当点击“添加点”按钮时
 void MainWindow::on_btnAddPoint_clicked()
@@ -328,33 +675,82 @@ void MainWindow::on_btnAddPoint_clicked()
     double y = ui->spinY->value();
     double z = ui->spinZ->value();
 
-    // 2. 存入数据层
-    m_meshData->addNode(x, y, z);
+    // 2. 存入数据层（通过撤销记录执行）
+    m_history->push(std::make_unique<AddNodeCommand>(x, y, z));
 
-    // 3. 通知表格更新
-    m_nodeModel->refresh();
-    ui->view3D->update();
+    // 3. 表格和 3D 视图由 MeshData 的通知自动更新
+    updateUndoActions();
 
     // 4. (可选) 状态栏提示
     ui->statusbar->showMessage("Node Added!", 2000);
 }
 void MainWindow::on_btnMesh_clicked()
 {
-    // 1. 调用算法
-    m_meshData->generateFaces();
+    // 1. 模型没变或改回了算过的状态：直接取缓存（先内存，再模型文件旁的缓存文件）
+    const FaceCache::Key key = FaceCache::keyOf(*m_meshData);
+    std::vector<Face> faces;
+    bool cached = false;
+    if (const std::vector<Face>* hit = m_faceCache.find(key)) {
+        faces = *hit;
+        cached = true;
+    } else if (ui->actionSaveFaceCache->isChecked() && !m_modelFile.isEmpty()
+               && FaceCache::load(FaceCache::fileFor(m_modelFile), key, faces)) {
+        m_faceCache.insert(key, faces);
+        cached = true;
+    }
+    if (cached) {
+        // 还在算的旧请求不再需要
+        if (m_mesher->isBusy()) m_mesher->cancel();
+        const size_t faceCount = faces.size();
+        m_meshData->setFaces(faces);
+        ui->statusbar->showMessage(QString("Restored %1 faces from cache.").arg(faceCount), 5000);
+        return;
+    }
 
-    // 2. 获取结果数量进行反馈
-    int faceCount = m_meshData->getFaces().size();
+    // 2. 取快照交给后台线程；计算中再点一次会取消旧的，按最新数据重算
+    m_mesher->request(*m_meshData);
+}
 
-    if (faceCount > 0) {
-        ui->statusbar->showMessage(QString("Success! Generated %1 faces.").arg(faceCount), 5000);
+void MainWindow::onMeshingStarted()
+{
+    m_btnCancelMesh->show();
+    ui->statusbar->showMessage(tr("Meshing..."));
+}
+
+void MainWindow::onMeshingFinished(quint64 revision, int faceCount, double seconds)
+{
+    m_btnCancelMesh->hide();
 
-        // TODO: 下一步就是去 Plotter3D 里把 m_faces 画出来
-        ui->view3D->update();
+    // 计算期间数据被改过，面的点索引可能已经对不上，结果作废
+    if (revision != m_meshData->revision()) {
+        m_mesher->takeFaces();
+        ui->statusbar->showMessage(tr("Model changed while meshing. Click Mesh again."), 3000);
+        return;
+    }
+
+    // 3. 结果存入缓存，再一次性交换进数据，获取结果数量进行反馈
+    std::vector<Face> faces = m_mesher->takeFaces();
+    const FaceCache::Key key = FaceCache::keyOf(*m_meshData);
+    m_faceCache.insert(key, faces);
+    if (ui->actionSaveFaceCache->isChecked() && !m_modelFile.isEmpty()) {
+        QString error;
+        if (!FaceCache::save(FaceCache::fileFor(m_modelFile), key, faces, &error)) qWarning() << error;
+    }
+    m_meshData->setFaces(faces);
+
+    if (faceCount > 0) {
+        ui->statusbar->showMessage(QString("Success! Generated %1 faces in %2 s.")
+                                       .arg(faceCount).arg(seconds, 0, 'f', 2), 5000);
     } else {
         ui->statusbar->showMessage("No faces found. Check your closed loops.", 3000);
     }
 }
+
+void MainWindow::onMeshingStopped()
+{
+    m_btnCancelMesh->hide();
+    ui->statusbar->showMessage(tr("Meshing stopped."), 3000);
+}
 void MainWindow::on_btnDeletePoint_clicked()
 {
     int currentTab = ui->tabWidget->currentIndex();
@@ -372,34 +768,21 @@ void MainWindow::on_btnDeletePoint_clicked()
 
         QModelIndexList selectedRows = select->selectedRows();
 
-        // 1. 【关键】必须倒序排列！(从下往上删)
-        // 否则删了第2行，第3行就变成第2行了，后面的索引会全乱
-        std::sort(selectedRows.begin(), selectedRows.end(), [](const QModelIndex &a, const QModelIndex &b){
-            return a.row() > b.row(); // 降序：行号大的排前面
-        });
-
-        // 2. 循环删除
+        // 1. 收集行号，删除命令内部会倒序处理 (从下往上删)
+        // 每个点先删连接的线，再删点，ID 重排与原来一致，撤销时逆序恢复
+        std::vector<int> rows;
         for (const QModelIndex &idx : selectedRows) {
-            int row = idx.row();
-
-            // 获取要删除的点的 ID (此时 row 还是准确的)
-            int nodeId = ui->tableNodes->model()->data(ui->tableNodes->model()->index(row, 0)).toInt();
-
-            // A. 先删连接的线 (内部调用 removeElementAtIndex，保证线ID也连续)
-            m_meshData->removeElementsConnectedTo(nodeId);
-
-            // B. 再删点 (MeshData 内部会把 >nodeId 的所有点 ID 减 1)
-            m_nodeModel->removeRow(row);
+            rows.push_back(idx.row());
         }
 
-        // 3. 【核心修正】强制刷新所有表格
-        // 此时数据层 ID 已经变了(例如点4变成了点3)，必须告诉表格重新读取数据
-        m_nodeModel->refresh();
-        m_elemModel->refresh(); // 线的数据(连接关系)也变了，必须刷新
+        // 2. 执行删除
+        m_history->push(std::make_unique<RemoveNodesCommand>(rows));
+
+        // 3. 表格按 MeshData 的通知逐行移除；后面点的 ID 和线的端点随之更新
+        updateUndoActions();
 
         // 4. 清理 3D 视图
         ui->view3D->setHighlightIndices({}); // 清空高亮，防止错位
-        ui->view3D->update();
 
         ui->statusbar->showMessage("Nodes and connected lines deleted (IDs compacted).", 2000);
     }
@@ -412,24 +795,20 @@ void MainWindow::on_btnDeletePoint_clicked()
 
         QModelIndexList selectedRows = select->selectedRows();
 
-        // 1. 倒序排列
-        std::sort(selectedRows.begin(), selectedRows.end(), [](const QModelIndex &a, const QModelIndex &b){
-            return a.row() > b.row();
-        });
-
-        // 2. 循环删除
+        // 1. 收集行号 (命令内部倒序删除)
+        std::vector<int> rows;
         for (const QModelIndex &idx : selectedRows) {
-            // 调用 Element Model 的删除 (MeshData 内部会处理 ID 连续)
-            m_elemModel->removeRow(idx.row());
+            rows.push_back(idx.row());
         }
 
-        // 3. 【核心修正】强制刷新表格
-        // 同样的道理，删了线3，线4变成了线3，需要刷新显示
-        m_elemModel->refresh();
+        // 2. 执行删除 (MeshData 内部会处理 ID 连续)
+        m_history->push(std::make_unique<RemoveElementsCommand>(rows));
+
+        // 3. 删了线3，线4变成了线3：表格按通知移除行，后面的行号即新 ID
+        updateUndoActions();
 
         // 4. 清理 3D 视图
         ui->view3D->setHighlightElementIndices({});
-        ui->view3D->update();
 
         ui->statusbar->showMessage("Edges deleted (IDs compacted).", 2000);
     }
@@ -437,30 +816,19 @@ void MainWindow::on_btnDeletePoint_clicked()
 
 void MainWindow::onTableSelectionChanged()
 {
-    // 1. 获取所有选中行
-    QModelIndexList selectedRows = ui->tableNodes->selectionModel()->selectedRows();
-
-    // 2. 提取行号（索引）存入 vector
-    std::vector<int> selectedIndices;
-    for (const QModelIndex& idx : selectedRows) {
-        selectedIndices.push_back(idx.row());
-    }
-
-    // 3. 把这些索引传给 3D 视图
-    ui->view3D->setHighlightIndices(selectedIndices);
-    if (!selectedIndices.empty()) {
-        // blockSignals 是为了防止死循环 (A清除B -> B触发信号清除A -> A又清除B...)
-        // 虽然在这里逻辑上不会死循环，但是个好习惯
-        ui->tableElements->selectionModel()->blockSignals(true);
+    // 选中状态已经由 m_selection 增量更新，3D 视图直接查位图，这里只处理两张表的互斥
+    const int count = m_selection->nodes().count();
+    if (count > 0 && !m_selection->elements().isEmpty()) {
+        // 选了点就清掉线的选择（会触发 onElemTableSelectionChanged，那边此时点已选中、线为空，不会再回来清点）
         ui->tableElements->clearSelection();
-        ui->tableElements->selectionModel()->blockSignals(false);
-
+    }
+    if (count > 0) {
         // 同时手动清除 3D 里的线高亮
         ui->view3D->setHighlightElementIndices({});
     }
 
     // (调试用) 可以在状态栏显示选中了几个
-    ui->statusbar->showMessage(QString("Selected %1 nodes").arg(selectedIndices.size()));
+    ui->statusbar->showMessage(QString("Selected %1 nodes").arg(count));
 }
 
 void MainWindow::on_btnToggleLine_clicked()
@@ -509,39 +877,26 @@ void MainWindow::on_btnToggleArc_clicked()
 
 void MainWindow::onElemTableSelectionChanged()
 {
-    // 1. 获取线表格中被选中的所有行
-    QModelIndexList selectedRows = ui->tableElements->selectionModel()->selectedRows();
+    // 3D 视图按 m_selection 的位图高亮选中的线
 
-    // 2. 提取行号（也就是线的 Index）
-    std::vector<int> selectedIndices;
-    for (const QModelIndex& idx : selectedRows) {
-        selectedIndices.push_back(idx.row());
-    }
-
-    // 3. 告诉 3D 视图高亮这些线
-    ui->view3D->setHighlightElementIndices(selectedIndices);
-
-    // 4. (优化体验) 如果选中了线，最好把点的选中状态清除掉，避免视觉混乱
-    if (!selectedIndices.empty()) {
-        // 这行代码会触发 onTableSelectionChanged，从而自动清除 3D 点的高亮
+    // 如果选中了线，最好把点的选中状态清除掉，避免视觉混乱
+    if (!m_selection->elements().isEmpty() && !m_selection->nodes().isEmpty()) {
+        // 这行代码会触发 onTableSelectionChanged
         ui->tableNodes->clearSelection();
     }
 }
 
 void MainWindow::on_actionClear_triggered(){
     qDebug("clear data");
-    // 2. 清空底层数据
-    m_meshData->clearData();
+    // 2. 清空底层数据（整体交换进撤销记录，误操作可以撤销）
+    m_history->push(std::make_unique<ReplaceDataCommand>("Clear"));
+    updateUndoActions();
 
-    // 3. 刷新两个表格
-    // 我们的 Model 里的 refresh() 调用了 beginResetModel，所以表格会瞬间变空
-    m_nodeModel->refresh();
-    m_elemModel->refresh();
+    // 3. 数据整体替换时两个表格收到 dataReset，会瞬间变空
 
     // 4. 重置 3D 视图状态
     ui->view3D->setHighlightIndices({});
     ui->view3D->setHighlightElementIndices({});
-    ui->view3D->update(); // 重绘
 
     // 5. 重置主窗口内部逻辑变量
     m_startNodeId = -1;
@@ -549,3 +904,124 @@ void MainWindow::on_actionClear_triggered(){
     ui->statusbar->showMessage("Canvas cleared.", 2000);
 
 }
+
+void MainWindow::on_actionWeldNodes_triggered()
+{
+    if (m_meshData->getNodes().empty()) return;
+
+    bool ok = false;
+    const double tolerance = QInputDialog::getDouble(this, tr("Weld Coincident Nodes"),
+                                                     tr("Merge nodes closer than:"),
+                                                     meshweld::defaultTolerance(m_meshData->getNodes()),
+                                                     0.0, 1e300, 12, &ok);
+    if (!ok) return;
+
+    // 在副本上焊接，有改动时整体换进场景（一条撤销记录）
+    std::vector<Node> nodes = m_meshData->getNodes();
+    std::vector<Element> elements = m_meshData->getElements();
+    meshweld::WeldOptions options;
+    options.tolerance = tolerance;
+    const meshweld::WeldStats stats = meshweld::weld(nodes, elements, options);
+    if (!stats.changed()) {
+        ui->statusbar->showMessage(tr("Nothing to weld."), 3000);
+        return;
+    }
+
+    MeshData welded;
+    std::vector<Face> faces;
+    welded.swapData(nodes, elements, faces);
+    m_history->push(std::make_unique<ReplaceDataCommand>("Weld Nodes", welded));
+    updateUndoActions();
+    ui->view3D->setHighlightIndices({});
+    ui->view3D->setHighlightElementIndices({});
+    ui->statusbar->showMessage(weldSummary(stats), 8000);
+}
+
+void MainWindow::on_actionGenerateGrid_triggered()
+{
+    generateMesh(GenerateDialog::Grid);
+}
+
+void MainWindow::on_actionGenerateLattice_triggered()
+{
+    generateMesh(GenerateDialog::Lattice);
+}
+
+void MainWindow::on_actionGenerateCircle_triggered()
+{
+    generateMesh(GenerateDialog::Circle);
+}
+
+void MainWindow::on_actionGenerateRandom_triggered()
+{
+    generateMesh(GenerateDialog::RandomCloud);
+}
+
+void MainWindow::generateMesh(int kind)
+{
+    GenerateDialog dialog(static_cast<GenerateDialog::Kind>(kind), this);
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    meshgen::GeneratedMesh mesh = dialog.generate();
+    if (mesh.points.empty()) return;
+    const qsizetype nodes = static_cast<qsizetype>(mesh.points.size());
+    const qsizetype elements = static_cast<qsizetype>(mesh.elements.size());
+
+    // 整批追加只发一次通知，表格和 3D 视图各更新一次
+    m_history->push(std::make_unique<AppendMeshCommand>(dialog.commandText().toStdString(),
+                                                        std::move(mesh.points), std::move(mesh.elements)));
+    refreshAfterHistoryChange();
+    ui->statusbar->showMessage(tr("Generated %1 nodes, %2 elements in %3 s")
+                                   .arg(nodes).arg(elements)
+                                   .arg(timer.nsecsElapsed() / 1e9, 0, 'f', 2), 5000);
+}
+
+void MainWindow::on_actionUndo_triggered()
+{
+    if (!m_history->canUndo()) return;
+    QString text = QString::fromStdString(m_history->undoText());
+    m_history->undo();
+    refreshAfterHistoryChange();
+    ui->statusbar->showMessage(tr("Undo: %1").arg(text), 2000);
+}
+
+void MainWindow::on_actionRedo_triggered()
+{
+    if (!m_history->canRedo()) return;
+    QString text = QString::fromStdString(m_history->redoText());
+    m_history->redo();
+    refreshAfterHistoryChange();
+    ui->statusbar->showMessage(tr("Redo: %1").arg(text), 2000);
+}
+
+void MainWindow::refreshAfterHistoryChange()
+{
+    // 表格已经随撤销/重做的每一步改动更新，这里只处理界面状态
+    // 行号和 ID 可能都变了，高亮和连线/画弧的中间状态一律作废
+    m_startNodeId = -1;
+    m_arcNode1 = -1;
+    m_arcNode2 = -1;
+    ui->view3D->setHighlightIndices({});
+    ui->view3D->setHighlightElementIndices({});
+
+    updateUndoActions();
+}
+
+bool MainWindow::isStreamingImport() const
+{
+    return m_importJob && m_importJob->kind == ImportStreaming;
+}
+
+void MainWindow::updateUndoActions()
+{
+    // 流式导入期间始终禁用
+    const bool editable = !isStreamingImport();
+    ui->actionUndo->setEnabled(editable && m_history->canUndo());
+    ui->actionRedo->setEnabled(editable && m_history->canRedo());
+    ui->actionUndo->setText(m_history->canUndo()
+        ? tr("Undo %1").arg(QString::fromStdString(m_history->undoText())) : tr("Undo"));
+    ui->actionRedo->setText(m_history->canRedo()
+        ? tr("Redo %1").arg(QString::fromStdString(m_history->redoText())) : tr("Redo"));
+}
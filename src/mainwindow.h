@@ -2,12 +2,23 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QElapsedTimer>
+#include <memory>
 #include "meshdata.h"       // 引入
 #include "nodetablemodel.h" // 引入
 #include "elementtablemodel.h"
+#include "meshhistory.h"
+#include "meshio.h"
+#include "asyncmesher.h"
+#include "meshselection.h"
+#include "facecache.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
+class QProgressBar;
+class QPushButton;
+class QThread;
+class QTimer;
 QT_END_NAMESPACE
 
 class MainWindow : public QMainWindow
@@ -26,18 +37,81 @@ private slots:
     void onElemTableSelectionChanged();
     void on_btnToggleLine_clicked();
     void on_actionClear_triggered(); // 清屏
+    void on_actionGenerateGrid_triggered();
+    void on_actionGenerateLattice_triggered();
+    void on_actionGenerateCircle_triggered();
+    void on_actionGenerateRandom_triggered();
+    void on_actionWeldNodes_triggered();
     void on_actionExport_triggered();
     void on_btnToggleArc_clicked();
     void on_actionImport_triggered();
+    void on_actionExportBinary_triggered();
+    void on_actionImportBinary_triggered();
+    void on_actionMeshLargeBinary_triggered();
+    void on_actionImportStreaming_triggered();
+    void on_actionExportMeshFormat_triggered();
+    void on_actionImportMeshFormat_triggered();
     void on_btnMesh_clicked();
+    void on_actionUndo_triggered();
+    void on_actionRedo_triggered();
+
+    // 后台导入
+    void onImportFinished();
+    void onImportProgressTick();
+    void onCancelImport();
+
+    // 后台生成面
+    void onMeshingStarted();
+    void onMeshingFinished(quint64 revision, int faceCount, double seconds);
+    void onMeshingStopped();
 
 private:
+    // 导入前确认是否覆盖当前数据
+    bool confirmReplaceData();
+    // 用导入的数据替换当前场景（可撤销），并刷新界面
+    void applyImportedData(MeshData& imported, const meshio::IoStats& stats);
+    // 弹出生成参数对话框，确认后整批追加到场景（一条撤销记录）
+    void generateMesh(int kind);
+
+    // 在工作线程中把文件读进一个新的 MeshData，完成后回到界面线程交换进场景。
+    // MeshBinaryTiled 不读进场景：从文件分块生成面，结果写到 outputFileName
+    enum ImportKind { ImportText, ImportBinary, ImportStreaming, ImportMeshFormat, MeshBinaryTiled };
+    struct ImportJob;
+    void startImport(const QString& fileName, ImportKind kind, const QString& outputFileName = QString());
+    void setImportRunning(bool running);
+    // 正在流式导入（数据只能由导入追加，禁止一切编辑）
+    bool isStreamingImport() const;
+    // 流式导入：把排队的批次追加进场景，budgetMs < 0 表示全部追加；返回是否追加了数据
+    bool appendStreamedBatches(qint64 budgetMs);
+    void finishStreamingImport();
+
+    // 撤销/重做后刷新表格、视图和菜单状态
+    void refreshAfterHistoryChange();
+    void updateUndoActions();
+
     Ui::MainWindow *ui;
 
     // 核心成员变量
     MeshData *m_meshData;         // 数据中心
     NodeTableModel *m_nodeModel;  // 点表格
     ElementTableModel *m_elemModel; // 线表格
+    MeshSelection *m_selection;   // 两张表的选中状态（位图），3D 视图共用
+    MeshHistory *m_history;       // 撤销/重做记录
+
+    // 后台导入（同一时间只有一个）
+    std::unique_ptr<ImportJob> m_importJob;
+    QThread *m_importThread = nullptr;
+    QTimer *m_importTimer;        // 定时刷新进度条
+    QElapsedTimer m_importClock;
+    QProgressBar *m_importProgress;
+    QPushButton *m_btnCancelImport;
+
+    // 后台生成面
+    AsyncMesher *m_mesher;
+    QPushButton *m_btnCancelMesh;
+    // 生成面的结果缓存；m_modelFile 是最近导入/导出的模型文件，磁盘缓存存在它旁边
+    FaceCache m_faceCache;
+    QString m_modelFile;
     bool m_isLineMode = false; // 是否处于连线模式
     int m_startNodeId = -1;    // 连线的第一点 ID
 
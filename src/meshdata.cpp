@@ -1,8 +1,78 @@
 #include "meshdata.h"
 #include "geometry_utils.h"
-// #include <algorithm>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <QDebug>
 
+namespace {
+
+// 内容哈希：每个节点/单元按 (下标, 内容) 算一个 64 位值，全部相加。
+// 加法可以逐项撤销，改动一条记录只需减去旧值、加上新值
+inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t bitsOf(double v)
+{
+    uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+uint64_t nodeTerm(size_t index, const Node& n)
+{
+    uint64_t h = mix64(index + 0x9e3779b97f4a7c15ULL);
+    h = mix64(h ^ bitsOf(n.x));
+    h = mix64(h ^ bitsOf(n.y));
+    return mix64(h ^ bitsOf(n.z));
+}
+
+// 只包含参与生成面的字段：直线的 mid 不参与
+uint64_t elementTerm(size_t index, const Element& e)
+{
+    uint64_t h = mix64(index + 0xc2b2ae3d27d4eb4fULL);
+    h = mix64(h ^ (uint64_t(uint32_t(e.startNodeId)) | uint64_t(uint32_t(e.endNodeId)) << 32));
+    if (e.type == TYPE_ARC) {
+        h = mix64(h ^ 1);
+        h = mix64(h ^ bitsOf(e.midX));
+        h = mix64(h ^ bitsOf(e.midY));
+        h = mix64(h ^ bitsOf(e.midZ));
+    }
+    return h;
+}
+
+// 升序行号 rows 中去掉 removed（升序）里的行，其余行号前移
+void shiftRowsForRemoval(std::vector<int>& rows, const std::vector<int>& removed)
+{
+    size_t out = 0;
+    for (int row : rows) {
+        const auto it = std::lower_bound(removed.begin(), removed.end(), row);
+        if (it != removed.end() && *it == row) continue;
+        rows[out++] = row - static_cast<int>(it - removed.begin());
+    }
+    rows.resize(out);
+}
+
+// 插入若干行（inserted 为插入后的行号，升序）后，升序行号 rows 相应后移
+void shiftRowsForInsertion(std::vector<int>& rows, const std::vector<int>& inserted)
+{
+    size_t j = 0;
+    for (int& row : rows) {
+        while (j < inserted.size() && inserted[j] <= row + static_cast<int>(j)) ++j;
+        row += static_cast<int>(j);
+    }
+}
+
+} // namespace
+
 MeshData::MeshData() {}
 
 int MeshData::addNode(double x, double y, double z) {
@@ -10,6 +80,10 @@ int MeshData::addNode(double x, double y, double z) {
     n.id = m_nextNodeId++; // ID 从 0 开始
     n.x = x; n.y = y; n.z = z;
     m_nodes.push_back(n);
+    m_contentHash += nodeTerm(m_nodes.size() - 1, n);
+    resolvePendingArcs();
+    ++m_revision;
+    recordRows(m_pending.nodes, true, n.id, n.id);
     return n.id;
 }
 void MeshData::removeNodeAtIndex(int index)
@@ -19,7 +93,8 @@ void MeshData::removeNodeAtIndex(int index)
     // 1. 获取即将被删除的点的 ID
     int deletedId = m_nodes[index].id;
 
-    // 2. 删除该点
+    // 2. 删除该点（之后的点下标都减 1，哈希先减去旧值）
+    for (size_t i = index; i < m_nodes.size(); ++i) m_contentHash -= nodeTerm(i, m_nodes[i]);
     m_nodes.erase(m_nodes.begin() + index);
 
     // 3. 【关键】重排序：遍历剩下的点，所有 ID > deletedId 的都减 1
@@ -28,21 +103,33 @@ void MeshData::removeNodeAtIndex(int index)
             node.id--;
         }
     }
+    for (size_t i = index; i < m_nodes.size(); ++i) m_contentHash += nodeTerm(i, m_nodes[i]);
 
     // 4. 【关键】更新线：遍历所有线，更新它们引用的节点 ID
     // 因为所有大于 deletedId 的节点 ID 都变了，线里面存的 ID 也要跟着变
-    for (auto& elem : m_elements) {
+    int firstChanged = -1, lastChanged = -1;
+    for (size_t i = 0; i < m_elements.size(); ++i) {
+        auto& elem = m_elements[i];
+        if (elem.startNodeId <= deletedId && elem.endNodeId <= deletedId) continue;
+        m_contentHash -= elementTerm(i, elem);
         if (elem.startNodeId > deletedId) {
             elem.startNodeId--;
         }
         if (elem.endNodeId > deletedId) {
             elem.endNodeId--;
         }
+        m_contentHash += elementTerm(i, elem);
+        if (firstChanged < 0) firstChanged = static_cast<int>(i);
+        lastChanged = static_cast<int>(i);
     }
 
     // 5. 更新 ID 计数器
     // 因为 ID 是连续的，所以下一个 ID 就是当前的 size
     m_nextNodeId = m_nodes.size();
+    ++m_revision;
+    dropFaces();
+    recordElementsModified(firstChanged, lastChanged);
+    recordRows(m_pending.nodes, false, index, index);
 }
 void MeshData::removeElementsConnectedTo(int nodeId)
 {
@@ -64,6 +151,9 @@ int MeshData::addLine(int startNodeId, int endNodeId) {
     e.endNodeId = endNodeId;
     // 直线不需要 mid 坐标，设为0即可
     m_elements.push_back(e);
+    m_contentHash += elementTerm(m_elements.size() - 1, e);
+    ++m_revision;
+    recordRows(m_pending.elements, true, e.id, e.id);
     return e.id;
 }
 
@@ -73,7 +163,11 @@ void MeshData::removeElementAtIndex(int index)
 
     int deletedId = m_elements[index].id;
 
+    // 之后的线下标都减 1，哈希先减去旧值
+    for (size_t i = index; i < m_elements.size(); ++i) m_contentHash -= elementTerm(i, m_elements[i]);
     m_elements.erase(m_elements.begin() + index);
+    for (size_t i = index; i < m_elements.size(); ++i) m_contentHash += elementTerm(i, m_elements[i]);
+    if (!m_pendingArcs.empty()) shiftRowsForRemoval(m_pendingArcs, {index});
 
     // 重排序剩余的线
     for (auto& elem : m_elements) {
@@ -84,8 +178,267 @@ void MeshData::removeElementAtIndex(int index)
 
     // 更新线 ID 计数器
     m_nextElementId = m_elements.size();
+    ++m_revision;
+    dropFaces();
+    recordRows(m_pending.elements, false, index, index);
+}
+
+void MeshData::removeRows(const std::vector<int>& nodeRows, const std::vector<int>& elementRows)
+{
+    for (const auto* rows : {&nodeRows, &elementRows}) {
+        const size_t size = rows == &nodeRows ? m_nodes.size() : m_elements.size();
+        for (size_t k = 0; k < rows->size(); ++k) {
+            const int row = (*rows)[k];
+            if (row < 0 || static_cast<size_t>(row) >= size || (k > 0 && row <= (*rows)[k - 1])) return;
+        }
+    }
+    if (nodeRows.empty() && elementRows.empty()) return;
+    UpdateScope scope(*this);
+    dropFaces();
+
+    // 1. 先删线（与逐个删除时的通知顺序一致）：之后的线前移，ID 即新下标
+    if (!elementRows.empty()) {
+        const size_t firstRow = elementRows.front();
+        for (size_t i = firstRow; i < m_elements.size(); ++i) m_contentHash -= elementTerm(i, m_elements[i]);
+        size_t out = firstRow;
+        size_t k = 0;
+        for (size_t i = firstRow; i < m_elements.size(); ++i) {
+            if (k < elementRows.size() && static_cast<size_t>(elementRows[k]) == i) {
+                ++k;
+                continue;
+            }
+            m_elements[out] = m_elements[i];
+            m_elements[out].id = static_cast<int>(out);
+            ++out;
+        }
+        m_elements.resize(out);
+        for (size_t i = firstRow; i < out; ++i) m_contentHash += elementTerm(i, m_elements[i]);
+        if (!m_pendingArcs.empty()) shiftRowsForRemoval(m_pendingArcs, elementRows);
+        m_nextElementId = static_cast<int>(out);
+        ++m_revision;
+        recordRowRuns(m_pending.elements, false, elementRows);
+    }
+
+    // 2. 再删点，记下每个原 ID 的新 ID，一遍改完所有线的端点
+    if (!nodeRows.empty()) {
+        const size_t oldCount = m_nodes.size();
+        const size_t firstRow = nodeRows.front();
+        const int removed = static_cast<int>(nodeRows.size());
+        for (size_t i = firstRow; i < oldCount; ++i) m_contentHash -= nodeTerm(i, m_nodes[i]);
+        // newIds[i - firstRow]：原 ID i 的新 ID。被删的点取下一个保留点的 ID，与逐个删除时的结果一致
+        std::vector<int> newIds(oldCount - firstRow);
+        size_t out = firstRow;
+        size_t k = 0;
+        for (size_t i = firstRow; i < oldCount; ++i) {
+            newIds[i - firstRow] = static_cast<int>(out);
+            if (k < nodeRows.size() && static_cast<size_t>(nodeRows[k]) == i) {
+                ++k;
+                continue;
+            }
+            m_nodes[out] = m_nodes[i];
+            m_nodes[out].id = static_cast<int>(out);
+            ++out;
+        }
+        m_nodes.resize(out);
+        for (size_t i = firstRow; i < out; ++i) m_contentHash += nodeTerm(i, m_nodes[i]);
+
+        auto remap = [&](int id) {
+            if (id < static_cast<int>(firstRow)) return id;
+            return static_cast<size_t>(id) < oldCount ? newIds[id - firstRow] : id - removed;
+        };
+        int firstChanged = -1, lastChanged = -1;
+        for (size_t i = 0; i < m_elements.size(); ++i) {
+            auto& elem = m_elements[i];
+            if (elem.startNodeId < static_cast<int>(firstRow) && elem.endNodeId < static_cast<int>(firstRow)) continue;
+            m_contentHash -= elementTerm(i, elem);
+            elem.startNodeId = remap(elem.startNodeId);
+            elem.endNodeId = remap(elem.endNodeId);
+            m_contentHash += elementTerm(i, elem);
+            if (firstChanged < 0) firstChanged = static_cast<int>(i);
+            lastChanged = static_cast<int>(i);
+        }
+
+        m_nextNodeId = static_cast<int>(out);
+        ++m_revision;
+        recordElementsModified(firstChanged, lastChanged);
+        recordRowRuns(m_pending.nodes, false, nodeRows);
+    }
 }
 
+void MeshData::insertRows(const std::vector<std::pair<int, Node>>& nodes,
+                          const std::vector<std::pair<int, Element>>& elements)
+{
+    // 行号必须升序且落在插回后的范围内
+    for (size_t k = 0; k < nodes.size(); ++k) {
+        const int row = nodes[k].first;
+        if (row < 0 || static_cast<size_t>(row) >= m_nodes.size() + nodes.size()
+            || (k > 0 && row <= nodes[k - 1].first)) return;
+    }
+    for (size_t k = 0; k < elements.size(); ++k) {
+        const int row = elements[k].first;
+        if (row < 0 || static_cast<size_t>(row) >= m_elements.size() + elements.size()
+            || (k > 0 && row <= elements[k - 1].first)) return;
+    }
+    if (nodes.empty() && elements.empty()) return;
+    UpdateScope scope(*this);
+    dropFaces();
+
+    // 1. 先插点：从后往前原地归并，记下每个原 ID 的新 ID，一遍改完现有线的端点
+    if (!nodes.empty()) {
+        const size_t oldCount = m_nodes.size();
+        const size_t firstRow = nodes.front().first;
+        const int inserted = static_cast<int>(nodes.size());
+        for (size_t i = firstRow; i < oldCount; ++i) m_contentHash -= nodeTerm(i, m_nodes[i]);
+        std::vector<int> newIds(oldCount - firstRow); // newIds[i - firstRow]：原 ID i 的新 ID
+        m_nodes.resize(oldCount + nodes.size());
+        size_t src = oldCount;
+        size_t k = nodes.size();
+        for (size_t dst = m_nodes.size(); dst-- > firstRow;) {
+            if (k > 0 && static_cast<size_t>(nodes[k - 1].first) == dst) {
+                m_nodes[dst] = nodes[--k].second;
+            } else {
+                m_nodes[dst] = m_nodes[--src];
+                newIds[src - firstRow] = static_cast<int>(dst);
+            }
+            m_nodes[dst].id = static_cast<int>(dst);
+        }
+        for (size_t i = firstRow; i < m_nodes.size(); ++i) m_contentHash += nodeTerm(i, m_nodes[i]);
+
+        auto remap = [&](int id) {
+            if (id < static_cast<int>(firstRow)) return id;
+            return static_cast<size_t>(id) < oldCount ? newIds[id - firstRow] : id + inserted;
+        };
+        int firstChanged = -1, lastChanged = -1;
+        for (size_t i = 0; i < m_elements.size(); ++i) {
+            auto& elem = m_elements[i];
+            if (elem.startNodeId < static_cast<int>(firstRow) && elem.endNodeId < static_cast<int>(firstRow)) continue;
+            m_contentHash -= elementTerm(i, elem);
+            elem.startNodeId = remap(elem.startNodeId);
+            elem.endNodeId = remap(elem.endNodeId);
+            m_contentHash += elementTerm(i, elem);
+            if (firstChanged < 0) firstChanged = static_cast<int>(i);
+            lastChanged = static_cast<int>(i);
+        }
+
+        m_nextNodeId = static_cast<int>(m_nodes.size());
+        ++m_revision;
+        // 修改区间是插线之前的行号，随后记录的插线会把它后移
+        recordElementsModified(firstChanged, lastChanged);
+        std::vector<int> rows;
+        rows.reserve(nodes.size());
+        for (const auto& n : nodes) rows.push_back(n.first);
+        recordRowRuns(m_pending.nodes, true, rows);
+    }
+
+    // 2. 再插线。插回的线带着删除时的弧线几何量（端点也一起回来了），不用重算；
+    //    删除时还在等端点的弧线（圆心为 NaN）再试一次
+    if (!elements.empty()) {
+        const size_t oldCount = m_elements.size();
+        const size_t firstRow = elements.front().first;
+        std::vector<int> rows;
+        rows.reserve(elements.size());
+        for (const auto& e : elements) rows.push_back(e.first);
+        std::vector<int> unresolved;
+        for (size_t i = firstRow; i < oldCount; ++i) m_contentHash -= elementTerm(i, m_elements[i]);
+        m_elements.resize(oldCount + elements.size());
+        size_t src = oldCount;
+        size_t k = elements.size();
+        for (size_t dst = m_elements.size(); dst-- > firstRow;) {
+            if (k > 0 && static_cast<size_t>(elements[k - 1].first) == dst) {
+                m_elements[dst] = elements[--k].second;
+                const Element& e = m_elements[dst];
+                if (e.type == TYPE_ARC && !std::isfinite(e.arc.center[0])) unresolved.push_back(static_cast<int>(dst));
+            } else {
+                m_elements[dst] = m_elements[--src];
+            }
+            m_elements[dst].id = static_cast<int>(dst);
+        }
+        for (size_t i = firstRow; i < m_elements.size(); ++i) m_contentHash += elementTerm(i, m_elements[i]);
+        if (!m_pendingArcs.empty()) shiftRowsForInsertion(m_pendingArcs, rows);
+        if (!unresolved.empty()) {
+            std::reverse(unresolved.begin(), unresolved.end());
+            updateArcGeometry(unresolved);
+        }
+
+        m_nextElementId = static_cast<int>(m_elements.size());
+        ++m_revision;
+        recordRowRuns(m_pending.elements, true, rows);
+    }
+}
+
+void MeshData::appendNodes(const std::vector<std::array<double, 3>>& points)
+{
+    if (points.empty()) return;
+    const int first = static_cast<int>(m_nodes.size());
+    for (const auto& p : points) {
+        m_nodes.push_back({m_nextNodeId++, p[0], p[1], p[2]});
+        m_contentHash += nodeTerm(m_nodes.size() - 1, m_nodes.back());
+    }
+    resolvePendingArcs();
+    ++m_revision;
+    recordRows(m_pending.nodes, true, first, static_cast<int>(m_nodes.size()) - 1);
+}
+
+void MeshData::appendElements(const std::vector<Element>& elements, int nodeOffset)
+{
+    if (elements.empty()) return;
+    const int first = static_cast<int>(m_elements.size());
+    for (Element e : elements) {
+        e.id = m_nextElementId++;
+        e.startNodeId += nodeOffset;
+        e.endNodeId += nodeOffset;
+        if (e.type != TYPE_ARC) {
+            e.type = TYPE_LINE;
+            e.midX = e.midY = e.midZ = 0.0;
+        }
+        m_elements.push_back(e);
+        m_contentHash += elementTerm(m_elements.size() - 1, e);
+    }
+    updateArcGeometry(first, m_elements.size());
+    ++m_revision;
+    recordRows(m_pending.elements, true, first, static_cast<int>(m_elements.size()) - 1);
+}
+
+void MeshData::truncate(size_t nodeCount, size_t elementCount)
+{
+    // 先删线再删点，与逐个删除时的通知顺序一致
+    if (elementCount < m_elements.size()) {
+        const int first = static_cast<int>(elementCount);
+        const int last = static_cast<int>(m_elements.size()) - 1;
+        for (size_t i = elementCount; i < m_elements.size(); ++i) m_contentHash -= elementTerm(i, m_elements[i]);
+        m_elements.resize(elementCount);
+        m_pendingArcs.erase(std::lower_bound(m_pendingArcs.begin(), m_pendingArcs.end(), first), m_pendingArcs.end());
+        m_nextElementId = static_cast<int>(elementCount);
+        ++m_revision;
+        dropFaces();
+        recordRows(m_pending.elements, false, first, last);
+    }
+    if (nodeCount < m_nodes.size()) {
+        const int first = static_cast<int>(nodeCount);
+        const int last = static_cast<int>(m_nodes.size()) - 1;
+        for (size_t i = nodeCount; i < m_nodes.size(); ++i) m_contentHash -= nodeTerm(i, m_nodes[i]);
+        m_nodes.resize(nodeCount);
+        m_nextNodeId = static_cast<int>(nodeCount);
+        ++m_revision;
+        dropFaces();
+        recordRows(m_pending.nodes, false, first, last);
+    }
+}
+
+void MeshData::swapData(std::vector<Node>& nodes, std::vector<Element>& elements, std::vector<Face>& faces)
+{
+    m_nodes.swap(nodes);
+    m_elements.swap(elements);
+    m_faces.swap(faces);
+    m_nextNodeId = m_nodes.size();
+    m_nextElementId = m_elements.size();
+    rehashContent();
+    // 导入、焊接等整体替换的数据里弧线几何量没有算过（或端点已经移动），全部重算
+    m_pendingArcs.clear();
+    updateArcGeometry(0, m_elements.size());
+    ++m_revision;
+    recordReset();
+}
 
 int MeshData::addArc(int startNodeId, int endNodeId, double midX, double midY, double midZ) {
     Element e;
@@ -97,54 +450,73 @@ int MeshData::addArc(int startNodeId, int endNodeId, double midX, double midY, d
     e.midY = midY;
     e.midZ = midZ;
     m_elements.push_back(e);
+    updateArcGeometry(m_elements.size() - 1, m_elements.size());
+    m_contentHash += elementTerm(m_elements.size() - 1, e);
+    ++m_revision;
+    recordRows(m_pending.elements, true, e.id, e.id);
     return e.id;
 }
-void MeshData::generateFaces()
+void MeshData::fillMeshingInput(MeshingInput& input) const
 {
     // --- 1. 准备数据 (Data Adapting) ---
+    // clear 后保留容量，反复调用不重新分配
 
     // A. 转换点数据
-    std::vector<std::array<double, 3>> input_points;
-    input_points.reserve(m_nodes.size());
+    input.points.clear();
+    input.points.reserve(m_nodes.size());
 
     for (const auto& node : m_nodes) {
-        input_points.push_back({node.x, node.y, node.z});
+        input.points.push_back({node.x, node.y, node.z});
     }
 
     // B. 转换边数据
-    std::vector<std::array<int, 3>> input_edges;
-    std::vector<std::array<double, 3>> input_edges_info;
+    input.edges.clear();
+    input.edgesInfo.clear();
+    input.arcs.clear();
 
-    input_edges.reserve(m_elements.size());
-    input_edges_info.reserve(m_elements.size());
+    input.edges.reserve(m_elements.size());
+    input.edgesInfo.reserve(m_elements.size());
 
     for (const auto& elem : m_elements) {
         // 构造 edges 参数: [start, end, isArc]
         int isArc = (elem.type == TYPE_ARC) ? 1 : 0;
-        input_edges.push_back({elem.startNodeId, elem.endNodeId, isArc});
+        input.edges.push_back({elem.startNodeId, elem.endNodeId, isArc});
 
-        // 构造 edges_info 参数: [midX, midY, midZ] (直线填0)
+        // 构造 edges_info 参数: [midX, midY, midZ] (直线填0)，弧线另附算好的几何量
         if (isArc) {
-            input_edges_info.push_back({elem.midX, elem.midY, elem.midZ});
+            input.edgesInfo.push_back({elem.midX, elem.midY, elem.midZ});
+            input.arcs.push_back(elem.arc);
         } else {
-            input_edges_info.push_back({0.0, 0.0, 0.0});
+            input.edgesInfo.push_back({0.0, 0.0, 0.0});
         }
     }
+}
 
+bool MeshData::computeFaces(const MeshingInput& input, cgal_tools::MeshingWorkspace& workspace,
+                            std::vector<Face>& faces)
+{
     // --- 2. 调用第三方库 ---
     // 使用 try-catch 防止库内部崩溃导致软件闪退
     try {
-        auto result = cgal_tools::reconstruct_meshes(input_points, input_edges, input_edges_info);
-
-        // --- 3. 解析结果存回 MeshData ---
-        m_faces.clear();
+        // 弧线的圆心、弓形面积直接用快照里算好的，与绘制用的是同一份
+        workspace.set_arc_geometry(&input.arcs);
+        cgal_tools::reconstruct_meshes(input.points, input.edges, input.edgesInfo, workspace);
+        workspace.set_arc_geometry(nullptr);
+        if (workspace.cancelled()) return false;
 
-        const auto& result_indices = result.first;      // 面包含的点索引
-        const auto& result_props = result.second;       // 面的属性
+        // --- 3. 解析结果 ---
+        const auto& offsets = workspace.face_offsets();       // 面包含的点索引 (CSR)
+        const auto& indices = workspace.face_indices();
+        const auto& edgeIndices = workspace.face_edges();     // 面经过的边，与 indices 一一对应
+        const auto& result_props = workspace.face_properties(); // 面的属性
+        size_t faceCount = workspace.face_count();
 
-        for (size_t i = 0; i < result_indices.size(); ++i) {
-            Face face;
-            face.nodeIndices = result_indices[i]; // 拷贝 vector<int>
+        // resize 而不是 clear，已有 Face 的 nodeIndices / edgeIndices 容量可以复用
+        faces.resize(faceCount);
+        for (size_t i = 0; i < faceCount; ++i) {
+            Face& face = faces[i];
+            face.nodeIndices.assign(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+            face.edgeIndices.assign(edgeIndices.begin() + offsets[i], edgeIndices.begin() + offsets[i + 1]);
 
             // 拷贝属性
             if (i < result_props.size()) {
@@ -153,16 +525,31 @@ void MeshData::generateFaces()
                 face.centerY = result_props[i].center_y;
                 face.centerZ = result_props[i].center_z;
             }
-
-            m_faces.push_back(face);
         }
+        return true;
 
     } catch (const std::exception& e) {
+        workspace.set_arc_geometry(nullptr);
         // 可以在这里打印日志
         qDebug() << "Error in mesh reconstruction:" << e.what();
     } catch (...) {
+        workspace.set_arc_geometry(nullptr);
         qDebug() << "Unknown error in mesh reconstruction.";
     }
+    return false;
+}
+
+void MeshData::generateFaces()
+{
+    fillMeshingInput(m_meshInput);
+    computeFaces(m_meshInput, m_meshWorkspace, m_faces);
+    recordFacesChanged();
+}
+
+void MeshData::setFaces(std::vector<Face>& faces)
+{
+    m_faces.swap(faces);
+    recordFacesChanged();
 }
 
 const std::vector<Node>& MeshData::getNodes() const {
@@ -173,6 +560,12 @@ const std::vector<Element>& MeshData::getElements() const {
     return m_elements;
 }
 
+void MeshData::reserve(size_t nodeCount, size_t elementCount)
+{
+    m_nodes.reserve(nodeCount);
+    m_elements.reserve(elementCount);
+}
+
 void MeshData::clearData(){
     // qDebug("clear data");
     m_nodes.clear();
@@ -180,4 +573,202 @@ void MeshData::clearData(){
     m_faces.clear();
     m_nextNodeId = 0;
     m_nextElementId = 0;
+    m_contentHash = 0;
+    m_pendingArcs.clear();
+    ++m_revision;
+    recordReset();
+}
+
+void MeshData::updateArcGeometry(const std::vector<int>& rows, int* changedFirst, int* changedLast)
+{
+    std::vector<cgal_tools::ArcPoints> points;
+    std::vector<int> computed;
+    const size_t pendingBefore = m_pendingArcs.size();
+    for (int row : rows) {
+        Element& e = m_elements[row];
+        if (e.type != TYPE_ARC) continue;
+        const Node* a = findNode(e.startNodeId);
+        const Node* b = findNode(e.endNodeId);
+        if (!a || !b) {
+            e.arc = cgal_tools::ArcGeometry();
+            e.arc.center.fill(std::numeric_limits<double>::quiet_NaN());
+            m_pendingArcs.push_back(row);
+            continue;
+        }
+        points.push_back({{a->x, a->y, a->z}, {b->x, b->y, b->z}, {e.midX, e.midY, e.midZ}});
+        computed.push_back(row);
+    }
+    // 新的待算行可能落在已有的之间（插回时）
+    if (pendingBefore > 0 && m_pendingArcs.size() > pendingBefore
+        && m_pendingArcs[pendingBefore - 1] > m_pendingArcs[pendingBefore]) {
+        std::inplace_merge(m_pendingArcs.begin(), m_pendingArcs.begin() + pendingBefore, m_pendingArcs.end());
+    }
+    if (computed.empty()) return;
+
+    std::vector<cgal_tools::ArcGeometry> geometry;
+    cgal_tools::compute_arc_geometry(points, geometry);
+    for (size_t k = 0; k < computed.size(); ++k) {
+        m_elements[computed[k]].arc = geometry[k];
+    }
+    if (changedFirst) *changedFirst = computed.front();
+    if (changedLast) *changedLast = computed.back();
+}
+
+void MeshData::updateArcGeometry(size_t first, size_t last)
+{
+    std::vector<int> rows;
+    for (size_t i = first; i < last; ++i) {
+        if (m_elements[i].type == TYPE_ARC) rows.push_back(static_cast<int>(i));
+    }
+    if (!rows.empty()) updateArcGeometry(rows);
+}
+
+void MeshData::resolvePendingArcs()
+{
+    // 先到的弧线等到端点齐了再算；只看待算的行，端点仍缺的重新放回
+    if (m_pendingArcs.empty()) return;
+    std::vector<int> rows;
+    rows.swap(m_pendingArcs);
+    int changedFirst = -1, changedLast = -1;
+    updateArcGeometry(rows, &changedFirst, &changedLast);
+    recordElementsModified(changedFirst, changedLast);
+}
+
+void MeshData::rehashContent()
+{
+    uint64_t h = 0;
+    for (size_t i = 0; i < m_nodes.size(); ++i) h += nodeTerm(i, m_nodes[i]);
+    for (size_t i = 0; i < m_elements.size(); ++i) h += elementTerm(i, m_elements[i]);
+    m_contentHash = h;
+}
+
+void MeshData::addObserver(MeshDataObserver* observer)
+{
+    if (std::find(m_observers.begin(), m_observers.end(), observer) == m_observers.end()) {
+        m_observers.push_back(observer);
+    }
+}
+
+void MeshData::removeObserver(MeshDataObserver* observer)
+{
+    m_observers.erase(std::remove(m_observers.begin(), m_observers.end(), observer), m_observers.end());
+}
+
+// 合并后的区间超过这个数就改为整体 reset（对表格来说逐段增删已经比重置更慢）
+constexpr size_t kMaxPendingRanges = 256;
+
+void MeshData::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void MeshData::endUpdate()
+{
+    if (m_updateDepth > 0 && --m_updateDepth == 0) flushChanges();
+}
+
+void MeshData::recordRows(std::vector<MeshRowRange>& list, bool inserted, int first, int last)
+{
+    if (!m_pending.reset) {
+        const int count = last - first + 1;
+
+        if (&list == &m_pending.elements && m_pending.elementsModifiedFirst >= 0) {
+            // 已记下的修改区间跟着行的增删移动（保守地只扩不缩）
+            int& mf = m_pending.elementsModifiedFirst;
+            int& ml = m_pending.elementsModifiedLast;
+            if (inserted) {
+                if (first <= mf) { mf += count; ml += count; }
+                else if (first <= ml) { ml += count; }
+            } else {
+                if (last < mf) { mf -= count; ml -= count; }
+                else if (first <= ml) { mf = std::min(mf, first); ml = std::max(mf, ml - count); }
+            }
+        }
+
+        MeshRowRange* prev = list.empty() ? nullptr : &list.back();
+        if (prev && prev->inserted == inserted && inserted && first == prev->last + 1) {
+            // 连续追加
+            prev->last = last;
+        } else if (prev && prev->inserted == inserted && !inserted && last + 1 == prev->first) {
+            // 从下往上删除相邻的行
+            prev->first = first;
+        } else if (prev && prev->inserted == inserted && !inserted && first == prev->first) {
+            // 在同一位置反复删除
+            prev->last += count;
+        } else {
+            list.push_back({inserted, first, last});
+        }
+        if (m_pending.nodes.size() + m_pending.elements.size() > kMaxPendingRanges) m_pending.reset = true;
+    }
+    if (m_updateDepth == 0) flushChanges();
+}
+
+void MeshData::recordRowRuns(std::vector<MeshRowRange>& list, bool inserted, const std::vector<int>& rows)
+{
+    if (rows.empty()) return;
+    if (inserted) {
+        for (size_t k = 0; k < rows.size();) {
+            size_t end = k + 1;
+            while (end < rows.size() && rows[end] == rows[end - 1] + 1) ++end;
+            recordRows(list, true, rows[k], rows[end - 1]);
+            k = end;
+        }
+    } else {
+        for (size_t end = rows.size(); end > 0;) {
+            size_t k = end - 1;
+            while (k > 0 && rows[k - 1] + 1 == rows[k]) --k;
+            recordRows(list, false, rows[k], rows[end - 1]);
+            end = k;
+        }
+    }
+}
+
+void MeshData::recordElementsModified(int first, int last)
+{
+    if (first >= 0 && !m_pending.reset) {
+        if (m_pending.elementsModifiedFirst < 0) {
+            m_pending.elementsModifiedFirst = first;
+            m_pending.elementsModifiedLast = last;
+        } else {
+            m_pending.elementsModifiedFirst = std::min(m_pending.elementsModifiedFirst, first);
+            m_pending.elementsModifiedLast = std::max(m_pending.elementsModifiedLast, last);
+        }
+    }
+    // 总是和行的增删一起出现，由随后的 recordRows 发出
+}
+
+void MeshData::dropFaces()
+{
+    if (m_faces.empty()) return;
+    m_faces.clear();
+    m_pending.facesChanged = true;
+}
+
+void MeshData::recordFacesChanged()
+{
+    m_pending.facesChanged = true;
+    if (m_updateDepth == 0) flushChanges();
+}
+
+void MeshData::recordReset()
+{
+    m_pending.reset = true;
+    if (m_updateDepth == 0) flushChanges();
+}
+
+void MeshData::flushChanges()
+{
+    if (m_pending.empty()) return;
+
+    MeshChangeSet changes;
+    std::swap(changes, m_pending);
+    if (changes.reset) {
+        changes.nodes.clear();
+        changes.elements.clear();
+        changes.elementsModifiedFirst = changes.elementsModifiedLast = -1;
+        changes.facesChanged = true;
+    }
+    // 回调里可能再改数据（会开始新的一轮通知），先拷贝一份监听者列表
+    const std::vector<MeshDataObserver*> observers = m_observers;
+    for (MeshDataObserver* o : observers) o->meshChanged(changes);
 }
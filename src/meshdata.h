@@ -2,6 +2,10 @@
 #define MESHDATA_H
 
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include "geometry_utils.h"
 
 
 enum ElementType {
@@ -16,6 +20,7 @@ struct Node {
 
 struct Face {
     std::vector<int> nodeIndices; // 面的组成点索引
+    std::vector<int> edgeIndices; // 第 i 个点到下一个点经过的单元索引，与 nodeIndices 一一对应（从文件读入的面可能为空）
     double area;
     double centerX, centerY, centerZ;
 };
@@ -32,7 +37,48 @@ struct Element {
     double midY = 0.0;
     double midZ = 0.0;
 
-    // double centerX, centerY, centerZ;
+    // 弧线的圆心、半径、圆心角等，由 MeshData 在弧线加入（或整体替换）时按两端点和中间点算好，
+    // 绘制、拾取、生成面都直接使用。直线不使用
+    cgal_tools::ArcGeometry arc;
+};
+
+// 生成面的输入快照（纯数据，可以交给工作线程）
+struct MeshingInput {
+    std::vector<std::array<double, 3>> points;    // [x, y, z]
+    std::vector<std::array<int, 3>> edges;        // [start, end, isArc]
+    std::vector<std::array<double, 3>> edgesInfo; // 弧线中间点，直线为 0
+    std::vector<cgal_tools::ArcGeometry> arcs;    // 弧线的几何量，按 edges 中弧线的顺序
+};
+
+// 一段连续行的增删（改动发生时的行号，即下标，闭区间）
+struct MeshRowRange {
+    bool inserted; // false 为删除
+    int first;
+    int last;
+};
+
+// 一次变化通知。事务内的多次改动合并成一个 MeshChangeSet：
+// 同一张表上相邻的增删合并成一个区间，区间太多时退化为 reset
+struct MeshChangeSet {
+    bool reset = false;              // 整体替换，其余字段不再有意义，全部重新读取
+    std::vector<MeshRowRange> nodes; // 按发生顺序依次应用
+    std::vector<MeshRowRange> elements;
+    // 内容变了但行没有增删的单元（节点删除/插回导致的端点 ID 变化），按最终行号保守估计，使用时要限制在当前行数内
+    int elementsModifiedFirst = -1;
+    int elementsModifiedLast = -1;
+    bool facesChanged = false;
+
+    bool empty() const {
+        return !reset && nodes.empty() && elements.empty() && elementsModifiedFirst < 0 && !facesChanged;
+    }
+};
+
+// 数据变化监听。非事务的改动在完成后立即回调，事务内的改动在最外层事务结束时合并回调一次
+class MeshDataObserver
+{
+public:
+    virtual ~MeshDataObserver() = default;
+    virtual void meshChanged(const MeshChangeSet& changes) = 0;
 };
 
 class MeshData
@@ -54,15 +100,87 @@ public:
     // 3. 添加弧线 (需要第三个点)
     int addArc(int startNodeId, int endNodeId, double midX, double midY, double midZ);
 
-    // 生成面
+    // 批量删除（删除命令用）：一次遍历删掉若干行并重排 ID、线的端点，代价 O(N + E + K)，
+    // 结果与按行号从大到小逐个 removeElementAtIndex / removeNodeAtIndex 相同。
+    // nodeRows / elementRows 为升序、不重复的行号，调用方保证剩下的线不引用被删的点。
+    // 删除、插回、truncate 都会清空已生成的面
+    void removeRows(const std::vector<int>& nodeRows, const std::vector<int>& elementRows);
+    // 批量插回（removeRows 的逆操作）：按删除前的行号（升序）把点和线放回原位，
+    // 其余的点、线及其端点 ID 相应后移；插回的线端点是删除前的 ID，保持不变
+    void insertRows(const std::vector<std::pair<int, Node>>& nodes,
+                    const std::vector<std::pair<int, Element>>& elements);
+
+    // 批量追加（导入、生成用），每批只通知一次。elements 的 id 不使用，按追加顺序重新编号；
+    // nodeOffset 加到端点 ID 上（端点是批内下标时传追加前的节点数）
+    void appendNodes(const std::vector<std::array<double, 3>>& points);
+    void appendElements(const std::vector<Element>& elements, int nodeOffset = 0);
+    // 删掉末尾的点和线，只保留前 nodeCount 个点、前 elementCount 条线（撤销批量追加用）。
+    // 调用方保证剩下的线不引用被删的点
+    void truncate(size_t nodeCount, size_t elementCount);
+
+    // 整体交换数据（清空、导入等整表替换操作的撤销用），不拷贝
+    void swapData(std::vector<Node>& nodes, std::vector<Element>& elements, std::vector<Face>& faces);
+
+    // 生成面（同步）
     void generateFaces();
 
+    // 异步生成面拆成三步：界面线程取快照 -> 工作线程计算 -> 界面线程 setFaces
+    void fillMeshingInput(MeshingInput& input) const;
+    // 只读 input，结果写入 faces；出错或被 workspace 的取消标记打断时返回 false，faces 不变
+    static bool computeFaces(const MeshingInput& input, cgal_tools::MeshingWorkspace& workspace,
+                             std::vector<Face>& faces);
+    // 与 faces 交换（不拷贝）
+    void setFaces(std::vector<Face>& faces);
+
+    // 节点/单元每改动一次加 1，用来判断异步结果是否已经过时
+    uint64_t revision() const { return m_revision; }
+    // 生成面输入（节点坐标、单元端点与弧线中间点）的内容哈希，随每次改动增量更新。
+    // 与 revision 不同，改回原样（撤销、重新导入同一文件）后哈希也回到原值
+    uint64_t contentHash() const { return m_contentHash; }
+
+    // 监听者由调用方管理生命周期，销毁前必须 removeObserver
+    void addObserver(MeshDataObserver* observer);
+    void removeObserver(MeshDataObserver* observer);
+
+    // 事务：begin/end 之间的改动合并成一次通知，可以嵌套，最外层 endUpdate 时发出
+    void beginUpdate();
+    void endUpdate();
+    // 作用域事务
+    class UpdateScope
+    {
+    public:
+        explicit UpdateScope(MeshData& data) : m_data(data) { m_data.beginUpdate(); }
+        ~UpdateScope() { m_data.endUpdate(); }
+        UpdateScope(const UpdateScope&) = delete;
+        UpdateScope& operator=(const UpdateScope&) = delete;
+
+    private:
+        MeshData& m_data;
+    };
+
     void clearData();
+    // 批量导入前预留容量
+    void reserve(size_t nodeCount, size_t elementCount);
+
+    // ID -> 下标。ID 始终与下标一致（删除/插回时整体重排），所以是 O(1)；ID 无效时返回 -1
+    int nodeIndexOf(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < m_nodes.size() && m_nodes[id].id == id ? id : -1;
+    }
+    int elementIndexOf(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < m_elements.size() && m_elements[id].id == id ? id : -1;
+    }
+    // 按 ID 取节点，ID 无效时返回 nullptr
+    const Node* findNode(int id) const {
+        const int i = nodeIndexOf(id);
+        return i >= 0 ? &m_nodes[i] : nullptr;
+    }
 
     // Getters
     const std::vector<Node>& getNodes() const;
     const std::vector<Element>& getElements() const; // 新增获取所有线
     const std::vector<Face>& getFaces() const { return m_faces; }
+    // 网格算法工作区的缓冲高水位（字节）
+    size_t meshingHighWaterBytes() const { return m_meshWorkspace.high_water_bytes(); }
 
 private:
     std::vector<Node> m_nodes;
@@ -71,6 +189,37 @@ private:
 
     int m_nextNodeId = 0;    // 节点ID计数
     int m_nextElementId = 0; // 单元ID计数 (建议分开计数)
+    uint64_t m_revision = 0;
+    uint64_t m_contentHash = 0;
+    std::vector<int> m_pendingArcs; // 端点缺失、几何量待算的弧线行号（升序），随线的增删调整
+
+    std::vector<MeshDataObserver*> m_observers;
+    int m_updateDepth = 0;
+    MeshChangeSet m_pending; // 还没发出的改动
+
+    // 记录改动，不在事务中时立即发出
+    void recordRows(std::vector<MeshRowRange>& list, bool inserted, int first, int last);
+    // 升序行号按连续段记录：删除从下往上，插入从上往下，每段的行号在应用时都有效
+    void recordRowRuns(std::vector<MeshRowRange>& list, bool inserted, const std::vector<int>& rows);
+    void recordElementsModified(int first, int last);
+    void recordFacesChanged();
+    // 删除、插回点或线后面的点/线下标对不上了，清空面（需重新生成）；随本次改动一起通知 facesChanged
+    void dropFaces();
+    void recordReset();
+    void flushChanges();
+    // 整体替换后重新计算 m_contentHash
+    void rehashContent();
+    // 计算 rows（升序）中弧线的几何量。端点还不存在的弧线（流式导入时线可能先于点到达）
+    // 圆心记为 NaN，行号并入 m_pendingArcs；有结果写入时 changedFirst / changedLast 为写入的行号范围
+    void updateArcGeometry(const std::vector<int>& rows, int* changedFirst = nullptr, int* changedLast = nullptr);
+    // 同上，计算 [first, last) 中的全部弧线
+    void updateArcGeometry(size_t first, size_t last);
+    // 新的点到达后，重算端点已经齐了的待算弧线，并记录为单元修改
+    void resolvePendingArcs();
+
+    // 生成面时复用的输入缓冲和算法工作区，反复 Mesh 时不再重新分配
+    MeshingInput m_meshInput;
+    cgal_tools::MeshingWorkspace m_meshWorkspace;
 };
 
 #endif // MESHDATA_H
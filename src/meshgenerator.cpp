@@ -0,0 +1,174 @@
+#include "meshgenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+inline Element makeElement(int a, int b, ElementType type = TYPE_LINE)
+{
+    Element e;
+    e.id = 0;
+    e.type = type;
+    e.startNodeId = a;
+    e.endNodeId = b;
+    return e;
+}
+
+} // namespace
+
+namespace meshgen {
+
+GeneratedMesh grid(int nx, int ny, double spacing)
+{
+    return lattice(nx, ny, 1, spacing);
+}
+
+GeneratedMesh lattice(int nx, int ny, int nz, double spacing)
+{
+    GeneratedMesh mesh;
+    nx = std::max(nx, 1);
+    ny = std::max(ny, 1);
+    nz = std::max(nz, 1);
+
+    const size_t count = size_t(nx) * ny * nz;
+    mesh.points.reserve(count);
+    mesh.elements.reserve(size_t(nx - 1) * ny * nz + size_t(nx) * (ny - 1) * nz + size_t(nx) * ny * (nz - 1));
+
+    const double ox = -0.5 * (nx - 1) * spacing;
+    const double oy = -0.5 * (ny - 1) * spacing;
+    const double oz = -0.5 * (nz - 1) * spacing;
+    auto index = [=](int i, int j, int k) { return (k * ny + j) * nx + i; };
+
+    for (int k = 0; k < nz; ++k) {
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                mesh.points.push_back({ox + i * spacing, oy + j * spacing, oz + k * spacing});
+                const int v = index(i, j, k);
+                if (i + 1 < nx) mesh.elements.push_back(makeElement(v, index(i + 1, j, k)));
+                if (j + 1 < ny) mesh.elements.push_back(makeElement(v, index(i, j + 1, k)));
+                if (k + 1 < nz) mesh.elements.push_back(makeElement(v, index(i, j, k + 1)));
+            }
+        }
+    }
+    return mesh;
+}
+
+GeneratedMesh circle(int segments, double radius, double sweepDegrees, bool useArcs)
+{
+    GeneratedMesh mesh;
+    // 圆心角为 0 时所有点重合，不生成
+    if (!(sweepDegrees > 0.0)) return mesh;
+    const bool closed = sweepDegrees >= 360.0;
+    // 闭合时至少 3 条直线或 2 条弧线，否则首尾相接成自环（1 条弧线）或重复的线（2 条直线）
+    segments = std::max(segments, closed ? (useArcs ? 2 : 3) : 1);
+    const double sweep = (closed ? 360.0 : sweepDegrees) * M_PI / 180.0;
+    const double step = sweep / segments;
+
+    // 闭合时最后一段连回第一个点
+    const int nodeCount = closed ? segments : segments + 1;
+    mesh.points.reserve(nodeCount);
+    mesh.elements.reserve(segments);
+
+    for (int i = 0; i < nodeCount; ++i) {
+        const double a = i * step;
+        mesh.points.push_back({radius * std::cos(a), radius * std::sin(a), 0.0});
+    }
+    for (int i = 0; i < segments; ++i) {
+        const int next = (i + 1) % nodeCount;
+        Element e = makeElement(i, next, useArcs ? TYPE_ARC : TYPE_LINE);
+        if (useArcs) {
+            const double a = (i + 0.5) * step;
+            e.midX = radius * std::cos(a);
+            e.midY = radius * std::sin(a);
+            e.midZ = 0.0;
+        }
+        mesh.elements.push_back(e);
+    }
+    return mesh;
+}
+
+GeneratedMesh randomCloud(int count, int neighbours, double size, uint32_t seed)
+{
+    GeneratedMesh mesh;
+    count = std::max(count, 0);
+    neighbours = std::max(neighbours, 0);
+    if (count == 0) return mesh;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coord(-0.5 * size, 0.5 * size);
+    mesh.points.resize(count);
+    for (auto& p : mesh.points) {
+        p = {coord(rng), coord(rng), coord(rng)};
+    }
+    if (neighbours == 0 || count < 2) return mesh;
+
+    // 均匀网格分桶，平均每个桶约 2 个点，近邻只在周围 27 个桶里找
+    const int cells = std::max(1, static_cast<int>(std::cbrt(count / 2.0)));
+    const double cellSize = size / cells;
+    auto cellOf = [&](double v) {
+        int c = static_cast<int>((v + 0.5 * size) / cellSize);
+        return std::min(std::max(c, 0), cells - 1);
+    };
+    auto bucket = [&](int cx, int cy, int cz) { return (size_t(cz) * cells + cy) * cells + cx; };
+
+    // CSR：每个桶内的点
+    const size_t bucketCount = size_t(cells) * cells * cells;
+    std::vector<int> start(bucketCount + 1, 0);
+    std::vector<size_t> cellIndex(count);
+    for (int i = 0; i < count; ++i) {
+        const auto& p = mesh.points[i];
+        cellIndex[i] = bucket(cellOf(p[0]), cellOf(p[1]), cellOf(p[2]));
+        ++start[cellIndex[i] + 1];
+    }
+    for (size_t b = 0; b < bucketCount; ++b) start[b + 1] += start[b];
+    std::vector<int> members(count);
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int i = 0; i < count; ++i) members[fill[cellIndex[i]]++] = i;
+
+    // 边用 (小下标 << 32 | 大下标) 表示，最后排序去重
+    std::vector<uint64_t> edges;
+    edges.reserve(size_t(count) * neighbours);
+    std::vector<std::pair<double, int>> candidates;
+
+    for (int i = 0; i < count; ++i) {
+        const auto& p = mesh.points[i];
+        const int cx = cellOf(p[0]), cy = cellOf(p[1]), cz = cellOf(p[2]);
+        candidates.clear();
+        for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, cells - 1); ++z) {
+            for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, cells - 1); ++y) {
+                for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, cells - 1); ++x) {
+                    const size_t b = bucket(x, y, z);
+                    for (int m = start[b]; m < start[b + 1]; ++m) {
+                        const int j = members[m];
+                        if (j == i) continue;
+                        const auto& q = mesh.points[j];
+                        const double dx = q[0] - p[0], dy = q[1] - p[1], dz = q[2] - p[2];
+                        candidates.push_back({dx * dx + dy * dy + dz * dz, j});
+                    }
+                }
+            }
+        }
+        const size_t k = std::min(candidates.size(), static_cast<size_t>(neighbours));
+        std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+        for (size_t c = 0; c < k; ++c) {
+            const uint32_t a = static_cast<uint32_t>(std::min(i, candidates[c].second));
+            const uint32_t b = static_cast<uint32_t>(std::max(i, candidates[c].second));
+            edges.push_back((uint64_t(a) << 32) | b);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    mesh.elements.reserve(edges.size());
+    for (uint64_t key : edges) {
+        mesh.elements.push_back(makeElement(static_cast<int>(key >> 32), static_cast<int>(key & 0xffffffffu)));
+    }
+    return mesh;
+}
+
+} // namespace meshgen
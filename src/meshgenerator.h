@@ -0,0 +1,35 @@
+#ifndef MESHGENERATOR_H
+#define MESHGENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "meshdata.h"
+
+// 批量生成结构化的点和线（压力测试、构造测试数据用）。
+// 结果是独立的一批数据，线的端点是批内节点下标，由 AppendMeshCommand 整批追加进 MeshData
+namespace meshgen {
+
+struct GeneratedMesh {
+    std::vector<std::array<double, 3>> points;
+    std::vector<Element> elements; // startNodeId / endNodeId 为 points 的下标，id 不使用
+};
+
+// nx * ny 的平面网格（z = 0），相邻点连线，以原点为中心
+GeneratedMesh grid(int nx, int ny, double spacing);
+
+// nx * ny * nz 的立方点阵，沿三个轴方向相邻点连线，以原点为中心
+GeneratedMesh lattice(int nx, int ny, int nz, double spacing);
+
+// 圆心在原点、位于 XY 平面的圆或圆弧，分成 segments 段。
+// sweepDegrees >= 360 时首尾相接；useArcs 为 true 时每段是一条弧线（中间点在圆上），否则是直线。
+// 闭合时段数至少为 3（直线）或 2（弧线）；sweepDegrees <= 0 时返回空
+GeneratedMesh circle(int segments, double radius, double sweepDegrees, bool useArcs);
+
+// 边长为 size 的立方体内均匀分布的随机点，每个点与最近的 neighbours 个点连线（重复的边只保留一条）。
+// 近邻只在相邻的网格桶里找，点很稀疏的地方可能少于 neighbours 条
+GeneratedMesh randomCloud(int count, int neighbours, double size, uint32_t seed);
+
+} // namespace meshgen
+
+#endif // MESHGENERATOR_H
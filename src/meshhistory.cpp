@@ -0,0 +1,246 @@
+#include "meshhistory.h"
+#include <algorithm>
+
+// ---------------- AddNodeCommand ----------------
+
+void AddNodeCommand::redo(MeshData& data)
+{
+    data.addNode(m_x, m_y, m_z);
+}
+
+void AddNodeCommand::undo(MeshData& data)
+{
+    // 撤销到这里时，新点一定是最后一个点，且没有线连着它
+    data.removeNodeAtIndex(static_cast<int>(data.getNodes().size()) - 1);
+}
+
+// ---------------- AddElementCommand ----------------
+
+void AddElementCommand::redo(MeshData& data)
+{
+    if (m_elem.type == TYPE_ARC) {
+        data.addArc(m_elem.startNodeId, m_elem.endNodeId, m_elem.midX, m_elem.midY, m_elem.midZ);
+    } else {
+        data.addLine(m_elem.startNodeId, m_elem.endNodeId);
+    }
+}
+
+void AddElementCommand::undo(MeshData& data)
+{
+    data.removeElementAtIndex(static_cast<int>(data.getElements().size()) - 1);
+}
+
+// ---------------- RemoveNodesCommand ----------------
+
+namespace {
+
+// 有效的行号，升序去重
+std::vector<int> validRows(const std::vector<int>& rows, size_t count)
+{
+    std::vector<int> result;
+    result.reserve(rows.size());
+    for (int row : rows) {
+        if (row >= 0 && static_cast<size_t>(row) < count) result.push_back(row);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+} // namespace
+
+RemoveNodesCommand::RemoveNodesCommand(std::vector<int> rows)
+    : m_rows(std::move(rows))
+{
+}
+
+void RemoveNodesCommand::redo(MeshData& data)
+{
+    const auto& nodes = data.getNodes();
+    const auto& elements = data.getElements();
+    const std::vector<int> nodeRows = validRows(m_rows, nodes.size());
+
+    // 连带删除连着这些点的线（ID 即下标），一遍扫完
+    std::vector<char> removedNode(nodes.size(), 0);
+    for (int row : nodeRows) removedNode[row] = 1;
+    auto isRemoved = [&](int id) {
+        return id >= 0 && static_cast<size_t>(id) < removedNode.size() && removedNode[id];
+    };
+    std::vector<int> elementRows;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (isRemoved(elements[i].startNodeId) || isRemoved(elements[i].endNodeId)) {
+            elementRows.push_back(static_cast<int>(i));
+        }
+    }
+
+    // 记下原位置和内容，undo 时原样插回
+    m_removedNodes.clear();
+    m_removedNodes.reserve(nodeRows.size());
+    for (int row : nodeRows) m_removedNodes.push_back({row, nodes[row]});
+    m_removedElements.clear();
+    m_removedElements.reserve(elementRows.size());
+    for (int row : elementRows) m_removedElements.push_back({row, elements[row]});
+
+    data.removeRows(nodeRows, elementRows);
+}
+
+void RemoveNodesCommand::undo(MeshData& data)
+{
+    data.insertRows(m_removedNodes, m_removedElements);
+}
+
+size_t RemoveNodesCommand::bytes() const
+{
+    return sizeof(*this) + m_rows.capacity() * sizeof(int)
+           + m_removedNodes.capacity() * sizeof(std::pair<int, Node>)
+           + m_removedElements.capacity() * sizeof(std::pair<int, Element>);
+}
+
+// ---------------- RemoveElementsCommand ----------------
+
+RemoveElementsCommand::RemoveElementsCommand(std::vector<int> rows)
+    : m_rows(std::move(rows))
+{
+}
+
+void RemoveElementsCommand::redo(MeshData& data)
+{
+    const auto& elements = data.getElements();
+    const std::vector<int> rows = validRows(m_rows, elements.size());
+    m_removed.clear();
+    m_removed.reserve(rows.size());
+    for (int row : rows) m_removed.push_back({row, elements[row]});
+    data.removeRows({}, rows);
+}
+
+void RemoveElementsCommand::undo(MeshData& data)
+{
+    data.insertRows({}, m_removed);
+}
+
+size_t RemoveElementsCommand::bytes() const
+{
+    return sizeof(*this) + m_rows.capacity() * sizeof(int)
+           + m_removed.capacity() * sizeof(std::pair<int, Element>);
+}
+
+// ---------------- AppendMeshCommand ----------------
+
+void AppendMeshCommand::redo(MeshData& data)
+{
+    m_nodeBase = data.getNodes().size();
+    m_elementBase = data.getElements().size();
+    data.reserve(m_nodeBase + m_points.size(), m_elementBase + m_elements.size());
+    data.appendNodes(m_points);
+    data.appendElements(m_elements, static_cast<int>(m_nodeBase));
+}
+
+void AppendMeshCommand::undo(MeshData& data)
+{
+    data.truncate(m_nodeBase, m_elementBase);
+}
+
+size_t AppendMeshCommand::bytes() const
+{
+    return sizeof(*this) + m_points.capacity() * sizeof(m_points[0])
+           + m_elements.capacity() * sizeof(Element);
+}
+
+// ---------------- ReplaceDataCommand ----------------
+
+void ReplaceDataCommand::redo(MeshData& data)
+{
+    data.swapData(m_nodes, m_elements, m_faces);
+}
+
+size_t ReplaceDataCommand::bytes() const
+{
+    size_t faceBytes = m_faces.capacity() * sizeof(Face);
+    for (const auto& f : m_faces) {
+        faceBytes += (f.nodeIndices.capacity() + f.edgeIndices.capacity()) * sizeof(int);
+    }
+    return sizeof(*this) + m_nodes.capacity() * sizeof(Node)
+           + m_elements.capacity() * sizeof(Element) + faceBytes;
+}
+
+// ---------------- MeshHistory ----------------
+
+MeshHistory::MeshHistory(MeshData* data) : m_data(data) {}
+
+void MeshHistory::push(std::unique_ptr<MeshCommand> cmd)
+{
+    // 丢弃 redo 部分
+    while (m_commands.size() > m_index) {
+        m_usedBytes -= m_commands.back()->bytes();
+        m_commands.pop_back();
+    }
+
+    {
+        // 一条命令里的所有改动合并成一次变化通知
+        MeshData::UpdateScope scope(*m_data);
+        cmd->redo(*m_data);
+    }
+    m_usedBytes += cmd->bytes();
+    m_commands.push_back(std::move(cmd));
+    m_index = m_commands.size();
+
+    trim();
+}
+
+void MeshHistory::undo()
+{
+    if (!canUndo()) return;
+    MeshCommand* cmd = m_commands[--m_index].get();
+    m_usedBytes -= cmd->bytes();
+    {
+        MeshData::UpdateScope scope(*m_data);
+        cmd->undo(*m_data);
+    }
+    m_usedBytes += cmd->bytes();
+}
+
+void MeshHistory::redo()
+{
+    if (!canRedo()) return;
+    MeshCommand* cmd = m_commands[m_index++].get();
+    m_usedBytes -= cmd->bytes();
+    {
+        MeshData::UpdateScope scope(*m_data);
+        cmd->redo(*m_data);
+    }
+    m_usedBytes += cmd->bytes();
+    trim();
+}
+
+void MeshHistory::clear()
+{
+    m_commands.clear();
+    m_index = 0;
+    m_usedBytes = 0;
+}
+
+std::string MeshHistory::undoText() const
+{
+    return canUndo() ? m_commands[m_index - 1]->text() : std::string();
+}
+
+std::string MeshHistory::redoText() const
+{
+    return canRedo() ? m_commands[m_index]->text() : std::string();
+}
+
+void MeshHistory::setMemoryLimit(size_t bytes)
+{
+    m_memoryLimit = bytes;
+    trim();
+}
+
+void MeshHistory::trim()
+{
+    // 从最早的命令开始丢弃；最近一条命令总是保留，保证误操作至少能撤销一步
+    while (m_usedBytes > m_memoryLimit && m_index > 1) {
+        m_usedBytes -= m_commands.front()->bytes();
+        m_commands.pop_front();
+        --m_index;
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef MESHHISTORY_H
+#define MESHHISTORY_H
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "meshdata.h"
+
+// 一条可撤销的编辑命令。
+// 命令只保存"变化量"（被删掉的点/线、新增点的坐标等），redo 时重新执行原操作，
+// undo 时按逆序恢复，因此代价只与这次改动的规模有关。
+class MeshCommand
+{
+public:
+    virtual ~MeshCommand() = default;
+
+    virtual void redo(MeshData& data) = 0;
+    virtual void undo(MeshData& data) = 0;
+
+    // 命令占用的内存（字节），用于历史记录的内存上限
+    virtual size_t bytes() const = 0;
+    virtual std::string text() const = 0;
+};
+
+// 添加节点：只记坐标，undo 删掉最后一个点
+class AddNodeCommand : public MeshCommand
+{
+public:
+    AddNodeCommand(double x, double y, double z) : m_x(x), m_y(y), m_z(z) {}
+
+    void redo(MeshData& data) override;
+    void undo(MeshData& data) override;
+    size_t bytes() const override { return sizeof(*this); }
+    std::string text() const override { return "Add Node"; }
+
+private:
+    double m_x, m_y, m_z;
+};
+
+// 添加直线/弧线：只记端点和中间点，undo 删掉最后一条线
+class AddElementCommand : public MeshCommand
+{
+public:
+    explicit AddElementCommand(const Element& elem) : m_elem(elem) {}
+
+    void redo(MeshData& data) override;
+    void undo(MeshData& data) override;
+    size_t bytes() const override { return sizeof(*this); }
+    std::string text() const override { return m_elem.type == TYPE_ARC ? "Add Arc" : "Add Line"; }
+
+private:
+    Element m_elem;
+};
+
+// 删除若干节点（连带删除与之相连的线），包含 ID 重排。
+// 只保存被删除的点和线及其原位置；redo / undo 都是一次批量删除 / 插回，代价 O(N + E + K)
+class RemoveNodesCommand : public MeshCommand
+{
+public:
+    // rows: 节点表中的行号（任意顺序）
+    explicit RemoveNodesCommand(std::vector<int> rows);
+
+    void redo(MeshData& data) override;
+    void undo(MeshData& data) override;
+    size_t bytes() const override;
+    std::string text() const override { return "Delete Nodes"; }
+
+private:
+    std::vector<int> m_rows;
+    std::vector<std::pair<int, Node>> m_removedNodes;       // (原位置, 点)，升序
+    std::vector<std::pair<int, Element>> m_removedElements; // (原位置, 线)，升序
+};
+
+// 删除若干线，包含 ID 重排（批量删除 / 插回，同上）
+class RemoveElementsCommand : public MeshCommand
+{
+public:
+    explicit RemoveElementsCommand(std::vector<int> rows);
+
+    void redo(MeshData& data) override;
+    void undo(MeshData& data) override;
+    size_t bytes() const override;
+    std::string text() const override { return "Delete Elements"; }
+
+private:
+    std::vector<int> m_rows;
+    std::vector<std::pair<int, Element>> m_removed; // (原位置, 线)，升序
+};
+
+// 整批追加点和线（程序生成）：只保存这批数据本身，
+// redo 一次性追加到末尾，undo 把末尾截掉，都只产生一次通知
+class AppendMeshCommand : public MeshCommand
+{
+public:
+    // elements 的端点为 points 的下标
+    AppendMeshCommand(std::string text, std::vector<std::array<double, 3>> points, std::vector<Element> elements)
+        : m_text(std::move(text)), m_points(std::move(points)), m_elements(std::move(elements)) {}
+
+    void redo(MeshData& data) override;
+    void undo(MeshData& data) override;
+    size_t bytes() const override;
+    std::string text() const override { return m_text; }
+
+private:
+    std::string m_text;
+    std::vector<std::array<double, 3>> m_points;
+    std::vector<Element> m_elements;
+    size_t m_nodeBase = 0;    // 追加前的节点数
+    size_t m_elementBase = 0; // 追加前的线数
+};
+
+// 整体替换数据（清空、导入）。
+// 用 swap 在 MeshData 与命令之间交换内容，没有拷贝：
+// 命令里始终保存"另一份"数据，redo/undo 都是同一个交换
+class ReplaceDataCommand : public MeshCommand
+{
+public:
+    explicit ReplaceDataCommand(std::string text) : m_text(std::move(text)) {}
+    // 用 source 的内容替换（source 的内容被移入命令，source 变空）
+    ReplaceDataCommand(std::string text, MeshData& source) : m_text(std::move(text)) {
+        source.swapData(m_nodes, m_elements, m_faces);
+    }
+
+    void redo(MeshData& data) override;
+    void undo(MeshData& data) override { redo(data); }
+    size_t bytes() const override;
+    std::string text() const override { return m_text; }
+
+private:
+    std::string m_text;
+    std::vector<Node> m_nodes;
+    std::vector<Element> m_elements;
+    std::vector<Face> m_faces;
+};
+
+// 撤销/重做栈。
+// 超出内存上限时从最早的命令开始丢弃，保证长时间编辑的历史记录占用有界
+class MeshHistory
+{
+public:
+    explicit MeshHistory(MeshData* data);
+
+    // 执行命令并压栈（会清空 redo 部分）
+    void push(std::unique_ptr<MeshCommand> cmd);
+
+    bool canUndo() const { return m_index > 0; }
+    bool canRedo() const { return m_index < m_commands.size(); }
+    void undo();
+    void redo();
+    void clear();
+
+    std::string undoText() const;
+    std::string redoText() const;
+
+    // 历史记录内存上限（字节）
+    void setMemoryLimit(size_t bytes);
+    size_t memoryLimit() const { return m_memoryLimit; }
+    size_t usedBytes() const { return m_usedBytes; }
+
+private:
+    void trim();
+
+    MeshData* m_data;
+    std::deque<std::unique_ptr<MeshCommand>> m_commands;
+    size_t m_index = 0;       // [0, m_index) 为可撤销的命令
+    size_t m_usedBytes = 0;
+    size_t m_memoryLimit = size_t(256) * 1024 * 1024;
+};
+
+#endif // MESHHISTORY_H
@@ -0,0 +1,571 @@
+#include "meshio.h"
+#include "meshio_stream.h"
+#include <QFile>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 段落模式：0=None, 1=Nodes, 2=Elements（与旧的逐行导入一致）
+enum ParseMode {
+    MODE_NONE = 0,
+    MODE_NODES = 1,
+    MODE_ELEMENTS = 2
+};
+
+// 小于这个大小的块不值得再开线程
+constexpr size_t kMinChunkBytes = 1 << 20;
+
+// 解析时每处理这么多字节汇报一次进度、检查一次取消
+constexpr size_t kProgressSliceBytes = 1 << 20;
+
+struct ParsedElement {
+    int type;
+    int startId;
+    int endId;
+    double midX, midY, midZ;
+};
+
+// 每个块的解析结果，最后按块顺序拼接
+struct ChunkResult {
+    int lastHeaderMode = -1; // 块内最后一个段头的模式，-1 表示块内没有段头
+    int startMode = MODE_NONE;
+    std::vector<std::array<double, 3>> nodes;
+    std::vector<ParsedElement> elements;
+};
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+inline bool startsWith(const char* b, const char* e, const char* prefix)
+{
+    size_t n = std::strlen(prefix);
+    return static_cast<size_t>(e - b) >= n && std::memcmp(b, prefix, n) == 0;
+}
+
+// 返回该行（已去首尾空白）的段头模式，不是段头返回 -1
+inline int headerMode(const char* b, const char* e)
+{
+    if (startsWith(b, e, "NODES")) return MODE_NODES;
+    if (startsWith(b, e, "EDGES") || startsWith(b, e, "ELEMENTS")) return MODE_ELEMENTS;
+    return -1;
+}
+
+inline void trim(const char*& b, const char*& e)
+{
+    while (b < e && isBlank(*b)) ++b;
+    while (e > b && isBlank(e[-1])) --e;
+}
+
+// 与 QString::toDouble 一致：整个字段都能解析才算数，否则为 0
+inline double toDouble(const char* b, const char* e)
+{
+    if (b < e && *b == '+') ++b;
+    double v = 0.0;
+    auto res = std::from_chars(b, e, v);
+    return (res.ec == std::errc() && res.ptr == e) ? v : 0.0;
+}
+
+inline int toInt(const char* b, const char* e)
+{
+    if (b < e && *b == '+') ++b;
+    int v = 0;
+    auto res = std::from_chars(b, e, v);
+    return (res.ec == std::errc() && res.ptr == e) ? v : 0;
+}
+
+// 按空白切分，最多取 maxFields 个字段，返回实际字段数（同样最多 maxFields）
+template <int maxFields>
+inline int splitFields(const char* b, const char* e, std::array<const char*, maxFields * 2>& f)
+{
+    int n = 0;
+    while (b < e && n < maxFields) {
+        while (b < e && isBlank(*b)) ++b;
+        if (b == e) break;
+        const char* s = b;
+        while (b < e && !isBlank(*b)) ++b;
+        f[n * 2] = s;
+        f[n * 2 + 1] = b;
+        ++n;
+    }
+    return n;
+}
+
+// 遍历 [b, e) 中的每一行（已去首尾空白，跳过空行和注释）
+template <typename Fn>
+inline void forEachLine(const char* b, const char* e, Fn&& fn)
+{
+    while (b < e) {
+        const char* nl = static_cast<const char*>(std::memchr(b, '\n', e - b));
+        const char* lineEnd = nl ? nl : e;
+        const char* lb = b;
+        const char* le = lineEnd;
+        trim(lb, le);
+        if (lb < le && *lb != '#') {
+            fn(lb, le);
+        }
+        b = nl ? nl + 1 : e;
+    }
+}
+
+// 第一遍：只找段头，确定块结束时所处的模式
+void scanHeaders(const char* b, const char* e, ChunkResult& out)
+{
+    forEachLine(b, e, [&](const char* lb, const char* le) {
+        int mode = headerMode(lb, le);
+        if (mode != -1) out.lastHeaderMode = mode;
+    });
+}
+
+// 第二遍：从已知模式开始解析数据行。按 1MB 左右的行对齐分片处理，分片之间汇报进度
+void parseChunk(const char* b, const char* e, ChunkResult& out, meshio::IoProgress* progress)
+{
+    int mode = out.startMode;
+    std::array<const char*, 14> f;
+
+    auto parseLine = [&](const char* lb, const char* le) {
+        int header = headerMode(lb, le);
+        if (header != -1) {
+            mode = header;
+            out.lastHeaderMode = header;
+            return;
+        }
+
+        int n = splitFields<7>(lb, le, f);
+        if (n < 4) return;
+
+        if (mode == MODE_NODES) {
+            // 格式: ID X Y Z （ID 忽略，由 MeshData 顺序生成）
+            out.nodes.push_back({toDouble(f[2], f[3]), toDouble(f[4], f[5]), toDouble(f[6], f[7])});
+        }
+        else if (mode == MODE_ELEMENTS) {
+            // 格式: ID TYPE START END [midX midY midZ]
+            ParsedElement elem{};
+            elem.type = toInt(f[2], f[3]);
+            elem.startId = toInt(f[4], f[5]);
+            elem.endId = toInt(f[6], f[7]);
+            if (elem.type == TYPE_LINE) {
+                out.elements.push_back(elem);
+            }
+            else if (elem.type == TYPE_ARC && n >= 7) {
+                elem.midX = toDouble(f[8], f[9]);
+                elem.midY = toDouble(f[10], f[11]);
+                elem.midZ = toDouble(f[12], f[13]);
+                out.elements.push_back(elem);
+            }
+        }
+    };
+
+    while (b < e) {
+        if (progress && progress->isCancelled()) return;
+
+        const char* sliceEnd = e;
+        if (static_cast<size_t>(e - b) > kProgressSliceBytes) {
+            const char* nl = static_cast<const char*>(std::memchr(b + kProgressSliceBytes, '\n', e - b - kProgressSliceBytes));
+            sliceEnd = nl ? nl + 1 : e;
+        }
+        forEachLine(b, sliceEnd, parseLine);
+        if (progress) progress->bytesDone += sliceEnd - b;
+        b = sliceEnd;
+    }
+}
+
+// ---------------- 导出 ----------------
+
+// 每个格式化块的行数；每轮最多 线程数 个块并行格式化，然后按顺序写出
+constexpr size_t kRowsPerBlock = 1 << 16;
+
+// 一行最长：4 个 int + 6 个 double，每个 double 最多 24 字符
+constexpr size_t kMaxRowChars = 4 * 12 + 6 * 25 + 8;
+
+inline char* putDouble(char* p, double v)
+{
+    return std::to_chars(p, p + 25, v).ptr;
+}
+
+inline char* putInt(char* p, int v)
+{
+    return std::to_chars(p, p + 12, v).ptr;
+}
+
+size_t formatNodes(const Node* nodes, size_t count, std::vector<char>& buf)
+{
+    buf.resize(count * kMaxRowChars);
+    char* p = buf.data();
+    for (size_t i = 0; i < count; ++i) {
+        const Node& n = nodes[i];
+        p = putInt(p, n.id);     *p++ = ' ';
+        p = putDouble(p, n.x);   *p++ = ' ';
+        p = putDouble(p, n.y);   *p++ = ' ';
+        p = putDouble(p, n.z);   *p++ = '\n';
+    }
+    return p - buf.data();
+}
+
+size_t formatElements(const Element* elements, size_t count, std::vector<char>& buf)
+{
+    buf.resize(count * kMaxRowChars);
+    char* p = buf.data();
+    for (size_t i = 0; i < count; ++i) {
+        const Element& e = elements[i];
+        p = putInt(p, e.id);            *p++ = ' ';
+        p = putInt(p, e.type);          *p++ = ' ';
+        p = putInt(p, e.startNodeId);   *p++ = ' ';
+        p = putInt(p, e.endNodeId);     *p++ = ' ';
+        p = putDouble(p, e.midX);       *p++ = ' ';
+        p = putDouble(p, e.midY);       *p++ = ' ';
+        p = putDouble(p, e.midZ);       *p++ = '\n';
+    }
+    return p - buf.data();
+}
+
+// 把 rows 按块并行格式化，按顺序交给 write；write 返回 false 时中止
+template <typename Row, typename FormatFn, typename WriteFn>
+bool formatRowsParallel(const std::vector<Row>& rows, FormatFn&& format, WriteFn&& write)
+{
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t blockCount = (rows.size() + kRowsPerBlock - 1) / kRowsPerBlock;
+
+    std::vector<std::vector<char>> buffers(std::min(threadCount, std::max<size_t>(blockCount, 1)));
+    std::vector<size_t> lengths(buffers.size());
+
+    for (size_t first = 0; first < blockCount; first += buffers.size()) {
+        size_t roundBlocks = std::min(buffers.size(), blockCount - first);
+        auto job = [&](size_t k) {
+            size_t begin = (first + k) * kRowsPerBlock;
+            size_t count = std::min(kRowsPerBlock, rows.size() - begin);
+            lengths[k] = format(rows.data() + begin, count, buffers[k]);
+        };
+
+        if (roundBlocks == 1) {
+            job(0);
+        } else {
+            std::vector<std::thread> workers;
+            for (size_t k = 0; k < roundBlocks; ++k) {
+                workers.emplace_back(job, k);
+            }
+            for (auto& t : workers) t.join();
+        }
+
+        for (size_t k = 0; k < roundBlocks; ++k) {
+            if (!write(buffers[k].data(), lengths[k])) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+namespace meshio {
+
+bool parseText(const char* begin, const char* end, MeshData& data, IoProgress* progress)
+{
+    const size_t size = static_cast<size_t>(end - begin);
+
+    // 1. 按行边界切块
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min(threadCount, size / kMinChunkBytes));
+
+    std::vector<const char*> bounds;
+    bounds.push_back(begin);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char* p = begin + size * i / chunkCount;
+        if (p < bounds.back()) p = bounds.back();
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        bounds.push_back(nl ? nl + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<ChunkResult> chunks(chunkCount);
+    auto runParallel = [&](auto&& job) {
+        if (chunkCount == 1) {
+            job(0);
+            return;
+        }
+        std::vector<std::thread> workers;
+        workers.reserve(chunkCount);
+        for (size_t i = 0; i < chunkCount; ++i) {
+            workers.emplace_back(job, i);
+        }
+        for (auto& t : workers) t.join();
+    };
+
+    // 2. 找各块内的段头，推出每块开始时的模式
+    if (chunkCount > 1) {
+        runParallel([&](size_t i) { scanHeaders(bounds[i], bounds[i + 1], chunks[i]); });
+        int mode = MODE_NONE;
+        for (auto& c : chunks) {
+            c.startMode = mode;
+            if (c.lastHeaderMode != -1) mode = c.lastHeaderMode;
+        }
+    }
+
+    // 3. 并行解析
+    runParallel([&](size_t i) {
+        ChunkResult& c = chunks[i];
+        // 粗略预估行数，减少扩容
+        size_t guess = (bounds[i + 1] - bounds[i]) / 32;
+        if (c.startMode == MODE_ELEMENTS) c.elements.reserve(guess);
+        else c.nodes.reserve(guess);
+        parseChunk(bounds[i], bounds[i + 1], c, progress);
+    });
+    if (progress && progress->isCancelled()) return false;
+
+    // 4. 按块顺序一次性写入（先预留容量）
+    size_t nodeCount = 0, elementCount = 0;
+    for (const auto& c : chunks) {
+        nodeCount += c.nodes.size();
+        elementCount += c.elements.size();
+    }
+    data.reserve(data.getNodes().size() + nodeCount, data.getElements().size() + elementCount);
+
+    for (const auto& c : chunks) {
+        for (const auto& p : c.nodes) {
+            data.addNode(p[0], p[1], p[2]);
+        }
+    }
+    for (const auto& c : chunks) {
+        for (const auto& e : c.elements) {
+            if (e.type == TYPE_ARC) {
+                data.addArc(e.startId, e.endId, e.midX, e.midY, e.midZ);
+            } else {
+                data.addLine(e.startId, e.endId);
+            }
+        }
+    }
+    return true;
+}
+
+void appendBatch(MeshData& data, const StreamBatch& batch)
+{
+    // 整批追加，每批只通知一次监听者；容量交给 push_back 按倍数增长，逐批精确 reserve 会反复重新分配
+    data.appendNodes(batch.nodes);
+    data.appendElements(batch.elements);
+}
+
+bool streamText(const QString& fileName, const std::function<bool(StreamBatch&)>& sink,
+                IoStats* stats, QString* errorMessage, IoProgress* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = QString("Cannot open file!");
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (progress) progress->bytesTotal = size;
+
+    // 普通文件和压缩文件走同一条路：按块顺序读（压缩文件边读边解压），
+    // 每块只解析到最后一个完整行，剩下的半行留给下一块
+    std::unique_ptr<InputStream> in = openInput(file, detectCompression(file), errorMessage);
+    if (!in) return false;
+
+    size_t nodeCount = 0, elementCount = 0;
+    int mode = MODE_NONE; // 段落模式跨块延续
+    bool ok = true;
+    bool readError = false;
+    std::vector<char> buffer;
+    size_t carry = 0;
+    StreamBatch batch;
+    while (true) {
+        buffer.resize(carry + kProgressSliceBytes);
+        qint64 got = in->read(buffer.data() + carry, static_cast<qint64>(kProgressSliceBytes));
+        if (got < 0) {
+            ok = false;
+            readError = true;
+            break;
+        }
+
+        const char* b = buffer.data();
+        const char* e = b + carry + got;
+        const char* cut = e;
+        if (got > 0) {
+            while (cut > b && cut[-1] != '\n') --cut;
+        }
+
+        ChunkResult c;
+        c.startMode = mode;
+        parseChunk(b, cut, c, nullptr);
+        if (c.lastHeaderMode != -1) mode = c.lastHeaderMode;
+        carry = static_cast<size_t>(e - cut);
+        std::memmove(buffer.data(), cut, carry);
+
+        if (progress) {
+            progress->bytesDone = in->consumed();
+            if (progress->isCancelled()) {
+                ok = false;
+                break;
+            }
+        }
+
+        batch.nodes.swap(c.nodes);
+        batch.elements.clear();
+        batch.elements.reserve(c.elements.size());
+        for (const auto& pe : c.elements) {
+            Element elem;
+            elem.id = -1;
+            elem.type = pe.type == TYPE_ARC ? TYPE_ARC : TYPE_LINE;
+            elem.startNodeId = pe.startId;
+            elem.endNodeId = pe.endId;
+            elem.midX = pe.midX;
+            elem.midY = pe.midY;
+            elem.midZ = pe.midZ;
+            batch.elements.push_back(elem);
+        }
+        nodeCount += batch.nodes.size();
+        elementCount += batch.elements.size();
+
+        if ((!batch.nodes.empty() || !batch.elements.empty()) && !sink(batch)) {
+            ok = false;
+            break;
+        }
+        batch = StreamBatch();
+
+        if (got == 0) break;
+    }
+
+    in.reset();
+    file.close();
+
+    if (readError) {
+        if (errorMessage) *errorMessage = QString("File is corrupted or truncated.");
+        return false;
+    }
+
+    if (!ok) {
+        if (errorMessage) *errorMessage = QString("Import cancelled.");
+        return false;
+    }
+
+    if (stats) {
+        stats->bytes = size;
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = nodeCount;
+        stats->elements = elementCount;
+    }
+    return true;
+}
+
+bool importText(const QString& fileName, MeshData& data, IoStats* stats, QString* errorMessage,
+                IoProgress* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = QString("Cannot open file!");
+        return false;
+    }
+
+    const qint64 size = file.size();
+    size_t nodesBefore = data.getNodes().size();
+    size_t elementsBefore = data.getElements().size();
+    if (progress) progress->bytesTotal = size;
+
+    // 压缩文件：边读边解压到内存（不落临时文件），进度按读过的压缩字节计，再并行解析
+    const Compression compression = detectCompression(file);
+    if (compression != Compression::None) {
+        std::unique_ptr<InputStream> in = openInput(file, compression, errorMessage);
+        std::vector<char> text;
+        if (!in || !readAll(*in, text, progress, errorMessage)) return false;
+        file.close();
+        parseText(text.data(), text.data() + text.size(), data);
+    } else {
+        // 优先内存映射；映射失败（如管道、特殊文件）时退回整体读取
+        bool ok = false;
+        uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+        if (mapped) {
+            const char* begin = reinterpret_cast<const char*>(mapped);
+            ok = parseText(begin, begin + size, data, progress);
+            file.unmap(mapped);
+        } else {
+            QByteArray bytes = file.readAll();
+            ok = parseText(bytes.constData(), bytes.constData() + bytes.size(), data, progress);
+        }
+        file.close();
+
+        if (!ok) {
+            if (errorMessage) *errorMessage = QString("Import cancelled.");
+            return false;
+        }
+    }
+
+    if (stats) {
+        stats->bytes = size;
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = data.getNodes().size() - nodesBefore;
+        stats->elements = data.getElements().size() - elementsBefore;
+    }
+    return true;
+}
+
+bool exportText(const QString& fileName, const MeshData& data, IoStats* stats, QString* errorMessage)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const Compression compression = compressionForName(fileName);
+    if (!compressionSupported(compression, errorMessage)) return false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = QString("Cannot write to file!");
+        return false;
+    }
+
+    // 文件名以 .gz / .zst 结尾时压缩写出
+    std::unique_ptr<OutputStream> out = openOutput(file, compression, errorMessage);
+    if (!out) return false;
+
+    qint64 written = 0;
+    auto write = [&](const char* p, size_t n) {
+        if (!out->write(p, n)) return false;
+        written += static_cast<qint64>(n);
+        return true;
+    };
+    auto writeText = [&](const std::string& text) { return write(text.data(), text.size()); };
+
+    const auto& nodes = data.getNodes();
+    const auto& elements = data.getElements();
+
+    // 3. 写入点数据
+    // 格式：NODE [ID] [X] [Y] [Z]
+    bool ok = writeText("# Mesh Data Export\n")
+              && writeText("# Format: NODE id x y z\n")
+              && writeText("NODES " + std::to_string(nodes.size()) + "\n")
+              && formatRowsParallel(nodes, formatNodes, write);
+
+    // 4. 写入边数据
+    // 格式：ELEM [ID] [TYPE] [START] [END]
+    ok = ok && writeText("\n# Format: ELEM id type(0=Line,1=Arc) start_node end_node midX midY midZ\n")
+         && writeText("EDGES " + std::to_string(elements.size()) + "\n")
+         && formatRowsParallel(elements, formatElements, write);
+
+    ok = out->finish() && ok;
+    if (!ok) {
+        if (errorMessage) *errorMessage = QString("Cannot write to file!");
+        return false;
+    }
+
+    if (stats) {
+        stats->bytes = written;
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = nodes.size();
+        stats->elements = elements.size();
+    }
+    return true;
+}
+
+} // namespace meshio
@@ -0,0 +1,118 @@
+#ifndef MESHIO_H
+#define MESHIO_H
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "meshdata.h"
+
+// 网格数据文件的读写。
+// 导入时按文件头自动识别 gzip / zstd 压缩，导出时文件名以 .gz / .zst 结尾则压缩写出，
+// 全程流式处理，不产生临时文件（zstd 需要编译时找到 libzstd）
+namespace meshio {
+
+// 一次导入/导出的统计信息（用于状态栏显示吞吐量）
+struct IoStats {
+    qint64 bytes = 0;       // 文件字节数
+    double seconds = 0.0;   // 耗时
+    size_t nodes = 0;
+    size_t elements = 0;
+
+    double megabytesPerSecond() const {
+        return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
+// 导入进度与取消标记。导入在工作线程中更新，界面线程轮询读取
+struct IoProgress {
+    std::atomic<qint64> bytesDone{0};
+    std::atomic<qint64> bytesTotal{0};
+    std::atomic<bool> cancelled{false};
+
+    void cancel() { cancelled.store(true); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+    double fraction() const {
+        qint64 total = bytesTotal.load();
+        return total > 0 ? double(bytesDone.load()) / total : 0.0;
+    }
+};
+
+// 导入 NODES/EDGES 文本格式（与 Export 的输出一致）。
+// 文件被内存映射后按行边界切块，多线程用 std::from_chars 解析，最后一次性追加进 data。
+// data 一般是一个新的空 MeshData；失败或被取消时返回 false 并写入 errorMessage，data 不变。
+bool importText(const QString& fileName, MeshData& data,
+                IoStats* stats = nullptr, QString* errorMessage = nullptr,
+                IoProgress* progress = nullptr);
+
+// 流式导入的一批数据（文件顺序）
+struct StreamBatch {
+    std::vector<std::array<double, 3>> nodes;
+    std::vector<Element> elements; // id 不使用，追加时重新编号
+};
+
+// 流式导入 NODES/EDGES 文本：单线程顺序读取、解析，每读约 1MB 就把这批数据交给 sink，
+// 调用方可以边读边显示。sink 在调用线程中执行，返回 false 表示停止。
+// 全部批次依次 appendBatch 的结果与 importText 一致
+bool streamText(const QString& fileName, const std::function<bool(StreamBatch&)>& sink,
+                IoStats* stats = nullptr, QString* errorMessage = nullptr,
+                IoProgress* progress = nullptr);
+// 把一批数据追加进 data
+void appendBatch(MeshData& data, const StreamBatch& batch);
+
+// 导出 NODES/EDGES 文本格式。
+// 数值用 std::to_chars 输出最短且可无损往返的表示；行按块多线程格式化到大缓冲，再顺序写盘
+bool exportText(const QString& fileName, const MeshData& data,
+                IoStats* stats = nullptr, QString* errorMessage = nullptr);
+
+// 二进制格式 (.mpb)，可直接内存映射读取，见 meshio_binary.h 中的布局说明。
+// 包含节点、单元，以及（如果已生成）面的 CSR 索引和面属性
+bool importBinary(const QString& fileName, MeshData& data,
+                  IoStats* stats = nullptr, QString* errorMessage = nullptr,
+                  IoProgress* progress = nullptr);
+bool exportBinary(const QString& fileName, const MeshData& data,
+                  IoStats* stats = nullptr, QString* errorMessage = nullptr);
+
+// 分块生成面（meshBinaryTiled）的参数
+struct TiledMeshingOptions {
+    size_t edgesPerTile = 2000000; // 每块的目标边数（不含扩展区），决定峰值内存
+    double haloFraction = 0.25;    // 扩展区宽度，相对块的边长
+    int maxRetries = 3;            // 块内有面超出扩展区时，扩展区加倍重做的最多次数
+    QString tempDir;               // 临时文件目录，为空时用输出文件所在目录
+};
+
+struct TiledMeshingStats {
+    size_t tiles = 0;
+    size_t retries = 0;            // 扩展区加倍重做的次数
+    size_t faces = 0;
+    size_t droppedFaces = 0;       // 重做后仍超出扩展区、无法确定而丢弃的面
+    size_t skippedElements = 0;    // 端点越界而跳过的单元
+    size_t maxTileEdges = 0;       // 单块（含扩展区）最多的边数
+    size_t peakWorkspaceBytes = 0; // 重建工作区缓冲的最大字节数
+};
+
+// 放不进内存的模型：从未压缩的 .mpb 文件分块生成面，连同节点、单元写到 outputFile（.mpb，可压缩）。
+// 输入只做内存映射、按需换页，中间数据放在磁盘临时文件里，常驻内存只有一块的重建缓冲。
+// 面的集合与整体生成一致（输入有重叠、悬空等问题时可能少数面不同），顺序按块排列；输入中已有的面不保留。
+// 细节见 meshio_tiled.cpp
+bool meshBinaryTiled(const QString& inputFile, const QString& outputFile,
+                     const TiledMeshingOptions& options = TiledMeshingOptions(),
+                     TiledMeshingStats* tiledStats = nullptr, IoStats* stats = nullptr,
+                     QString* errorMessage = nullptr, IoProgress* progress = nullptr);
+
+// 通用格式：Wavefront OBJ、Stanford PLY（导出为二进制小端）、STL（二进制，只导出），按扩展名选择，
+// 同样支持 .gz / .zst。导出节点、线和已生成的面，triangulate 为 true 时面按扇形拆成三角形（STL 总是三角形）。
+// 导入读取节点、线和面，普通文件直接内存映射解析。格式细节见 meshio_formats.cpp
+bool exportMeshFormat(const QString& fileName, const MeshData& data, bool triangulate,
+                      IoStats* stats = nullptr, QString* errorMessage = nullptr);
+bool importMeshFormat(const QString& fileName, MeshData& data,
+                      IoStats* stats = nullptr, QString* errorMessage = nullptr,
+                      IoProgress* progress = nullptr);
+
+// 解析内存中的文本（importText 的核心，供其它数据源复用）。被取消时返回 false，data 不变
+bool parseText(const char* begin, const char* end, MeshData& data, IoProgress* progress = nullptr);
+
+} // namespace meshio
+
+#endif // MESHIO_H
@@ -0,0 +1,303 @@
+#include "meshio.h"
+#include "meshio_binary.h"
+#include "meshio_stream.h"
+#include <QFile>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using namespace meshio;
+
+// 每转换这么多条记录汇报一次进度、检查一次取消
+constexpr uint64_t kProgressRecords = 1 << 16;
+
+bool loadFromMemory(const uchar* base, uint64_t size, MeshData& data, QString* errorMessage,
+                    meshio::IoProgress* progress)
+{
+    auto fail = [&](const char* msg) {
+        if (errorMessage) *errorMessage = QString(msg);
+        return false;
+    };
+
+    BinaryHeader h;
+    if (!readBinaryHeader(base, size, h, errorMessage)) return false;
+    const bool hasFaces = (h.flags & FLAG_FACES) != 0;
+
+    // 按记录数汇报进度（节点 + 单元 + 面），返回 false 表示已取消
+    const uint64_t totalRecords = h.nodeCount + h.elementCount + (hasFaces ? h.faceCount : 0);
+    uint64_t doneRecords = 0;
+    auto report = [&](uint64_t i) {
+        if (!progress || (i % kProgressRecords) != 0) return true;
+        progress->bytesDone = totalRecords ? qint64(double(doneRecords + i) / totalRecords * size) : 0;
+        return !progress->isCancelled();
+    };
+
+    // 节点：ID 就是下标
+    std::vector<Node> nodes(h.nodeCount);
+    const double* xyz = reinterpret_cast<const double*>(base + h.nodeBlock);
+    for (uint64_t i = 0; i < h.nodeCount; ++i) {
+        if (!report(i)) return fail("Import cancelled.");
+        nodes[i].id = static_cast<int>(i);
+        nodes[i].x = xyz[3 * i];
+        nodes[i].y = xyz[3 * i + 1];
+        nodes[i].z = xyz[3 * i + 2];
+    }
+
+    doneRecords += h.nodeCount;
+
+    std::vector<Element> elements(h.elementCount);
+    const BinaryElement* be = reinterpret_cast<const BinaryElement*>(base + h.elementBlock);
+    for (uint64_t i = 0; i < h.elementCount; ++i) {
+        if (!report(i)) return fail("Import cancelled.");
+        Element& e = elements[i];
+        e.id = static_cast<int>(i);
+        e.type = be[i].type == TYPE_ARC ? TYPE_ARC : TYPE_LINE;
+        e.startNodeId = be[i].startNodeId;
+        e.endNodeId = be[i].endNodeId;
+        e.midX = be[i].mid[0];
+        e.midY = be[i].mid[1];
+        e.midZ = be[i].mid[2];
+    }
+
+    doneRecords += h.elementCount;
+
+    std::vector<Face> faces;
+    if (hasFaces) {
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + h.faceOffsetBlock);
+        const int32_t* indices = reinterpret_cast<const int32_t*>(base + h.faceIndexBlock);
+        const FaceProperties* props = reinterpret_cast<const FaceProperties*>(base + h.facePropBlock);
+
+        faces.resize(h.faceCount);
+        for (uint64_t f = 0; f < h.faceCount; ++f) {
+            if (!report(f)) return fail("Import cancelled.");
+            if (offsets[f] > offsets[f + 1] || offsets[f + 1] > h.faceIndexCount) {
+                return fail("Mesh binary file has invalid face offsets.");
+            }
+            Face& face = faces[f];
+            face.nodeIndices.assign(indices + offsets[f], indices + offsets[f + 1]);
+            // 面的点索引之后会直接用来取节点（导出 STL、写面缓存），越界的文件整个拒绝
+            for (const int idx : face.nodeIndices) {
+                if (idx < 0 || static_cast<uint64_t>(idx) >= h.nodeCount) {
+                    return fail("Mesh binary file has a face referencing a missing node.");
+                }
+            }
+            face.area = props[f].area;
+            face.centerX = props[f].center_x;
+            face.centerY = props[f].center_y;
+            face.centerZ = props[f].center_z;
+        }
+    }
+
+    data.swapData(nodes, elements, faces);
+    if (progress) progress->bytesDone = static_cast<qint64>(size);
+    return true;
+}
+
+} // namespace
+
+namespace meshio {
+
+bool readBinaryHeader(const uchar* base, uint64_t size, BinaryHeader& h, QString* errorMessage)
+{
+    auto fail = [&](const char* msg) {
+        if (errorMessage) *errorMessage = QString(msg);
+        return false;
+    };
+
+    if (size < sizeof(h)) return fail("File is too small to be a mesh binary file.");
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) return fail("Not a MeshPlotter binary file.");
+    if (h.version != kVersion) return fail("Unsupported mesh binary version.");
+
+    const bool hasFaces = (h.flags & FLAG_FACES) != 0;
+    if (!blockFits(h.nodeBlock, h.nodeCount, 3 * sizeof(double), size)
+        || !blockFits(h.elementBlock, h.elementCount, sizeof(BinaryElement), size)) {
+        return fail("Mesh binary file is truncated or corrupted.");
+    }
+    // faceCount + 1 不能回绕
+    if (hasFaces && h.faceCount == std::numeric_limits<uint64_t>::max()) {
+        return fail("Mesh binary file is truncated or corrupted.");
+    }
+    if (hasFaces
+        && (!blockFits(h.faceOffsetBlock, h.faceCount + 1, sizeof(uint64_t), size)
+            || !blockFits(h.faceIndexBlock, h.faceIndexCount, sizeof(int32_t), size)
+            || !blockFits(h.facePropBlock, h.faceCount, sizeof(FaceProperties), size))) {
+        return fail("Mesh binary file is truncated or corrupted.");
+    }
+    return true;
+}
+
+void layoutBinaryHeader(BinaryHeader& h)
+{
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.nodeBlock = align8(sizeof(BinaryHeader));
+    h.elementBlock = align8(h.nodeBlock + h.nodeCount * 3 * sizeof(double));
+    if (h.flags & FLAG_FACES) {
+        h.faceOffsetBlock = align8(h.elementBlock + h.elementCount * sizeof(BinaryElement));
+        h.faceIndexBlock = align8(h.faceOffsetBlock + (h.faceCount + 1) * sizeof(uint64_t));
+        h.facePropBlock = align8(h.faceIndexBlock + h.faceIndexCount * sizeof(int32_t));
+    }
+}
+
+bool importBinary(const QString& fileName, MeshData& data, IoStats* stats, QString* errorMessage,
+                  IoProgress* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = QString("Cannot open file!");
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (progress) progress->bytesTotal = size;
+    bool ok = false;
+
+    const Compression compression = detectCompression(file);
+    if (compression != Compression::None) {
+        // 压缩文件：流式解压到对齐的内存缓冲后按同样的布局读取
+        std::unique_ptr<InputStream> in = openInput(file, compression, errorMessage);
+        std::vector<char> bytes;
+        if (!in || !readAll(*in, bytes, progress, errorMessage)) return false;
+        ok = loadFromMemory(reinterpret_cast<const uchar*>(bytes.data()),
+                            static_cast<uint64_t>(bytes.size()), data, errorMessage, nullptr);
+    } else {
+        uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+        if (mapped) {
+            ok = loadFromMemory(mapped, static_cast<uint64_t>(size), data, errorMessage, progress);
+            file.unmap(mapped);
+        } else {
+            // 映射失败时读入 8 字节对齐的缓冲
+            std::vector<uint64_t> words((static_cast<size_t>(size) + 7) / 8);
+            qint64 got = size > 0 ? file.read(reinterpret_cast<char*>(words.data()), size) : 0;
+            ok = loadFromMemory(reinterpret_cast<const uchar*>(words.data()),
+                                static_cast<uint64_t>(got > 0 ? got : 0), data, errorMessage, progress);
+        }
+    }
+    file.close();
+
+    if (ok && stats) {
+        stats->bytes = size;
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = data.getNodes().size();
+        stats->elements = data.getElements().size();
+    }
+    return ok;
+}
+
+bool exportBinary(const QString& fileName, const MeshData& data, IoStats* stats, QString* errorMessage)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto& nodes = data.getNodes();
+    const auto& elements = data.getElements();
+    const auto& faces = data.getFaces();
+
+    // 引用了不存在的节点的面不写出（读入时会被拒绝）
+    auto validFace = [&](const Face& f) {
+        return std::all_of(f.nodeIndices.begin(), f.nodeIndices.end(),
+                           [&](int i) { return i >= 0 && static_cast<size_t>(i) < nodes.size(); });
+    };
+
+    BinaryHeader h{};
+    h.nodeCount = nodes.size();
+    h.elementCount = elements.size();
+    for (const auto& f : faces) {
+        if (!validFace(f)) continue;
+        ++h.faceCount;
+        h.faceIndexCount += f.nodeIndices.size();
+    }
+    h.flags = h.faceCount == 0 ? 0 : FLAG_FACES;
+    layoutBinaryHeader(h);
+
+    const Compression compression = compressionForName(fileName);
+    if (!compressionSupported(compression, errorMessage)) return false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = QString("Cannot write to file!");
+        return false;
+    }
+
+    // 文件名以 .gz / .zst 结尾时压缩写出；块偏移按未压缩的布局计算
+    std::unique_ptr<OutputStream> out = openOutput(file, compression, errorMessage);
+    if (!out) return false;
+
+    // 分块转换后顺序写出，缓冲大小固定
+    BlockWriter writer(*out);
+    auto put = [&](const void* p, size_t n) { writer.put(p, n); };
+    auto padTo = [&](uint64_t offset) { writer.padTo(offset); };
+
+    put(&h, sizeof(h));
+
+    padTo(h.nodeBlock);
+    for (const auto& n : nodes) {
+        const double xyz[3] = {n.x, n.y, n.z};
+        put(xyz, sizeof(xyz));
+    }
+
+    padTo(h.elementBlock);
+    for (const auto& e : elements) {
+        BinaryElement be{};
+        be.type = e.type;
+        be.startNodeId = e.startNodeId;
+        be.endNodeId = e.endNodeId;
+        be.mid[0] = e.midX;
+        be.mid[1] = e.midY;
+        be.mid[2] = e.midZ;
+        put(&be, sizeof(be));
+    }
+
+    if (h.flags & FLAG_FACES) {
+        padTo(h.faceOffsetBlock);
+        uint64_t offset = 0;
+        put(&offset, sizeof(offset));
+        for (const auto& f : faces) {
+            if (!validFace(f)) continue;
+            offset += f.nodeIndices.size();
+            put(&offset, sizeof(offset));
+        }
+
+        padTo(h.faceIndexBlock);
+        for (const auto& f : faces) {
+            if (!validFace(f)) continue;
+            for (int idx : f.nodeIndices) {
+                const int32_t v = idx;
+                put(&v, sizeof(v));
+            }
+        }
+
+        padTo(h.facePropBlock);
+        for (const auto& f : faces) {
+            if (!validFace(f)) continue;
+            const FaceProperties p{f.area, f.centerX, f.centerY, f.centerZ};
+            put(&p, sizeof(p));
+        }
+    }
+    writer.flush();
+    const bool ok = out->finish() && writer.ok();
+
+    if (!ok) {
+        if (errorMessage) *errorMessage = QString("Cannot write to file!");
+        return false;
+    }
+
+    if (stats) {
+        stats->bytes = static_cast<qint64>(writer.position());
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = nodes.size();
+        stats->elements = elements.size();
+    }
+    return true;
+}
+
+} // namespace meshio
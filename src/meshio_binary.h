@@ -0,0 +1,117 @@
+#ifndef MESHIO_BINARY_H
+#define MESHIO_BINARY_H
+
+// meshio 内部使用：二进制网格文件 (.mpb) 的布局与读写辅助
+
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include "meshio_stream.h"
+
+// 二进制网格文件 (.mpb) 布局，全部为小端：
+//
+//   BinaryHeader                       文件头，记录各数据块的数量和文件偏移
+//   double[nodeCount][3]               节点坐标（节点 ID 即下标）
+//   BinaryElement[elementCount]        单元
+//   uint64[faceCount + 1]              面 CSR 偏移（可选，flags & FLAG_FACES）
+//   int32[faceIndexCount]              面的点索引
+//   FaceProperties[faceCount]          面属性 area, center_x, center_y, center_z
+//
+// 每个块都按 8 字节对齐，映射后可以直接按数组访问，读取时只做一次顺序拷贝。
+
+namespace meshio {
+
+constexpr char kMagic[8] = {'M', 'P', 'M', 'E', 'S', 'H', 'B', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t FLAG_FACES = 1u << 0;
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t nodeCount;
+    uint64_t elementCount;
+    uint64_t faceCount;
+    uint64_t faceIndexCount;
+    uint64_t nodeBlock;       // 各块在文件中的偏移
+    uint64_t elementBlock;
+    uint64_t faceOffsetBlock;
+    uint64_t faceIndexBlock;
+    uint64_t facePropBlock;
+};
+
+struct BinaryElement {
+    int32_t type;
+    int32_t startNodeId;
+    int32_t endNodeId;
+    int32_t reserved;
+    double mid[3];
+};
+
+static_assert(sizeof(BinaryHeader) == 88, "BinaryHeader layout");
+static_assert(sizeof(BinaryElement) == 40, "BinaryElement layout");
+static_assert(sizeof(FaceProperties) == 32, "FaceProperties layout");
+
+inline uint64_t align8(uint64_t v)
+{
+    return (v + 7) & ~uint64_t(7);
+}
+
+// 检查 [offset, offset + count * itemSize) 是否在文件范围内
+inline bool blockFits(uint64_t offset, uint64_t count, uint64_t itemSize, uint64_t fileSize)
+{
+    if (offset > fileSize || (offset & 7) != 0) return false;
+    return count <= (fileSize - offset) / itemSize;
+}
+
+// 读取并校验文件头：魔数、版本，以及各块是否都在 [0, size) 内
+bool readBinaryHeader(const uchar* base, uint64_t size, BinaryHeader& header, QString* errorMessage);
+
+// 按各块数量计算 8 字节对齐的块偏移，填好 magic / version
+void layoutBinaryHeader(BinaryHeader& header);
+
+// 带固定大小缓冲的顺序写出，块之间按偏移补零
+class BlockWriter
+{
+public:
+    explicit BlockWriter(OutputStream& out) : m_out(out) { m_buffer.reserve(kBufferBytes); }
+
+    void put(const void* p, size_t n)
+    {
+        if (m_buffer.size() + n > kBufferBytes) flush();
+        if (n > kBufferBytes) {
+            // 大块直接写出，不经过缓冲
+            if (m_ok) m_ok = m_out.write(static_cast<const char*>(p), n);
+            m_written += n;
+            return;
+        }
+        const char* c = static_cast<const char*>(p);
+        m_buffer.insert(m_buffer.end(), c, c + n);
+    }
+    void padTo(uint64_t offset)
+    {
+        static const char zeros[8] = {};
+        const uint64_t pos = position();
+        if (offset > pos) put(zeros, static_cast<size_t>(offset - pos));
+    }
+    void flush()
+    {
+        if (m_ok && !m_buffer.empty()) m_ok = m_out.write(m_buffer.data(), m_buffer.size());
+        m_written += m_buffer.size();
+        m_buffer.clear();
+    }
+    // 已写出（含缓冲中）的字节数
+    uint64_t position() const { return m_written + m_buffer.size(); }
+    bool ok() const { return m_ok; }
+
+private:
+    static constexpr size_t kBufferBytes = 4 << 20;
+    OutputStream& m_out;
+    std::vector<char> m_buffer;
+    uint64_t m_written = 0;
+    bool m_ok = true;
+};
+
+} // namespace meshio
+
+#endif // MESHIO_BINARY_H
@@ -0,0 +1,418 @@
+#include "meshio_stream.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <thread>
+#ifdef MESHPLOTTER_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef MESHPLOTTER_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// 压缩文件的流式读写。
+// 解压是单线程的（gzip/zstd 的解码本身无法并行），但边读边解，不落临时文件；
+// gzip 压缩把数据切成独立的块并行压缩，每块是一个完整的 gzip 成员，首尾相接仍是合法的 gzip 文件；
+// zstd 压缩使用库自带的多线程。
+
+namespace {
+
+using namespace meshio;
+
+// 每次从文件读取的压缩数据量
+constexpr qint64 kFileReadBytes = 1 << 20;
+// gzip 并行压缩的块大小
+constexpr size_t kGzipBlockBytes = 4 << 20;
+// gzip 压缩级别：1 比默认的 6 快约 4 倍，文件只大 8% 左右，导出受磁盘带宽而不是 CPU 限制
+constexpr int kGzipLevel = 1;
+// readAll 每次解出的数据量
+constexpr size_t kReadAllBlock = 4 << 20;
+
+// ---------------- 输入 ----------------
+
+class PlainInput : public InputStream
+{
+public:
+    explicit PlainInput(QFile& file) : m_file(file) {}
+
+    qint64 read(char* buf, qint64 n) override { return m_file.read(buf, n); }
+    qint64 consumed() const override { return m_file.pos(); }
+    qint64 sizeHint() const override { return m_file.size(); }
+
+private:
+    QFile& m_file;
+};
+
+#ifdef MESHPLOTTER_HAS_ZLIB
+class GzipInput : public InputStream
+{
+public:
+    explicit GzipInput(QFile& file) : m_file(file), m_in(kFileReadBytes)
+    {
+        std::memset(&m_zs, 0, sizeof(m_zs));
+        m_ok = inflateInit2(&m_zs, 15 + 16) == Z_OK; // 15 + 16: 只接受 gzip 头
+    }
+    ~GzipInput() override { inflateEnd(&m_zs); }
+
+    qint64 read(char* buf, qint64 n) override
+    {
+        if (!m_ok) return -1;
+        m_zs.next_out = reinterpret_cast<Bytef*>(buf);
+        m_zs.avail_out = static_cast<uInt>(std::min<qint64>(n, UINT_MAX));
+
+        while (m_zs.avail_out > 0) {
+            if (m_zs.avail_in == 0) {
+                if (m_eof) break;
+                qint64 got = m_file.read(m_in.data(), static_cast<qint64>(m_in.size()));
+                if (got < 0) return fail();
+                if (got == 0) {
+                    m_eof = true;
+                    // 文件结束但还在某个成员中间：文件被截断
+                    if (m_inMember) return fail();
+                    break;
+                }
+                m_consumed += got;
+                m_zs.next_in = reinterpret_cast<Bytef*>(m_in.data());
+                m_zs.avail_in = static_cast<uInt>(got);
+            }
+
+            int ret = inflate(&m_zs, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                // 一个成员结束，后面可能还有（并行压缩的输出由多个成员组成）
+                m_inMember = false;
+                if (inflateReset(&m_zs) != Z_OK) return fail();
+                continue;
+            }
+            if (ret != Z_OK && ret != Z_BUF_ERROR) return fail();
+            m_inMember = true;
+        }
+        return n - static_cast<qint64>(m_zs.avail_out);
+    }
+    qint64 consumed() const override { return m_consumed; }
+
+private:
+    qint64 fail()
+    {
+        m_ok = false;
+        return -1;
+    }
+
+    QFile& m_file;
+    std::vector<char> m_in;
+    z_stream m_zs;
+    qint64 m_consumed = 0;
+    bool m_ok = false;
+    bool m_eof = false;
+    bool m_inMember = false;
+};
+#endif
+
+#ifdef MESHPLOTTER_HAS_ZSTD
+class ZstdInput : public InputStream
+{
+public:
+    explicit ZstdInput(QFile& file) : m_file(file), m_in(kFileReadBytes), m_ctx(ZSTD_createDCtx()) {}
+    ~ZstdInput() override { ZSTD_freeDCtx(m_ctx); }
+
+    qint64 read(char* buf, qint64 n) override
+    {
+        if (!m_ctx) return -1;
+        ZSTD_outBuffer out = {buf, static_cast<size_t>(n), 0};
+
+        while (out.pos < out.size) {
+            if (m_inBuf.pos == m_inBuf.size) {
+                if (m_eof) break;
+                qint64 got = m_file.read(m_in.data(), static_cast<qint64>(m_in.size()));
+                if (got < 0) return -1;
+                if (got == 0) {
+                    m_eof = true;
+                    if (m_frameOpen) return -1; // 截断
+                    break;
+                }
+                m_consumed += got;
+                m_inBuf = {m_in.data(), static_cast<size_t>(got), 0};
+            }
+
+            size_t ret = ZSTD_decompressStream(m_ctx, &out, &m_inBuf);
+            if (ZSTD_isError(ret)) return -1;
+            m_frameOpen = ret != 0;
+        }
+        return static_cast<qint64>(out.pos);
+    }
+    qint64 consumed() const override { return m_consumed; }
+
+private:
+    QFile& m_file;
+    std::vector<char> m_in;
+    ZSTD_DCtx* m_ctx;
+    ZSTD_inBuffer m_inBuf = {nullptr, 0, 0};
+    qint64 m_consumed = 0;
+    bool m_eof = false;
+    bool m_frameOpen = false;
+};
+#endif
+
+// ---------------- 输出 ----------------
+
+class PlainOutput : public OutputStream
+{
+public:
+    explicit PlainOutput(QFile& file) : m_file(file) {}
+
+    bool write(const char* p, size_t n) override
+    {
+        return m_file.write(p, static_cast<qint64>(n)) == static_cast<qint64>(n);
+    }
+    bool finish() override
+    {
+        bool ok = m_file.flush();
+        m_file.close();
+        return ok;
+    }
+
+private:
+    QFile& m_file;
+};
+
+#ifdef MESHPLOTTER_HAS_ZLIB
+class GzipOutput : public OutputStream
+{
+public:
+    explicit GzipOutput(QFile& file)
+        : m_file(file), m_threads(std::max(1u, std::thread::hardware_concurrency()))
+    {
+        m_blocks.resize(m_threads);
+        m_packed.resize(m_threads);
+    }
+
+    bool write(const char* p, size_t n) override
+    {
+        while (n > 0 && m_ok) {
+            std::vector<char>& block = m_blocks[m_filled];
+            if (block.capacity() < kGzipBlockBytes) block.reserve(kGzipBlockBytes);
+            size_t take = std::min(n, kGzipBlockBytes - block.size());
+            block.insert(block.end(), p, p + take);
+            p += take;
+            n -= take;
+
+            if (block.size() == kGzipBlockBytes && ++m_filled == m_threads) {
+                compressBlocks();
+            }
+        }
+        return m_ok;
+    }
+
+    bool finish() override
+    {
+        if (m_filled < m_threads && !m_blocks[m_filled].empty()) ++m_filled;
+        compressBlocks();
+        bool ok = m_ok && m_file.flush();
+        m_file.close();
+        return ok;
+    }
+
+private:
+    // 已填满的块并行压缩成独立的 gzip 成员，再按顺序写出
+    void compressBlocks()
+    {
+        auto job = [this](size_t k) {
+            const std::vector<char>& in = m_blocks[k];
+            std::vector<char>& out = m_packed[k];
+
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            if (deflateInit2(&zs, kGzipLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                out.clear();
+                return;
+            }
+            out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+            zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+            zs.avail_in = static_cast<uInt>(in.size());
+            zs.next_out = reinterpret_cast<Bytef*>(out.data());
+            zs.avail_out = static_cast<uInt>(out.size());
+            bool done = deflate(&zs, Z_FINISH) == Z_STREAM_END;
+            out.resize(done ? zs.total_out : 0);
+            deflateEnd(&zs);
+        };
+
+        if (m_filled == 1) {
+            job(0);
+        } else if (m_filled > 1) {
+            std::vector<std::thread> workers;
+            for (size_t k = 0; k < m_filled; ++k) {
+                workers.emplace_back(job, k);
+            }
+            for (auto& t : workers) t.join();
+        }
+
+        for (size_t k = 0; k < m_filled && m_ok; ++k) {
+            const std::vector<char>& out = m_packed[k];
+            m_ok = !out.empty() && m_file.write(out.data(), static_cast<qint64>(out.size())) == static_cast<qint64>(out.size());
+            m_blocks[k].clear();
+        }
+        m_filled = 0;
+    }
+
+    QFile& m_file;
+    size_t m_threads;
+    std::vector<std::vector<char>> m_blocks; // 待压缩的原始数据
+    std::vector<std::vector<char>> m_packed; // 压缩结果
+    size_t m_filled = 0;                     // 已填满的块数
+    bool m_ok = true;
+};
+#endif
+
+#ifdef MESHPLOTTER_HAS_ZSTD
+class ZstdOutput : public OutputStream
+{
+public:
+    explicit ZstdOutput(QFile& file) : m_file(file), m_out(ZSTD_CStreamOutSize()), m_ctx(ZSTD_createCCtx())
+    {
+        if (!m_ctx) return;
+        ZSTD_CCtx_setParameter(m_ctx, ZSTD_c_compressionLevel, 3);
+        // 库未启用多线程时这一步会失败，退回单线程，不影响结果
+        ZSTD_CCtx_setParameter(m_ctx, ZSTD_c_nbWorkers, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    }
+    ~ZstdOutput() override { ZSTD_freeCCtx(m_ctx); }
+
+    bool write(const char* p, size_t n) override
+    {
+        ZSTD_inBuffer in = {p, n, 0};
+        while (m_ctx && in.pos < in.size) {
+            if (!drain(&in, ZSTD_e_continue)) return false;
+        }
+        return m_ctx != nullptr;
+    }
+
+    bool finish() override
+    {
+        ZSTD_inBuffer in = {nullptr, 0, 0};
+        bool ok = m_ctx != nullptr;
+        while (ok) {
+            size_t remaining = 0;
+            ok = drain(&in, ZSTD_e_end, &remaining);
+            if (remaining == 0) break;
+        }
+        ok = ok && m_file.flush();
+        m_file.close();
+        return ok;
+    }
+
+private:
+    bool drain(ZSTD_inBuffer* in, ZSTD_EndDirective mode, size_t* remaining = nullptr)
+    {
+        ZSTD_outBuffer out = {m_out.data(), m_out.size(), 0};
+        size_t ret = ZSTD_compressStream2(m_ctx, &out, in, mode);
+        if (ZSTD_isError(ret)) return false;
+        if (remaining) *remaining = ret;
+        return m_file.write(m_out.data(), static_cast<qint64>(out.pos)) == static_cast<qint64>(out.pos);
+    }
+
+    QFile& m_file;
+    std::vector<char> m_out;
+    ZSTD_CCtx* m_ctx;
+};
+#endif
+
+} // namespace
+
+namespace meshio {
+
+Compression detectCompression(QFile& file)
+{
+    const QByteArray head = file.peek(4);
+    const auto* h = reinterpret_cast<const unsigned char*>(head.constData());
+    if (head.size() >= 2 && h[0] == 0x1f && h[1] == 0x8b) return Compression::Gzip;
+    if (head.size() >= 4 && h[0] == 0x28 && h[1] == 0xb5 && h[2] == 0x2f && h[3] == 0xfd) return Compression::Zstd;
+    return Compression::None;
+}
+
+Compression compressionForName(const QString& fileName)
+{
+    if (fileName.endsWith(".gz", Qt::CaseInsensitive)) return Compression::Gzip;
+    if (fileName.endsWith(".zst", Qt::CaseInsensitive)) return Compression::Zstd;
+    return Compression::None;
+}
+
+bool compressionSupported(Compression compression, QString* errorMessage)
+{
+#ifndef MESHPLOTTER_HAS_ZLIB
+    if (compression == Compression::Gzip) {
+        if (errorMessage) *errorMessage = QString("This build does not support gzip files.");
+        return false;
+    }
+#endif
+#ifndef MESHPLOTTER_HAS_ZSTD
+    if (compression == Compression::Zstd) {
+        if (errorMessage) *errorMessage = QString("This build does not support zstd files.");
+        return false;
+    }
+#endif
+    Q_UNUSED(compression);
+    Q_UNUSED(errorMessage);
+    return true;
+}
+
+std::unique_ptr<InputStream> openInput(QFile& file, Compression compression, QString* errorMessage)
+{
+    if (!compressionSupported(compression, errorMessage)) return nullptr;
+
+    switch (compression) {
+#ifdef MESHPLOTTER_HAS_ZLIB
+    case Compression::Gzip:
+        return std::make_unique<GzipInput>(file);
+#endif
+#ifdef MESHPLOTTER_HAS_ZSTD
+    case Compression::Zstd:
+        return std::make_unique<ZstdInput>(file);
+#endif
+    default:
+        return std::make_unique<PlainInput>(file);
+    }
+}
+
+std::unique_ptr<OutputStream> openOutput(QFile& file, Compression compression, QString* errorMessage)
+{
+    if (!compressionSupported(compression, errorMessage)) return nullptr;
+
+    switch (compression) {
+#ifdef MESHPLOTTER_HAS_ZLIB
+    case Compression::Gzip:
+        return std::make_unique<GzipOutput>(file);
+#endif
+#ifdef MESHPLOTTER_HAS_ZSTD
+    case Compression::Zstd:
+        return std::make_unique<ZstdOutput>(file);
+#endif
+    default:
+        return std::make_unique<PlainOutput>(file);
+    }
+}
+
+bool readAll(InputStream& in, std::vector<char>& out, IoProgress* progress, QString* errorMessage)
+{
+    out.clear();
+    if (in.sizeHint() > 0) out.reserve(static_cast<size_t>(in.sizeHint()));
+
+    while (true) {
+        if (progress && progress->isCancelled()) {
+            if (errorMessage) *errorMessage = QString("Import cancelled.");
+            return false;
+        }
+
+        size_t old = out.size();
+        out.resize(old + kReadAllBlock);
+        qint64 got = in.read(out.data() + old, static_cast<qint64>(kReadAllBlock));
+        if (got < 0) {
+            out.clear();
+            if (errorMessage) *errorMessage = QString("File is corrupted or truncated.");
+            return false;
+        }
+        out.resize(old + static_cast<size_t>(got));
+        if (progress) progress->bytesDone = in.consumed();
+        if (got == 0) break;
+    }
+    return true;
+}
+
+} // namespace meshio
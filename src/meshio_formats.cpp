@@ -0,0 +1,841 @@
+#include "meshio.h"
+#include "meshio_stream.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 通用网格格式，供下游求解器和其它软件交换数据：
+//
+//   OBJ  v 节点；l 直线；弧线写成 "l 起点 中点 终点" 的折线，中点作为额外的 v 追加在所有节点之后；
+//        f 面。导入时 l 的每一段都成为一条直线，f 只取顶点索引（v/vt/vn 中的 v）。
+//   PLY  导出 binary_little_endian：
+//          vertex  double x, y, z
+//          edge    int vertex1, vertex2, uchar type, double mid_x, mid_y, mid_z
+//          face    list uchar(或 int) int vertex_indices
+//        edge 的 type / mid_* 是自定义属性，其它软件会忽略，读回本程序时能还原弧线。
+//        导入支持 ascii、binary_little_endian、binary_big_endian 和任意数值类型。
+//   STL  二进制，只有三角形，只导出。
+//
+// 导入的面直接作为面数据（面积、中心按顶点重新计算，与 Mesh 的约定相同）；
+// 面的边如果没有对应的线，会补成直线，这样线框显示和重新 Mesh 都能用。
+// 三角化按扇形拆分，适用于 Mesh 生成的凸面或接近凸的面。
+
+namespace {
+
+using meshio::IoProgress;
+
+constexpr size_t kBufferBytes = 4 << 20;
+// 导入时每解析这么多字节汇报一次进度、检查一次取消
+constexpr qint64 kProgressBytes = 1 << 20;
+
+// 文件扩展名（去掉 .gz / .zst 后），小写
+QString formatSuffix(const QString& fileName)
+{
+    QString name = fileName.toLower();
+    if (name.endsWith(".gz")) name.chop(3);
+    else if (name.endsWith(".zst")) name.chop(4);
+    return QFileInfo(name).suffix();
+}
+
+// ---------------------------------------------------------------- 写出
+
+// 定长缓冲写出，数值直接用 to_chars 格式化进缓冲
+class Writer
+{
+public:
+    explicit Writer(meshio::OutputStream& out)
+        : m_out(out), m_buf(new char[kBufferBytes]) {}
+
+    void put(const void* p, size_t n)
+    {
+        if (m_size + n > kBufferBytes) flush();
+        if (n > kBufferBytes) {
+            m_ok = m_ok && m_out.write(static_cast<const char*>(p), n);
+            m_written += static_cast<qint64>(n);
+            return;
+        }
+        std::memcpy(m_buf.get() + m_size, p, n);
+        m_size += n;
+    }
+    template <typename T>
+    void pod(const T& v) { put(&v, sizeof(T)); }
+    void text(const char* s) { put(s, std::strlen(s)); }
+    void ch(char c)
+    {
+        if (m_size + 1 > kBufferBytes) flush();
+        m_buf[m_size++] = c;
+    }
+    template <typename T>
+    void number(T v)
+    {
+        if (m_size + 32 > kBufferBytes) flush();
+        char* p = m_buf.get() + m_size;
+        m_size += static_cast<size_t>(std::to_chars(p, p + 32, v).ptr - p);
+    }
+
+    void flush()
+    {
+        if (m_ok && m_size) m_ok = m_out.write(m_buf.get(), m_size);
+        m_written += static_cast<qint64>(m_size);
+        m_size = 0;
+    }
+    bool finish()
+    {
+        flush();
+        return m_out.finish() && m_ok;
+    }
+    qint64 written() const { return m_written; }
+
+private:
+    meshio::OutputStream& m_out;
+    std::unique_ptr<char[]> m_buf;
+    size_t m_size = 0;
+    qint64 m_written = 0;
+    bool m_ok = true;
+};
+
+// 依次回调面（或拆出的三角形）的顶点。引用了不存在的节点（下标不在 [0, nodeCount) 内）的面跳过
+template <typename Fn>
+void forEachPolygon(const std::vector<Face>& faces, size_t nodeCount, bool triangulate, Fn fn)
+{
+    for (const auto& f : faces) {
+        const auto& idx = f.nodeIndices;
+        if (idx.size() < 3) continue;
+        if (std::any_of(idx.begin(), idx.end(), [&](int i) { return i < 0 || static_cast<size_t>(i) >= nodeCount; })) continue;
+        if (!triangulate) {
+            fn(idx.data(), idx.size());
+            continue;
+        }
+        for (size_t i = 1; i + 1 < idx.size(); ++i) {
+            const int tri[3] = {idx[0], idx[i], idx[i + 1]};
+            fn(tri, size_t(3));
+        }
+    }
+}
+
+void writeObj(Writer& w, const MeshData& data, bool triangulate)
+{
+    const auto& nodes = data.getNodes();
+    const auto& elements = data.getElements();
+
+    w.text("# MeshPlotter\n# ");
+    w.number(nodes.size());
+    w.text(" nodes, ");
+    w.number(elements.size());
+    w.text(" elements, ");
+    w.number(data.getFaces().size());
+    w.text(" faces\n");
+
+    auto vertex = [&](double x, double y, double z) {
+        w.text("v ");
+        w.number(x);
+        w.ch(' ');
+        w.number(y);
+        w.ch(' ');
+        w.number(z);
+        w.ch('\n');
+    };
+    for (const auto& n : nodes) vertex(n.x, n.y, n.z);
+    // 弧线中点排在所有节点之后
+    for (const auto& e : elements) {
+        if (e.type == TYPE_ARC) vertex(e.midX, e.midY, e.midZ);
+    }
+
+    // OBJ 索引从 1 开始
+    size_t nextMid = nodes.size() + 1;
+    for (const auto& e : elements) {
+        w.text("l ");
+        w.number(e.startNodeId + 1);
+        w.ch(' ');
+        if (e.type == TYPE_ARC) {
+            w.number(nextMid++);
+            w.ch(' ');
+        }
+        w.number(e.endNodeId + 1);
+        w.ch('\n');
+    }
+
+    forEachPolygon(data.getFaces(), nodes.size(), triangulate, [&](const int* idx, size_t n) {
+        w.ch('f');
+        for (size_t i = 0; i < n; ++i) {
+            w.ch(' ');
+            w.number(idx[i] + 1);
+        }
+        w.ch('\n');
+    });
+}
+
+void writePly(Writer& w, const MeshData& data, bool triangulate)
+{
+    const auto& nodes = data.getNodes();
+    const auto& elements = data.getElements();
+    const auto& faces = data.getFaces();
+
+    size_t polygonCount = 0;
+    size_t maxVertices = 0;
+    forEachPolygon(faces, nodes.size(), triangulate, [&](const int*, size_t n) {
+        ++polygonCount;
+        maxVertices = std::max(maxVertices, n);
+    });
+    // 顶点数超过 255 的面只能用 int 作为列表长度
+    const bool wideCount = maxVertices > 255;
+
+    std::string header = "ply\nformat binary_little_endian 1.0\ncomment MeshPlotter\n";
+    header += "element vertex " + std::to_string(nodes.size()) + "\n";
+    header += "property double x\nproperty double y\nproperty double z\n";
+    header += "element edge " + std::to_string(elements.size()) + "\n";
+    header += "property int vertex1\nproperty int vertex2\nproperty uchar type\n";
+    header += "property double mid_x\nproperty double mid_y\nproperty double mid_z\n";
+    header += "element face " + std::to_string(polygonCount) + "\n";
+    header += wideCount ? "property list int int vertex_indices\n" : "property list uchar int vertex_indices\n";
+    header += "end_header\n";
+    w.put(header.data(), header.size());
+
+    // 二进制部分按主机字节序写出（与 .mpb 相同，只支持小端主机）
+    for (const auto& n : nodes) {
+        const double xyz[3] = {n.x, n.y, n.z};
+        w.put(xyz, sizeof(xyz));
+    }
+    for (const auto& e : elements) {
+        const int32_t ends[2] = {e.startNodeId, e.endNodeId};
+        const uint8_t type = e.type == TYPE_ARC ? 1 : 0;
+        const double mid[3] = {e.midX, e.midY, e.midZ};
+        w.put(ends, sizeof(ends));
+        w.pod(type);
+        w.put(mid, sizeof(mid));
+    }
+    forEachPolygon(faces, nodes.size(), triangulate, [&](const int* idx, size_t n) {
+        if (wideCount) w.pod(static_cast<int32_t>(n));
+        else w.pod(static_cast<uint8_t>(n));
+        for (size_t i = 0; i < n; ++i) w.pod(static_cast<int32_t>(idx[i]));
+    });
+}
+
+void writeStl(Writer& w, const MeshData& data)
+{
+    const auto& nodes = data.getNodes();
+
+    char header[80] = {};
+    std::strncpy(header, "MeshPlotter binary STL", sizeof(header));
+    w.put(header, sizeof(header));
+
+    uint32_t count = 0;
+    forEachPolygon(data.getFaces(), nodes.size(), true, [&](const int*, size_t) { ++count; });
+    w.pod(count);
+
+    forEachPolygon(data.getFaces(), nodes.size(), true, [&](const int* idx, size_t) {
+        const Node& a = nodes[idx[0]];
+        const Node& b = nodes[idx[1]];
+        const Node& c = nodes[idx[2]];
+        const double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+        const double vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+        double nx = uy * vz - uz * vy, ny = uz * vx - ux * vz, nz = ux * vy - uy * vx;
+        const double len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (len > 0.0) {
+            nx /= len;
+            ny /= len;
+            nz /= len;
+        }
+        const float rec[12] = {
+            float(nx), float(ny), float(nz),
+            float(a.x), float(a.y), float(a.z),
+            float(b.x), float(b.y), float(b.z),
+            float(c.x), float(c.y), float(c.z),
+        };
+        const uint16_t attribute = 0;
+        w.put(rec, sizeof(rec));
+        w.pod(attribute);
+    });
+}
+
+// ---------------------------------------------------------------- 读取
+
+// 整个文件的只读视图：普通文件直接内存映射，压缩文件流式解压到内存
+class FileView
+{
+public:
+    ~FileView()
+    {
+        if (m_mapped) m_file.unmap(m_mapped);
+    }
+
+    bool open(const QString& fileName, IoProgress* progress, QString* errorMessage)
+    {
+        m_file.setFileName(fileName);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            if (errorMessage) *errorMessage = QString("Cannot open file!");
+            return false;
+        }
+        m_fileSize = m_file.size();
+        if (progress) progress->bytesTotal = m_fileSize;
+
+        const meshio::Compression compression = meshio::detectCompression(m_file);
+        if (compression == meshio::Compression::None && m_fileSize > 0) {
+            m_mapped = m_file.map(0, m_fileSize);
+            if (m_mapped) {
+                m_begin = reinterpret_cast<const char*>(m_mapped);
+                m_end = m_begin + m_fileSize;
+                return true;
+            }
+        }
+        // 压缩文件或映射失败
+        std::unique_ptr<meshio::InputStream> in = meshio::openInput(m_file, compression, errorMessage);
+        if (!in || !meshio::readAll(*in, m_bytes, progress, errorMessage)) return false;
+        m_begin = m_bytes.data();
+        m_end = m_begin + m_bytes.size();
+        return true;
+    }
+
+    const char* begin() const { return m_begin; }
+    const char* end() const { return m_end; }
+    qint64 fileSize() const { return m_fileSize; }
+    // 直接映射时解析位置就是文件位置，可以用来汇报进度（解压时进度在 readAll 中已经走完）
+    bool isMapped() const { return m_mapped != nullptr; }
+
+private:
+    QFile m_file;
+    uchar* m_mapped = nullptr;
+    std::vector<char> m_bytes;
+    const char* m_begin = nullptr;
+    const char* m_end = nullptr;
+    qint64 m_fileSize = 0;
+};
+
+// 解析进度：每前进 kProgressBytes 汇报一次，返回 false 表示已取消
+class ParseProgress
+{
+public:
+    ParseProgress(const FileView& view, IoProgress* progress)
+        : m_base(view.begin()), m_progress(progress), m_mapped(view.isMapped()) {}
+
+    bool at(const char* p)
+    {
+        if (!m_progress || p < m_next) return true;
+        m_next = p + kProgressBytes;
+        if (m_mapped) m_progress->bytesDone = static_cast<qint64>(p - m_base);
+        return !m_progress->isCancelled();
+    }
+
+private:
+    const char* m_base;
+    const char* m_next = nullptr;
+    IoProgress* m_progress;
+    bool m_mapped;
+};
+
+struct Imported {
+    std::vector<Node> nodes;
+    std::vector<Element> elements;
+    std::vector<Face> faces;
+};
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipBlank(const char* p, const char* e)
+{
+    while (p < e && isBlank(*p)) ++p;
+    return p;
+}
+
+// 解析一个浮点数（允许前导 '+'，from_chars 不接受）
+inline bool parseDouble(const char*& p, const char* e, double& v)
+{
+    p = skipBlank(p, e);
+    if (p < e && *p == '+') ++p;
+    auto r = std::from_chars(p, e, v);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+
+// 文件里的顶点序号转成 int。超出 int 范围（或不是数）时返回 -1，由 finishImport 报告缺失的顶点
+int toIndex(long long v)
+{
+    return v >= 0 && v <= INT_MAX ? static_cast<int>(v) : -1;
+}
+
+int toIndex(double v)
+{
+    return v >= 0.0 && v <= static_cast<double>(INT_MAX) ? static_cast<int>(v) : -1;
+}
+
+void appendLine(std::vector<Element>& elements, int a, int b, ElementType type = TYPE_LINE)
+{
+    Element e;
+    e.id = static_cast<int>(elements.size());
+    e.type = type;
+    e.startNodeId = a;
+    e.endNodeId = b;
+    elements.push_back(e);
+}
+
+bool parseObj(const FileView& view, Imported& out, IoProgress* progress, QString* errorMessage)
+{
+    auto fail = [&](const char* msg) {
+        if (errorMessage) *errorMessage = QString(msg);
+        return false;
+    };
+
+    ParseProgress report(view, progress);
+    std::vector<int> refs;
+    const char* p = view.begin();
+    const char* end = view.end();
+
+    // 一行中的顶点引用（v、v/vt、v/vt/vn、v//vn），负数表示相对当前已读顶点
+    auto readRefs = [&](const char* q, const char* e) {
+        refs.clear();
+        for (;;) {
+            q = skipBlank(q, e);
+            if (q >= e || *q == '#') return true;
+            long long v = 0;
+            auto r = std::from_chars(q, e, v);
+            if (r.ec != std::errc() || v == 0) return false;
+            const long long count = static_cast<long long>(out.nodes.size());
+            refs.push_back(toIndex(v > 0 ? v - 1 : count + v));
+            q = r.ptr;
+            while (q < e && !isBlank(*q)) ++q; // 跳过 /vt/vn
+        }
+    };
+
+    while (p < end) {
+        if (!report.at(p)) return fail("Import cancelled.");
+
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol) eol = end;
+        const char* q = skipBlank(p, eol);
+        const char* next = eol < end ? eol + 1 : end;
+
+        if (q + 1 < eol && q[0] == 'v' && isBlank(q[1])) {
+            double xyz[3];
+            q += 1;
+            for (double& c : xyz) {
+                if (!parseDouble(q, eol, c)) return fail("Invalid vertex in OBJ file.");
+            }
+            out.nodes.push_back({static_cast<int>(out.nodes.size()), xyz[0], xyz[1], xyz[2]});
+        } else if (q + 1 < eol && q[0] == 'l' && isBlank(q[1])) {
+            if (!readRefs(q + 1, eol) || refs.size() < 2) return fail("Invalid line in OBJ file.");
+            for (size_t i = 0; i + 1 < refs.size(); ++i) {
+                appendLine(out.elements, refs[i], refs[i + 1]);
+            }
+        } else if (q + 1 < eol && q[0] == 'f' && isBlank(q[1])) {
+            if (!readRefs(q + 1, eol) || refs.size() < 3) return fail("Invalid face in OBJ file.");
+            Face f{};
+            f.nodeIndices.assign(refs.begin(), refs.end());
+            out.faces.push_back(std::move(f));
+        }
+        // 其它（vt、vn、g、o、usemtl、注释……）忽略
+        p = next;
+    }
+    return true;
+}
+
+// ---------------- PLY
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+
+PlyType plyType(const std::string& s)
+{
+    if (s == "char" || s == "int8") return PlyType::Int8;
+    if (s == "uchar" || s == "uint8") return PlyType::UInt8;
+    if (s == "short" || s == "int16") return PlyType::Int16;
+    if (s == "ushort" || s == "uint16") return PlyType::UInt16;
+    if (s == "int" || s == "int32") return PlyType::Int32;
+    if (s == "uint" || s == "uint32") return PlyType::UInt32;
+    if (s == "float" || s == "float32") return PlyType::Float32;
+    if (s == "double" || s == "float64") return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+size_t plySize(PlyType t)
+{
+    switch (t) {
+    case PlyType::Int8: case PlyType::UInt8: return 1;
+    case PlyType::Int16: case PlyType::UInt16: return 2;
+    case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+    case PlyType::Float64: return 8;
+    default: return 0;
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Invalid;
+    bool isList = false;
+    PlyType countType = PlyType::Invalid;
+};
+
+struct PlyElement {
+    std::string name;
+    uint64_t count = 0;
+    std::vector<PlyProperty> properties;
+};
+
+enum class PlyFormat { Ascii, BinaryLE, BinaryBE };
+
+// 按格式读取一个标量，统一转成 double（int32 在 double 中精确表示）
+class PlyReader
+{
+public:
+    PlyReader(const char* p, const char* end, PlyFormat format)
+        : m_p(p), m_end(end), m_format(format) {}
+
+    bool scalar(PlyType t, double& v)
+    {
+        if (m_format == PlyFormat::Ascii) {
+            while (m_p < m_end && (isBlank(*m_p) || *m_p == '\n')) ++m_p;
+            return parseDouble(m_p, m_end, v);
+        }
+        const size_t n = plySize(t);
+        if (static_cast<size_t>(m_end - m_p) < n) return false;
+        unsigned char b[8];
+        std::memcpy(b, m_p, n);
+        m_p += n;
+        if (m_format == PlyFormat::BinaryBE) std::reverse(b, b + n);
+        switch (t) {
+        case PlyType::Int8: v = static_cast<int8_t>(b[0]); break;
+        case PlyType::UInt8: v = b[0]; break;
+        case PlyType::Int16: { int16_t x; std::memcpy(&x, b, 2); v = x; break; }
+        case PlyType::UInt16: { uint16_t x; std::memcpy(&x, b, 2); v = x; break; }
+        case PlyType::Int32: { int32_t x; std::memcpy(&x, b, 4); v = x; break; }
+        case PlyType::UInt32: { uint32_t x; std::memcpy(&x, b, 4); v = x; break; }
+        case PlyType::Float32: { float x; std::memcpy(&x, b, 4); v = x; break; }
+        case PlyType::Float64: std::memcpy(&v, b, 8); break;
+        default: return false;
+        }
+        return true;
+    }
+
+    const char* pos() const { return m_p; }
+
+private:
+    const char* m_p;
+    const char* m_end;
+    PlyFormat m_format;
+};
+
+int findProperty(const PlyElement& el, const char* name)
+{
+    for (size_t i = 0; i < el.properties.size(); ++i) {
+        if (el.properties[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool parsePly(const FileView& view, Imported& out, IoProgress* progress, QString* errorMessage)
+{
+    auto fail = [&](const char* msg) {
+        if (errorMessage) *errorMessage = QString(msg);
+        return false;
+    };
+
+    const char* p = view.begin();
+    const char* end = view.end();
+
+    // 文件头：逐行读到 end_header
+    PlyFormat format = PlyFormat::Ascii;
+    bool haveFormat = false;
+    std::vector<PlyElement> elements;
+    bool first = true;
+    for (;;) {
+        if (p >= end) return fail("PLY header is incomplete.");
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol) return fail("PLY header is incomplete.");
+        std::string line(p, eol);
+        p = eol + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::vector<std::string> tok;
+        for (size_t i = 0; i < line.size();) {
+            while (i < line.size() && isBlank(line[i])) ++i;
+            size_t j = i;
+            while (j < line.size() && !isBlank(line[j])) ++j;
+            if (j > i) tok.emplace_back(line, i, j - i);
+            i = j;
+        }
+
+        if (first) {
+            if (tok.size() != 1 || tok[0] != "ply") return fail("Not a PLY file.");
+            first = false;
+            continue;
+        }
+        if (tok.empty() || tok[0] == "comment" || tok[0] == "obj_info") continue;
+        if (tok[0] == "end_header") break;
+
+        if (tok[0] == "format" && tok.size() >= 2) {
+            if (tok[1] == "ascii") format = PlyFormat::Ascii;
+            else if (tok[1] == "binary_little_endian") format = PlyFormat::BinaryLE;
+            else if (tok[1] == "binary_big_endian") format = PlyFormat::BinaryBE;
+            else return fail("Unsupported PLY format.");
+            haveFormat = true;
+        } else if (tok[0] == "element" && tok.size() == 3) {
+            PlyElement el;
+            el.name = tok[1];
+            auto r = std::from_chars(tok[2].data(), tok[2].data() + tok[2].size(), el.count);
+            if (r.ec != std::errc()) return fail("Invalid PLY element count.");
+            elements.push_back(std::move(el));
+        } else if (tok[0] == "property" && !elements.empty()) {
+            PlyProperty prop;
+            if (tok.size() == 5 && tok[1] == "list") {
+                prop.isList = true;
+                prop.countType = plyType(tok[2]);
+                prop.type = plyType(tok[3]);
+                prop.name = tok[4];
+                if (prop.countType == PlyType::Invalid) return fail("Invalid PLY property type.");
+            } else if (tok.size() == 3) {
+                prop.type = plyType(tok[1]);
+                prop.name = tok[2];
+            }
+            if (prop.type == PlyType::Invalid) return fail("Invalid PLY property type.");
+            elements.back().properties.push_back(std::move(prop));
+        } else {
+            return fail("Invalid PLY header.");
+        }
+    }
+    if (!haveFormat) return fail("PLY header has no format line.");
+
+    ParseProgress report(view, progress);
+    PlyReader reader(p, end, format);
+    // 头里的数量不可信：每条记录至少占一个字节，预留不超过剩余的文件大小，
+    // 损坏的头不会因为 reserve 抛 length_error / bad_alloc
+    auto reserveCount = [&](double count) {
+        return static_cast<size_t>(std::min(count, static_cast<double>(end - reader.pos())));
+    };
+    std::vector<double> values;
+
+    for (const PlyElement& el : elements) {
+        const bool isVertex = el.name == "vertex";
+        const bool isEdge = el.name == "edge";
+        const bool isFace = el.name == "face";
+
+        int ix = -1, iy = -1, iz = -1;
+        int iv1 = -1, iv2 = -1, itype = -1, imx = -1, imy = -1, imz = -1;
+        int ilist = -1;
+        if (isVertex) {
+            ix = findProperty(el, "x");
+            iy = findProperty(el, "y");
+            iz = findProperty(el, "z");
+            if (ix < 0 || iy < 0) return fail("PLY vertex element has no x/y properties.");
+            out.nodes.reserve(reserveCount(el.count));
+        } else if (isEdge) {
+            iv1 = findProperty(el, "vertex1");
+            iv2 = findProperty(el, "vertex2");
+            itype = findProperty(el, "type");
+            imx = findProperty(el, "mid_x");
+            imy = findProperty(el, "mid_y");
+            imz = findProperty(el, "mid_z");
+            if (iv1 < 0 || iv2 < 0) return fail("PLY edge element has no vertex1/vertex2 properties.");
+            out.elements.reserve(out.elements.size() + reserveCount(el.count));
+        } else if (isFace) {
+            ilist = findProperty(el, "vertex_indices");
+            if (ilist < 0) ilist = findProperty(el, "vertex_index");
+            if (ilist >= 0 && !el.properties[ilist].isList) ilist = -1;
+            out.faces.reserve(reserveCount(el.count));
+        }
+        values.assign(el.properties.size(), 0.0);
+
+        for (uint64_t r = 0; r < el.count; ++r) {
+            if (!report.at(reader.pos())) return fail("Import cancelled.");
+
+            Face face{};
+            for (size_t j = 0; j < el.properties.size(); ++j) {
+                const PlyProperty& prop = el.properties[j];
+                if (!prop.isList) {
+                    if (!reader.scalar(prop.type, values[j])) return fail("PLY file is truncated or corrupted.");
+                    continue;
+                }
+                double count = 0.0;
+                if (!reader.scalar(prop.countType, count) || count < 0) {
+                    return fail("PLY file is truncated or corrupted.");
+                }
+                const bool keep = static_cast<int>(j) == ilist;
+                if (keep) face.nodeIndices.reserve(reserveCount(count));
+                for (uint64_t k = 0; k < static_cast<uint64_t>(count); ++k) {
+                    double v = 0.0;
+                    if (!reader.scalar(prop.type, v)) return fail("PLY file is truncated or corrupted.");
+                    if (keep) face.nodeIndices.push_back(toIndex(v));
+                }
+            }
+
+            if (isVertex) {
+                out.nodes.push_back({static_cast<int>(out.nodes.size()),
+                                     values[ix], values[iy], iz >= 0 ? values[iz] : 0.0});
+            } else if (isEdge) {
+                const bool arc = itype >= 0 && values[itype] == 1.0 && imx >= 0 && imy >= 0 && imz >= 0;
+                appendLine(out.elements, toIndex(values[iv1]), toIndex(values[iv2]),
+                           arc ? TYPE_ARC : TYPE_LINE);
+                if (arc) {
+                    out.elements.back().midX = values[imx];
+                    out.elements.back().midY = values[imy];
+                    out.elements.back().midZ = values[imz];
+                }
+            } else if (isFace && face.nodeIndices.size() >= 3) {
+                out.faces.push_back(std::move(face));
+            }
+        }
+    }
+    return true;
+}
+
+// ---------------- 导入后的整理
+
+// 检查引用并补齐面数据：面积（Newell 法向量长度的一半）和顶点平均中心；
+// 面的边没有对应的线时补成直线
+bool finishImport(Imported& in, QString* errorMessage)
+{
+    const long long nodeCount = static_cast<long long>(in.nodes.size());
+    auto valid = [nodeCount](long long i) { return i >= 0 && i < nodeCount; };
+
+    for (const auto& e : in.elements) {
+        if (!valid(e.startNodeId) || !valid(e.endNodeId)) {
+            if (errorMessage) *errorMessage = QString("Edge references a missing vertex.");
+            return false;
+        }
+    }
+
+    auto key = [](int a, int b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+    };
+
+    std::vector<uint64_t> faceEdges;
+    for (auto& f : in.faces) {
+        const auto& idx = f.nodeIndices;
+        // 先检查整个面，下面同一轮里要同时读 idx[i] 和 idx[i + 1]
+        for (const int i : idx) {
+            if (!valid(i)) {
+                if (errorMessage) *errorMessage = QString("Face references a missing vertex.");
+                return false;
+            }
+        }
+        double nx = 0.0, ny = 0.0, nz = 0.0;
+        double cx = 0.0, cy = 0.0, cz = 0.0;
+        for (size_t i = 0; i < idx.size(); ++i) {
+            const int a = idx[i];
+            const int b = idx[(i + 1) % idx.size()];
+            const Node& p = in.nodes[a];
+            const Node& q = in.nodes[b];
+            nx += (p.y - q.y) * (p.z + q.z);
+            ny += (p.z - q.z) * (p.x + q.x);
+            nz += (p.x - q.x) * (p.y + q.y);
+            cx += p.x;
+            cy += p.y;
+            cz += p.z;
+            if (a != b) faceEdges.push_back(key(a, b));
+        }
+        f.area = 0.5 * std::sqrt(nx * nx + ny * ny + nz * nz);
+        f.centerX = cx / idx.size();
+        f.centerY = cy / idx.size();
+        f.centerZ = cz / idx.size();
+    }
+    if (faceEdges.empty()) return true;
+
+    std::sort(faceEdges.begin(), faceEdges.end());
+    faceEdges.erase(std::unique(faceEdges.begin(), faceEdges.end()), faceEdges.end());
+
+    std::vector<uint64_t> existing;
+    existing.reserve(in.elements.size());
+    for (const auto& e : in.elements) existing.push_back(key(e.startNodeId, e.endNodeId));
+    std::sort(existing.begin(), existing.end());
+
+    for (uint64_t k : faceEdges) {
+        if (std::binary_search(existing.begin(), existing.end(), k)) continue;
+        appendLine(in.elements, static_cast<int>(k >> 32), static_cast<int>(k & 0xffffffffu));
+    }
+    return true;
+}
+
+} // namespace
+
+namespace meshio {
+
+bool exportMeshFormat(const QString& fileName, const MeshData& data, bool triangulate,
+                      IoStats* stats, QString* errorMessage)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString suffix = formatSuffix(fileName);
+    if (suffix != "obj" && suffix != "ply" && suffix != "stl") {
+        if (errorMessage) *errorMessage = QString("Unknown mesh format. Use .obj, .ply or .stl.");
+        return false;
+    }
+    if (suffix == "stl" && data.getFaces().empty()) {
+        if (errorMessage) *errorMessage = QString("STL only stores faces. Run Mesh before exporting.");
+        return false;
+    }
+
+    const Compression compression = compressionForName(fileName);
+    if (!compressionSupported(compression, errorMessage)) return false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = QString("Cannot write to file!");
+        return false;
+    }
+    std::unique_ptr<OutputStream> out = openOutput(file, compression, errorMessage);
+    if (!out) return false;
+
+    Writer w(*out);
+    if (suffix == "obj") writeObj(w, data, triangulate);
+    else if (suffix == "ply") writePly(w, data, triangulate);
+    else writeStl(w, data);
+
+    if (!w.finish()) {
+        if (errorMessage) *errorMessage = QString("Cannot write to file!");
+        return false;
+    }
+
+    if (stats) {
+        stats->bytes = w.written();
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = data.getNodes().size();
+        stats->elements = data.getElements().size();
+    }
+    return true;
+}
+
+bool importMeshFormat(const QString& fileName, MeshData& data, IoStats* stats, QString* errorMessage,
+                      IoProgress* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString suffix = formatSuffix(fileName);
+    if (suffix != "obj" && suffix != "ply") {
+        if (errorMessage) *errorMessage = QString("Unknown mesh format. Use .obj or .ply.");
+        return false;
+    }
+
+    FileView view;
+    if (!view.open(fileName, progress, errorMessage)) return false;
+
+    Imported imported;
+    const bool parsed = suffix == "obj" ? parseObj(view, imported, progress, errorMessage)
+                                        : parsePly(view, imported, progress, errorMessage);
+    if (!parsed || !finishImport(imported, errorMessage)) return false;
+
+    data.swapData(imported.nodes, imported.elements, imported.faces);
+    if (progress) progress->bytesDone = view.fileSize();
+
+    if (stats) {
+        stats->bytes = view.fileSize();
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = data.getNodes().size();
+        stats->elements = data.getElements().size();
+    }
+    return true;
+}
+
+} // namespace meshio
@@ -0,0 +1,63 @@
+#ifndef MESHIO_STREAM_H
+#define MESHIO_STREAM_H
+
+// meshio 内部使用：透明压缩/解压的输入输出流
+
+#include <QFile>
+#include <QString>
+#include <memory>
+#include <vector>
+#include "meshio.h"
+
+namespace meshio {
+
+enum class Compression {
+    None,
+    Gzip,
+    Zstd
+};
+
+// 读：按文件头识别（gzip 1f 8b，zstd 28 b5 2f fd）
+Compression detectCompression(QFile& file);
+// 写：按扩展名选择（.gz / .zst），其余不压缩
+Compression compressionForName(const QString& fileName);
+
+// 顺序读取解压后的数据
+class InputStream
+{
+public:
+    virtual ~InputStream() = default;
+    // 读取最多 n 字节，返回实际字节数；0 表示结束，-1 表示出错
+    virtual qint64 read(char* buf, qint64 n) = 0;
+    // 已消耗的文件字节数（压缩后），用于进度
+    virtual qint64 consumed() const = 0;
+    // 解压后大小的估计值，未知时为 0（只用于预留容量）
+    virtual qint64 sizeHint() const { return 0; }
+};
+
+// 顺序写入，按需压缩
+class OutputStream
+{
+public:
+    virtual ~OutputStream() = default;
+    virtual bool write(const char* p, size_t n) = 0;
+    // 写完所有数据并关闭文件
+    virtual bool finish() = 0;
+};
+
+// 当前构建是否支持该压缩格式（zstd 需要编译时找到 libzstd）
+bool compressionSupported(Compression compression, QString* errorMessage);
+
+// file 必须已经以只读打开，且在流的生命周期内有效。
+// 不支持的压缩格式（未编译 zstd）返回空指针并写入 errorMessage
+std::unique_ptr<InputStream> openInput(QFile& file, Compression compression, QString* errorMessage);
+// file 必须已经以只写打开；gzip 按块多线程压缩，zstd 使用库自带的多线程
+std::unique_ptr<OutputStream> openOutput(QFile& file, Compression compression, QString* errorMessage);
+
+// 把整个流读入 out（out 之前的内容丢弃，data() 满足 8 字节对齐）。
+// progress 按已消耗的文件字节更新；出错或取消时返回 false 并写入 errorMessage
+bool readAll(InputStream& in, std::vector<char>& out, IoProgress* progress, QString* errorMessage);
+
+} // namespace meshio
+
+#endif // MESHIO_STREAM_H
@@ -0,0 +1,603 @@
+#include "meshio.h"
+#include "meshio_binary.h"
+#include "meshio_stream.h"
+#include "geometry_utils.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// 分块生成面（放不进内存的模型）：
+//
+//   1. 扫描单元，统计每个点的度数（磁盘临时数组）
+//   2. 扫描节点，按整体重建的规则求排序参考（MeshingReference），各块共用
+//   3. 在范围最大的两个坐标轴上做 kBins x kBins 的边数直方图，先切列、再在每列内切行，
+//      使每块的边数接近 edgesPerTile。块边界落在格线上，点极度集中时单块可能超出目标
+//   4. 每条边放进端点所在的全部"块 + 扩展区"，按块计数排序写入临时文件，块内保持原来的边顺序
+//   5. 逐块重建。块内边的相对顺序与整体一致、参考相同，所以一个面只要所有点在块内的度数完整，
+//      走出的面（包括起点）就与整体重建相同。每个面只由起点所在的块输出；
+//      起点在块内、但有点度数不完整的面说明扩展区不够，扩展区加倍后重做这一块
+//   6. 面写入临时文件，最后与节点、单元一起顺序写出 .mpb
+//
+// 扩展区太小导致的面只能检测到走完的那部分（走到一半失败的面不会出现在结果里），
+// 靠 haloFraction 留足余量并配合重做兜底。
+
+namespace {
+
+using namespace meshio;
+
+// 块内点数、有向边数都远小于 2^32
+using TileWorkspace = cgal_tools::BasicMeshingWorkspace<double, uint32_t>;
+
+// 直方图每个轴上的格数
+constexpr int kBins = 1024;
+// 每处理这么多条记录汇报一次进度、检查一次取消
+constexpr uint64_t kProgressRecords = 1 << 16;
+// 拷贝大块数据时每次写出的字节数
+constexpr uint64_t kCopyChunk = 4 << 20;
+
+// 磁盘临时文件上的定长数组（初始全为 0），映射后按需换页，不占常驻内存
+template <typename T>
+class TempArray
+{
+public:
+    bool create(const QString& dir, uint64_t count, QString* errorMessage)
+    {
+        m_file.setFileTemplate(QDir(dir).filePath("meshtile-XXXXXX.tmp"));
+        const qint64 bytes = static_cast<qint64>(std::max<uint64_t>(count, 1) * sizeof(T));
+        if (!m_file.open() || !m_file.resize(bytes)
+            || !(m_data = reinterpret_cast<T*>(m_file.map(0, bytes)))) {
+            if (errorMessage) *errorMessage = QString("Cannot create temporary file in %1.").arg(dir);
+            return false;
+        }
+        return true;
+    }
+    T* data() { return m_data; }
+    T& operator[](uint64_t i) { return m_data[i]; }
+    const T& operator[](uint64_t i) const { return m_data[i]; }
+
+private:
+    QTemporaryFile m_file;
+    T* m_data = nullptr;
+};
+
+// 只追加的临时文件，写完后整体映射读取
+class TempStream
+{
+public:
+    bool create(const QString& dir, QString* errorMessage)
+    {
+        m_file.setFileTemplate(QDir(dir).filePath("meshtile-XXXXXX.tmp"));
+        if (!m_file.open()) {
+            if (errorMessage) *errorMessage = QString("Cannot create temporary file in %1.").arg(dir);
+            return false;
+        }
+        return true;
+    }
+    template <typename T>
+    bool append(const std::vector<T>& items)
+    {
+        const qint64 bytes = static_cast<qint64>(items.size() * sizeof(T));
+        return bytes == 0 || m_file.write(reinterpret_cast<const char*>(items.data()), bytes) == bytes;
+    }
+    // 空文件返回 nullptr
+    const uchar* map()
+    {
+        m_file.flush();
+        const qint64 size = m_file.size();
+        return size > 0 ? m_file.map(0, size) : nullptr;
+    }
+
+private:
+    QTemporaryFile m_file;
+};
+
+inline int binOf(double x, double lo, double scale)
+{
+    const double t = (x - lo) * scale;
+    if (!(t > 0.0)) return 0; // 含 NaN
+    return t >= kBins ? kBins - 1 : static_cast<int>(t);
+}
+
+// 把 counts 切成 parts 段，各段之和尽量相等，每段至少一格。返回 parts + 1 个边界
+std::vector<int> splitQuantiles(const std::vector<uint64_t>& counts, int parts)
+{
+    const int n = static_cast<int>(counts.size());
+    std::vector<uint64_t> prefix(n + 1, 0);
+    for (int i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + counts[i];
+
+    std::vector<int> bounds(parts + 1);
+    bounds[0] = 0;
+    bounds[parts] = n;
+    for (int k = 1; k < parts; ++k) {
+        const uint64_t target = static_cast<uint64_t>(static_cast<long double>(prefix[n]) * k / parts);
+        int i = static_cast<int>(std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin());
+        bounds[k] = std::min(std::max(i, bounds[k - 1] + 1), n - (parts - k));
+    }
+    return bounds;
+}
+
+// 平面划分：块是格坐标上的矩形 [u0, u1) x [v0, v1)，同一列的块编号连续、按 v 递增
+struct Tiling {
+    struct Tile {
+        int u0, u1, v0, v1;
+        int halo; // 扩展区宽度（格）
+    };
+
+    int axisU = 0;
+    int axisV = 1;
+    double lo[2] = {};
+    double scale[2] = {};
+    std::vector<Tile> tiles;
+    std::vector<int> columnStart; // 列 c 的块为 [columnStart[c], columnStart[c + 1])
+    std::vector<int> columnOfU;   // 格 u 所在的列
+    std::vector<int> columnHalo;  // 列内最大的扩展区
+    std::vector<int> tileOfCell;  // kBins * kBins，格所在的块
+    int maxHalo = 0;
+
+    void cellOf(const double* p, int& bu, int& bv) const
+    {
+        bu = binOf(p[axisU], lo[0], scale[0]);
+        bv = binOf(p[axisV], lo[1], scale[1]);
+    }
+    int tileOf(const double* p) const
+    {
+        int bu, bv;
+        cellOf(p, bu, bv);
+        return tileOfCell[bu * kBins + bv];
+    }
+    bool inExpanded(int t, int bu, int bv, int halo) const
+    {
+        const Tile& r = tiles[t];
+        return bu >= r.u0 - halo && bu < r.u1 + halo && bv >= r.v0 - halo && bv < r.v1 + halo;
+    }
+    // 对扩展区（初始宽度）包含点 p 的每个块调用 fn(t)
+    template <typename Fn>
+    void forEachExpanded(const double* p, Fn fn) const
+    {
+        int bu, bv;
+        cellOf(p, bu, bv);
+        const int c0 = columnOfU[std::max(bu - maxHalo, 0)];
+        const int c1 = columnOfU[std::min(bu + maxHalo, kBins - 1)];
+        for (int c = c0; c <= c1; ++c) {
+            // 列内与 [bv - halo, bv + halo] 相交的块编号连续
+            const int u = tiles[columnStart[c]].u0;
+            const int t0 = tileOfCell[u * kBins + std::max(bv - columnHalo[c], 0)];
+            const int t1 = tileOfCell[u * kBins + std::min(bv + columnHalo[c], kBins - 1)];
+            for (int t = t0; t <= t1; ++t) {
+                if (inExpanded(t, bu, bv, tiles[t].halo)) fn(t);
+            }
+        }
+    }
+};
+
+// 按边数直方图划分，每块目标 edgesPerTile 条边。
+// span 为每格中边的最大跨度（格）。扩展区至少是块内最长边的两倍（不超过块本身的边长），
+// 这样起点在块内的三角形、四边形的点总是完整
+void buildTiling(Tiling& tiling, const std::vector<uint64_t>& hist, const std::vector<int>& span,
+                 uint64_t edgeCount, const TiledMeshingOptions& options)
+{
+    const uint64_t perTile = std::max<uint64_t>(options.edgesPerTile, 1);
+    const uint64_t tileTarget = std::max<uint64_t>((edgeCount + perTile - 1) / perTile, 1);
+
+    std::vector<uint64_t> columnCounts(kBins, 0);
+    for (int u = 0; u < kBins; ++u) {
+        for (int v = 0; v < kBins; ++v) columnCounts[u] += hist[u * kBins + v];
+    }
+    const int columns = static_cast<int>(std::min<uint64_t>(
+        std::max<uint64_t>(static_cast<uint64_t>(std::lround(std::sqrt(double(tileTarget)))), 1), kBins));
+    const std::vector<int> ub = splitQuantiles(columnCounts, columns);
+
+    tiling.tiles.clear();
+    tiling.columnStart.assign(1, 0);
+    tiling.columnOfU.assign(kBins, 0);
+    tiling.columnHalo.assign(columns, 0);
+    tiling.tileOfCell.assign(size_t(kBins) * kBins, 0);
+    tiling.maxHalo = 0;
+
+    std::vector<uint64_t> rowCounts(kBins);
+    for (int c = 0; c < columns; ++c) {
+        uint64_t columnTotal = 0;
+        std::fill(rowCounts.begin(), rowCounts.end(), 0);
+        for (int u = ub[c]; u < ub[c + 1]; ++u) {
+            tiling.columnOfU[u] = c;
+            columnTotal += columnCounts[u];
+            for (int v = 0; v < kBins; ++v) rowCounts[v] += hist[u * kBins + v];
+        }
+        // 每列按自己的边数决定行数，稀疏的列块少
+        const int rows = static_cast<int>(std::min<uint64_t>(
+            std::max<uint64_t>((columnTotal + perTile - 1) / perTile, 1), kBins));
+        const std::vector<int> vb = splitQuantiles(rowCounts, rows);
+
+        for (int r = 0; r < rows; ++r) {
+            Tiling::Tile tile{ub[c], ub[c + 1], vb[r], vb[r + 1], 0};
+            const int extent = std::max(tile.u1 - tile.u0, tile.v1 - tile.v0);
+            int longest = 0;
+            for (int u = tile.u0; u < tile.u1; ++u) {
+                for (int v = tile.v0; v < tile.v1; ++v) longest = std::max(longest, span[u * kBins + v]);
+            }
+            tile.halo = std::max({1, static_cast<int>(std::ceil(options.haloFraction * extent)),
+                                  std::min(2 * longest, extent)});
+            tiling.columnHalo[c] = std::max(tiling.columnHalo[c], tile.halo);
+            tiling.maxHalo = std::max(tiling.maxHalo, tile.halo);
+
+            const int t = static_cast<int>(tiling.tiles.size());
+            for (int u = tile.u0; u < tile.u1; ++u) {
+                for (int v = tile.v0; v < tile.v1; ++v) tiling.tileOfCell[u * kBins + v] = t;
+            }
+            tiling.tiles.push_back(tile);
+        }
+        tiling.columnStart.push_back(static_cast<int>(tiling.tiles.size()));
+    }
+}
+
+} // namespace
+
+namespace meshio {
+
+bool meshBinaryTiled(const QString& inputFile, const QString& outputFile, const TiledMeshingOptions& options,
+                     TiledMeshingStats* tiledStats, IoStats* stats, QString* errorMessage, IoProgress* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto fail = [&](const QString& msg) {
+        if (errorMessage) *errorMessage = msg;
+        return false;
+    };
+
+    const QString inputPath = QFileInfo(inputFile).canonicalFilePath();
+    if (!inputPath.isEmpty() && inputPath == QFileInfo(outputFile).canonicalFilePath()) {
+        return fail("Output file must be different from the input file.");
+    }
+
+    QFile in(inputFile);
+    if (!in.open(QIODevice::ReadOnly)) return fail("Cannot open file!");
+    if (detectCompression(in) != Compression::None) {
+        return fail("Tiled meshing needs an uncompressed .mpb file.");
+    }
+    const qint64 size = in.size();
+    const uchar* base = size > 0 ? in.map(0, size) : nullptr;
+    if (!base) return fail("Cannot map file into memory.");
+
+    BinaryHeader h;
+    if (!readBinaryHeader(base, static_cast<uint64_t>(size), h, errorMessage)) return false;
+
+    const uint64_t nodeCount = h.nodeCount;
+    const uint64_t elementCount = h.elementCount;
+    const double* xyz = reinterpret_cast<const double*>(base + h.nodeBlock);
+    const BinaryElement* elems = reinterpret_cast<const BinaryElement*>(base + h.elementBlock);
+    auto validElement = [&](const BinaryElement& e) {
+        return e.startNodeId >= 0 && e.endNodeId >= 0
+            && uint64_t(e.startNodeId) < nodeCount && uint64_t(e.endNodeId) < nodeCount;
+    };
+
+    const QString tempDir = options.tempDir.isEmpty() ? QFileInfo(outputFile).absolutePath() : options.tempDir;
+    TiledMeshingStats ts;
+
+    // 各阶段按固定比例折算成进度；返回 false 表示已取消
+    if (progress) progress->bytesTotal = size;
+    auto report = [&](double fraction) {
+        if (!progress) return true;
+        progress->bytesDone = static_cast<qint64>(fraction * size);
+        return !progress->isCancelled();
+    };
+    auto cancelled = [&]() { return fail("Meshing cancelled."); };
+
+    // --- 1. 点的度数 ---
+    TempArray<uint32_t> degree;
+    if (!degree.create(tempDir, nodeCount, errorMessage)) return false;
+    uint64_t edgeCount = 0;
+    for (uint64_t i = 0; i < elementCount; ++i) {
+        if ((i % kProgressRecords) == 0 && !report(0.1 * i / elementCount)) return cancelled();
+        const BinaryElement& e = elems[i];
+        if (!validElement(e)) {
+            ++ts.skippedElements;
+            continue;
+        }
+        ++degree[uint32_t(e.startNodeId)];
+        ++degree[uint32_t(e.endNodeId)];
+        ++edgeCount;
+    }
+
+    // --- 2. 排序参考，顺便求参与连线的点的范围 ---
+    cgal_tools::MeshingReferenceBuilder referenceBuilder;
+    double lo[3], hi[3];
+    for (int k = 0; k < 3; ++k) {
+        lo[k] = std::numeric_limits<double>::infinity();
+        hi[k] = -std::numeric_limits<double>::infinity();
+    }
+    int pass = 0;
+    do {
+        for (uint64_t v = 0; v < nodeCount; ++v) {
+            if ((v % kProgressRecords) == 0 && !report(0.1 + 0.1 * (pass + double(v) / nodeCount) / 3)) {
+                return cancelled();
+            }
+            const double* p = xyz + 3 * v;
+            const bool used = degree[v] > 0;
+            referenceBuilder.add(p[0], p[1], p[2], used);
+            if (pass == 0 && used) {
+                for (int k = 0; k < 3; ++k) {
+                    lo[k] = std::min(lo[k], p[k]);
+                    hi[k] = std::max(hi[k], p[k]);
+                }
+            }
+        }
+        ++pass;
+    } while (referenceBuilder.next_pass());
+    const cgal_tools::MeshingReference reference = referenceBuilder.result();
+
+    // --- 3. 划分 ---
+    Tiling tiling;
+    int axes[3] = {0, 1, 2};
+    std::sort(axes, axes + 3, [&](int a, int b) { return hi[a] - lo[a] > hi[b] - lo[b]; });
+    tiling.axisU = axes[0];
+    tiling.axisV = axes[1];
+    for (int k = 0; k < 2; ++k) {
+        const int axis = k == 0 ? tiling.axisU : tiling.axisV;
+        const double extent = hi[axis] - lo[axis];
+        tiling.lo[k] = edgeCount > 0 ? lo[axis] : 0.0;
+        tiling.scale[k] = edgeCount > 0 && extent > 0.0 ? kBins / extent : 0.0;
+    }
+
+    std::vector<uint64_t> hist(size_t(kBins) * kBins, 0);
+    std::vector<int> span(size_t(kBins) * kBins, 0);
+    for (uint64_t i = 0; i < elementCount; ++i) {
+        if ((i % kProgressRecords) == 0 && !report(0.2 + 0.05 * i / elementCount)) return cancelled();
+        if (!validElement(elems[i])) continue;
+        int bu, bv, cu, cv;
+        tiling.cellOf(xyz + 3 * uint64_t(elems[i].startNodeId), bu, bv);
+        tiling.cellOf(xyz + 3 * uint64_t(elems[i].endNodeId), cu, cv);
+        ++hist[bu * kBins + bv];
+        const int length = std::max(std::abs(bu - cu), std::abs(bv - cv)) + 1;
+        span[bu * kBins + bv] = std::max(span[bu * kBins + bv], length);
+        span[cu * kBins + cv] = std::max(span[cu * kBins + cv], length);
+    }
+    buildTiling(tiling, hist, span, edgeCount, options);
+    hist = std::vector<uint64_t>();
+    span = std::vector<int>();
+    const int tileCount = edgeCount > 0 ? static_cast<int>(tiling.tiles.size()) : 0;
+    ts.tiles = tileCount;
+
+    // --- 4. 按块分桶：先计数，再填入 ---
+    std::vector<int> edgeTiles;
+    auto collectTiles = [&](const BinaryElement& e) {
+        edgeTiles.clear();
+        auto add = [&](int t) { edgeTiles.push_back(t); };
+        tiling.forEachExpanded(xyz + 3 * uint64_t(e.startNodeId), add);
+        tiling.forEachExpanded(xyz + 3 * uint64_t(e.endNodeId), add);
+        std::sort(edgeTiles.begin(), edgeTiles.end());
+        edgeTiles.erase(std::unique(edgeTiles.begin(), edgeTiles.end()), edgeTiles.end());
+    };
+
+    std::vector<uint64_t> bucketOffsets(tileCount + 1, 0);
+    for (uint64_t i = 0; tileCount > 0 && i < elementCount; ++i) {
+        if ((i % kProgressRecords) == 0 && !report(0.25 + 0.05 * i / elementCount)) return cancelled();
+        if (!validElement(elems[i])) continue;
+        collectTiles(elems[i]);
+        for (int t : edgeTiles) ++bucketOffsets[t + 1];
+    }
+    for (int t = 0; t < tileCount; ++t) bucketOffsets[t + 1] += bucketOffsets[t];
+
+    TempArray<uint64_t> buckets;
+    if (!buckets.create(tempDir, bucketOffsets[tileCount], errorMessage)) return false;
+    {
+        std::vector<uint64_t> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+        for (uint64_t i = 0; tileCount > 0 && i < elementCount; ++i) {
+            if ((i % kProgressRecords) == 0 && !report(0.3 + 0.05 * i / elementCount)) return cancelled();
+            if (!validElement(elems[i])) continue;
+            collectTiles(elems[i]);
+            for (int t : edgeTiles) buckets[cursor[t]++] = i;
+        }
+    }
+
+    // --- 5. 逐块重建 ---
+    TempStream indexFile, sizeFile, propFile;
+    if (!indexFile.create(tempDir, errorMessage) || !sizeFile.create(tempDir, errorMessage)
+        || !propFile.create(tempDir, errorMessage)) {
+        return false;
+    }
+
+    TileWorkspace workspace;
+    workspace.set_reference(&reference);
+    if (progress) workspace.set_cancel_flag(&progress->cancelled);
+
+    std::vector<uint64_t> tileEdges;
+    std::vector<uint32_t> vertices;  // 局部点 -> 全局节点
+    std::vector<uint32_t> localDegree;
+    std::vector<std::array<double, 3>> points;
+    std::vector<std::array<uint32_t, 3>> edges;
+    std::vector<std::array<double, 3>> edgesInfo;
+    std::vector<int32_t> outIndices;
+    std::vector<uint32_t> outSizes;
+    std::vector<FaceProperties> outProps;
+    uint64_t faceCount = 0;
+    uint64_t faceIndexCount = 0;
+
+    for (int t = 0; t < tileCount; ++t) {
+        if (!report(0.35 + 0.55 * t / tileCount)) return cancelled();
+
+        tileEdges.assign(buckets.data() + bucketOffsets[t], buckets.data() + bucketOffsets[t + 1]);
+        int halo = tiling.tiles[t].halo;
+
+        for (int attempt = 0;; ++attempt) {
+            ts.maxTileEdges = std::max(ts.maxTileEdges, tileEdges.size());
+
+            // 块内的点按全局编号排序，边保持全局顺序
+            vertices.clear();
+            for (uint64_t i : tileEdges) {
+                vertices.push_back(uint32_t(elems[i].startNodeId));
+                vertices.push_back(uint32_t(elems[i].endNodeId));
+            }
+            std::sort(vertices.begin(), vertices.end());
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+            auto localOf = [&](int32_t id) {
+                return uint32_t(std::lower_bound(vertices.begin(), vertices.end(), uint32_t(id)) - vertices.begin());
+            };
+
+            points.resize(vertices.size());
+            for (size_t v = 0; v < vertices.size(); ++v) {
+                const double* p = xyz + 3 * uint64_t(vertices[v]);
+                points[v] = {p[0], p[1], p[2]};
+            }
+            localDegree.assign(vertices.size(), 0);
+            edges.clear();
+            edgesInfo.clear();
+            for (uint64_t i : tileEdges) {
+                const BinaryElement& e = elems[i];
+                const uint32_t a = localOf(e.startNodeId), b = localOf(e.endNodeId);
+                const bool isArc = e.type == TYPE_ARC;
+                ++localDegree[a];
+                ++localDegree[b];
+                edges.push_back({a, b, isArc ? 1u : 0u});
+                edgesInfo.push_back(isArc ? std::array<double, 3>{e.mid[0], e.mid[1], e.mid[2]}
+                                          : std::array<double, 3>{0.0, 0.0, 0.0});
+            }
+
+            try {
+                cgal_tools::reconstruct_meshes(points, edges, edgesInfo, workspace);
+            } catch (const std::exception& ex) {
+                return fail(QString("Meshing failed: %1").arg(ex.what()));
+            }
+            if (workspace.cancelled()) return cancelled();
+            ts.peakWorkspaceBytes = std::max(ts.peakWorkspaceBytes, workspace.high_water_bytes());
+
+            // 只保留起点在本块内的面；其中有点度数不完整的面需要更大的扩展区
+            const auto& offsets = workspace.face_offsets();
+            const auto& indices = workspace.face_indices();
+            const auto& props = workspace.face_properties();
+            outIndices.clear();
+            outSizes.clear();
+            outProps.clear();
+            size_t incomplete = 0;
+            for (size_t f = 0; f < workspace.face_count(); ++f) {
+                const uint32_t begin = offsets[f], end = offsets[f + 1];
+                if (tiling.tileOf(xyz + 3 * uint64_t(vertices[indices[begin]])) != t) continue;
+                bool complete = true;
+                for (uint32_t k = begin; k < end && complete; ++k) {
+                    complete = localDegree[indices[k]] == degree[vertices[indices[k]]];
+                }
+                if (!complete) {
+                    ++incomplete;
+                    continue;
+                }
+                for (uint32_t k = begin; k < end; ++k) outIndices.push_back(int32_t(vertices[indices[k]]));
+                outSizes.push_back(end - begin);
+                outProps.push_back(props[f]);
+            }
+
+            if (incomplete == 0 || attempt >= options.maxRetries) {
+                ts.droppedFaces += incomplete;
+                break;
+            }
+
+            // 扩展区加倍后重新收集本块的边：端点落在新扩展区里的边，一定在该端点所在块的桶里
+            ++ts.retries;
+            halo *= 2;
+            const Tiling::Tile& r = tiling.tiles[t];
+            tileEdges.clear();
+            for (int n = 0; n < tileCount; ++n) {
+                const Tiling::Tile& o = tiling.tiles[n];
+                if (o.u1 <= r.u0 - halo || o.u0 >= r.u1 + halo || o.v1 <= r.v0 - halo || o.v0 >= r.v1 + halo) continue;
+                for (uint64_t k = bucketOffsets[n]; k < bucketOffsets[n + 1]; ++k) {
+                    const BinaryElement& e = elems[buckets[k]];
+                    int bu, bv, cu, cv;
+                    tiling.cellOf(xyz + 3 * uint64_t(e.startNodeId), bu, bv);
+                    tiling.cellOf(xyz + 3 * uint64_t(e.endNodeId), cu, cv);
+                    if (tiling.inExpanded(t, bu, bv, halo) || tiling.inExpanded(t, cu, cv, halo)) {
+                        tileEdges.push_back(buckets[k]);
+                    }
+                }
+            }
+            std::sort(tileEdges.begin(), tileEdges.end());
+            tileEdges.erase(std::unique(tileEdges.begin(), tileEdges.end()), tileEdges.end());
+        }
+
+        if (!indexFile.append(outIndices) || !sizeFile.append(outSizes) || !propFile.append(outProps)) {
+            return fail(QString("Cannot write temporary file in %1.").arg(tempDir));
+        }
+        faceCount += outSizes.size();
+        faceIndexCount += outIndices.size();
+    }
+    workspace.release();
+    ts.faces = static_cast<size_t>(faceCount);
+
+    // --- 6. 写出 ---
+    BinaryHeader oh{};
+    oh.flags = faceCount > 0 ? FLAG_FACES : 0;
+    oh.nodeCount = nodeCount;
+    oh.elementCount = elementCount;
+    oh.faceCount = faceCount;
+    oh.faceIndexCount = faceIndexCount;
+    layoutBinaryHeader(oh);
+
+    const Compression compression = compressionForName(outputFile);
+    if (!compressionSupported(compression, errorMessage)) return false;
+
+    QFile file(outputFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return fail("Cannot write to file!");
+    std::unique_ptr<OutputStream> out = openOutput(file, compression, errorMessage);
+    if (!out) return false;
+
+    BlockWriter writer(*out);
+    // 大块分段写出，途中汇报进度
+    const double outputBytes = double(oh.nodeCount * 3 * sizeof(double) + oh.elementCount * sizeof(BinaryElement)
+                                      + oh.faceIndexCount * sizeof(int32_t) + oh.faceCount * sizeof(FaceProperties)) + 1.0;
+    uint64_t copied = 0;
+    auto copy = [&](const uchar* p, uint64_t bytes) {
+        for (uint64_t done = 0; done < bytes; done += kCopyChunk) {
+            if (!report(0.9 + 0.1 * (copied + done) / outputBytes)) return false;
+            writer.put(p + done, static_cast<size_t>(std::min(kCopyChunk, bytes - done)));
+        }
+        copied += bytes;
+        return true;
+    };
+
+    writer.put(&oh, sizeof(oh));
+    writer.padTo(oh.nodeBlock);
+    if (!copy(reinterpret_cast<const uchar*>(xyz), nodeCount * 3 * sizeof(double))) return cancelled();
+    writer.padTo(oh.elementBlock);
+    if (!copy(reinterpret_cast<const uchar*>(elems), elementCount * sizeof(BinaryElement))) return cancelled();
+
+    if (faceCount > 0) {
+        const uint32_t* sizes = reinterpret_cast<const uint32_t*>(sizeFile.map());
+        const uchar* indices = indexFile.map();
+        const uchar* props = propFile.map();
+        if (!sizes || !indices || !props) return fail(QString("Cannot map temporary file in %1.").arg(tempDir));
+
+        writer.padTo(oh.faceOffsetBlock);
+        uint64_t offset = 0;
+        writer.put(&offset, sizeof(offset));
+        for (uint64_t f = 0; f < faceCount; ++f) {
+            offset += sizes[f];
+            writer.put(&offset, sizeof(offset));
+        }
+        writer.padTo(oh.faceIndexBlock);
+        if (!copy(indices, faceIndexCount * sizeof(int32_t))) return cancelled();
+        writer.padTo(oh.facePropBlock);
+        if (!copy(props, faceCount * sizeof(FaceProperties))) return cancelled();
+    }
+    writer.flush();
+    if (!(out->finish() && writer.ok())) return fail("Cannot write to file!");
+    if (progress) progress->bytesDone = size;
+
+    if (tiledStats) *tiledStats = ts;
+    if (stats) {
+        stats->bytes = size;
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->nodes = static_cast<size_t>(nodeCount);
+        stats->elements = static_cast<size_t>(elementCount);
+    }
+    return true;
+}
+
+} // namespace meshio
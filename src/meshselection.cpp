@@ -0,0 +1,89 @@
+#include "meshselection.h"
+#include <QItemSelectionModel>
+#include <QAbstractItemModel>
+#include <algorithm>
+
+// ---------------- RowSelection ----------------
+
+void RowSelection::apply(const QItemSelection& selected, const QItemSelection& deselected)
+{
+    setRows(deselected, false);
+    setRows(selected, true);
+}
+
+void RowSelection::setRows(const QItemSelection& ranges, bool value)
+{
+    for (const QItemSelectionRange& range : ranges) {
+        const int last = std::min(range.bottom(), static_cast<int>(m_bits.size()) - 1);
+        for (int row = std::max(range.top(), 0); row <= last; ++row) {
+            // 整行选中时每列各是一个索引，同一行只计一次
+            if (m_bits[row] == value) continue;
+            m_bits[row] = value;
+            m_count += value ? 1 : -1;
+        }
+    }
+}
+
+void RowSelection::insertRows(int first, int last)
+{
+    first = std::min(std::max(first, 0), static_cast<int>(m_bits.size()));
+    m_bits.insert(m_bits.begin() + first, static_cast<size_t>(last - first + 1), false);
+}
+
+void RowSelection::removeRows(int first, int last)
+{
+    last = std::min(last, static_cast<int>(m_bits.size()) - 1);
+    if (first < 0 || first > last) return;
+    for (int row = first; row <= last; ++row) {
+        if (m_bits[row]) --m_count;
+    }
+    m_bits.erase(m_bits.begin() + first, m_bits.begin() + last + 1);
+}
+
+void RowSelection::reset(int rowCount)
+{
+    m_bits.assign(static_cast<size_t>(rowCount), false);
+    m_count = 0;
+}
+
+// ---------------- MeshSelection ----------------
+
+MeshSelection::MeshSelection(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void MeshSelection::attach(QItemSelectionModel *nodes, QItemSelectionModel *elements)
+{
+    track(nodes, &m_nodes);
+    track(elements, &m_elements);
+}
+
+void MeshSelection::track(QItemSelectionModel *selection, RowSelection *rows)
+{
+    const QAbstractItemModel *model = selection->model();
+    rows->reset(model->rowCount());
+
+    // 删除行时 QItemSelectionModel 先按删除前的行号发出取消选中，之后才是 rowsRemoved，
+    // 两者顺序固定，位图始终与表格一致
+    connect(selection, &QItemSelectionModel::selectionChanged, this,
+            [this, rows](const QItemSelection& selected, const QItemSelection& deselected) {
+        rows->apply(selected, deselected);
+        emit changed();
+    });
+    connect(model, &QAbstractItemModel::rowsInserted, this,
+            [rows](const QModelIndex& parent, int first, int last) {
+        if (!parent.isValid()) rows->insertRows(first, last);
+    });
+    connect(model, &QAbstractItemModel::rowsRemoved, this,
+            [this, rows](const QModelIndex& parent, int first, int last) {
+        if (parent.isValid()) return;
+        rows->removeRows(first, last);
+        emit changed();
+    });
+    // 模型重置时 QItemSelectionModel 清空选择但不发 selectionChanged
+    connect(model, &QAbstractItemModel::modelReset, this, [this, rows, model]() {
+        rows->reset(model->rowCount());
+        emit changed();
+    });
+}
@@ -0,0 +1,61 @@
+#ifndef MESHSELECTION_H
+#define MESHSELECTION_H
+
+#include <QObject>
+#include <QItemSelection>
+#include <vector>
+
+class QItemSelectionModel;
+
+// 一张表的选中状态：按行号的位图，加上选中数量
+class RowSelection
+{
+public:
+    bool contains(int row) const {
+        return row >= 0 && static_cast<size_t>(row) < m_bits.size() && m_bits[row];
+    }
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    // 只处理变化的部分，代价与选中/取消的行数成正比
+    void apply(const QItemSelection& selected, const QItemSelection& deselected);
+    // 行增删时位图跟着移动（与表格的行号保持一致）
+    void insertRows(int first, int last);
+    void removeRows(int first, int last);
+    void reset(int rowCount);
+
+private:
+    void setRows(const QItemSelection& ranges, bool value);
+
+    std::vector<bool> m_bits;
+    int m_count = 0;
+};
+
+// 节点表和单元表共用的选中状态，3D 视图直接按行号查询。
+// 由表格的 QItemSelectionModel 增量驱动：selectionChanged 只带变化的区间，
+// 行的增删和模型重置通过模型信号同步，不再在每次选中变化时遍历所有选中行
+class MeshSelection : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MeshSelection(QObject *parent = nullptr);
+
+    // 绑定两张表的选择模型（模型需已设置好）。应先于其它 selectionChanged 的连接调用，
+    // 这样其它槽函数里读到的已经是更新后的状态
+    void attach(QItemSelectionModel *nodes, QItemSelectionModel *elements);
+
+    const RowSelection& nodes() const { return m_nodes; }
+    const RowSelection& elements() const { return m_elements; }
+
+signals:
+    void changed();
+
+private:
+    void track(QItemSelectionModel *model, RowSelection *rows);
+
+    RowSelection m_nodes;
+    RowSelection m_elements;
+};
+
+#endif // MESHSELECTION_H
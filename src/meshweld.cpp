@@ -0,0 +1,335 @@
+#include "meshweld.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// 节点数达到此值才多线程查找邻近点
+constexpr size_t kParallelMinNodes = 100000;
+
+inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// -0.0 与 0.0 按同一个值处理
+inline uint64_t bitsOf(double v)
+{
+    if (v == 0.0) v = 0.0;
+    uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+inline bool isFinite(const Node& n)
+{
+    return std::isfinite(n.x) && std::isfinite(n.y) && std::isfinite(n.z);
+}
+
+inline uint64_t exactKey(const Node& n)
+{
+    return mix64(mix64(mix64(bitsOf(n.x)) ^ bitsOf(n.y)) ^ bitsOf(n.z));
+}
+
+inline uint64_t cellKey(int64_t ix, int64_t iy, int64_t iz)
+{
+    return mix64(mix64(mix64(uint64_t(ix)) ^ uint64_t(iy)) ^ uint64_t(iz));
+}
+
+// 按 64 位键分桶的只读表（计数排序建表）。同一个桶里保持加入的顺序；
+// 不同的键可能落进同一个桶，使用时要自己比较内容
+struct BucketTable {
+    std::vector<size_t> start; // 桶 b 的内容为 items[start[b], start[b + 1])
+    std::vector<int> items;
+    uint64_t mask = 0;
+
+    void build(const std::vector<int>& ids, const std::vector<uint64_t>& keys)
+    {
+        size_t buckets = 1;
+        while (buckets < ids.size() * 2) buckets <<= 1;
+        mask = buckets - 1;
+        start.assign(buckets + 1, 0);
+        for (uint64_t k : keys) ++start[(k & mask) + 1];
+        for (size_t b = 0; b < buckets; ++b) start[b + 1] += start[b];
+        items.resize(ids.size());
+        std::vector<size_t> cursor(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < ids.size(); ++i) items[cursor[keys[i] & mask]++] = ids[i];
+    }
+    const int* begin(uint64_t key) const { return items.data() + start[key & mask]; }
+    const int* end(uint64_t key) const { return items.data() + start[(key & mask) + 1]; }
+};
+
+// 把 [0, count) 均分给 threads 个线程执行 fn(begin, end)
+template <typename Fn>
+void parallelFor(size_t threads, size_t count, Fn fn)
+{
+    if (threads <= 1 || count == 0) {
+        fn(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    const size_t chunk = (count + threads - 1) / threads;
+    for (size_t t = 1; t < threads; ++t) {
+        const size_t begin = std::min(count, t * chunk);
+        const size_t end = std::min(count, begin + chunk);
+        pool.emplace_back([=]() { fn(begin, end); });
+    }
+    fn(size_t(0), std::min(count, chunk));
+    for (auto& th : pool) th.join();
+}
+
+// 并查集（无锁）：总是把较大的根挂到较小的根下，结束后每个集合的根就是其中最小的下标，与线程调度无关
+int ufFind(std::atomic<int>* parent, int x)
+{
+    while (true) {
+        int p = parent[x].load(std::memory_order_relaxed);
+        if (p == x) return x;
+        int gp = parent[p].load(std::memory_order_relaxed);
+        if (gp != p) parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed); // 路径减半
+        x = gp;
+    }
+}
+
+void ufUnite(std::atomic<int>* parent, int a, int b)
+{
+    while (true) {
+        a = ufFind(parent, a);
+        b = ufFind(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        int expected = a;
+        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+    }
+}
+
+inline double distance2(double ax, double ay, double az, double bx, double by, double bz)
+{
+    const double dx = ax - bx, dy = ay - by, dz = az - bz;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+} // namespace
+
+namespace meshweld {
+
+double defaultTolerance(const std::vector<Node>& nodes)
+{
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    double hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (const Node& n : nodes) {
+        if (!isFinite(n)) continue;
+        const double p[3] = {n.x, n.y, n.z};
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], p[k]);
+            hi[k] = std::max(hi[k], p[k]);
+        }
+    }
+    if (lo[0] > hi[0]) return 0.0;
+    return 1e-9 * std::sqrt(distance2(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]));
+}
+
+WeldStats weld(std::vector<Node>& nodes, std::vector<Element>& elements, const WeldOptions& options)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    WeldStats stats;
+    const double tol = options.tolerance >= 0.0 ? options.tolerance : defaultTolerance(nodes);
+    stats.tolerance = tol;
+    const double tol2 = tol * tol;
+    const size_t n = nodes.size();
+    const size_t threads = n >= kParallelMinNodes ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+
+    std::vector<std::atomic<int>> parent(n);
+    for (size_t i = 0; i < n; ++i) parent[i].store(static_cast<int>(i), std::memory_order_relaxed);
+
+    // 1. 坐标完全相同的点：按坐标哈希分桶，桶内按下标顺序，第一个相同的就是最小下标。
+    //    大量重复点先在这里合并，后面的距离查找只处理互不相同的点，不会在重复点上退化成平方
+    std::vector<int> ids;
+    ids.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (isFinite(nodes[i])) ids.push_back(static_cast<int>(i));
+    }
+    std::vector<uint64_t> keys(ids.size());
+    parallelFor(threads, ids.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) keys[k] = exactKey(nodes[ids[k]]);
+    });
+    std::vector<int> unique;
+    {
+        BucketTable table;
+        table.build(ids, keys);
+        std::vector<char> isUnique(ids.size(), 0);
+        parallelFor(threads, ids.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int i = ids[k];
+                const Node& a = nodes[i];
+                for (const int* j = table.begin(keys[k]); j != table.end(keys[k]); ++j) {
+                    const Node& b = nodes[*j];
+                    if (bitsOf(a.x) == bitsOf(b.x) && bitsOf(a.y) == bitsOf(b.y) && bitsOf(a.z) == bitsOf(b.z)) {
+                        // *j <= i，且 *j 自己一定是根（它前面没有相同的点），直接挂上
+                        if (*j == i) isUnique[k] = 1;
+                        else parent[i].store(*j, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+        });
+        for (size_t k = 0; k < ids.size(); ++k) {
+            if (isUnique[k]) unique.push_back(ids[k]);
+        }
+    }
+
+    // 2. 距离在 tol 之内的点：边长不小于 2 * tol 的网格，每个轴上只可能落在本格或靠近的那一侧的邻格，
+    //    每个点查 8 个格子
+    if (tol > 0.0 && unique.size() > 1) {
+        // 格子不能比坐标量级小太多，否则格子编号溢出
+        double maxAbs = 0.0;
+        for (int i : unique) maxAbs = std::max({maxAbs, std::abs(nodes[i].x), std::abs(nodes[i].y), std::abs(nodes[i].z)});
+        const double cell = std::max(2.0 * tol, std::ldexp(maxAbs, -40));
+        // c 为格子编号，side 为靠近的一侧（-1 / +1）
+        auto cellOf = [&](const Node& p, int64_t c[3], int side[3]) {
+            const double q[3] = {p.x / cell, p.y / cell, p.z / cell};
+            for (int k = 0; k < 3; ++k) {
+                const double f = std::floor(q[k]);
+                c[k] = static_cast<int64_t>(f);
+                side[k] = q[k] - f < 0.5 ? -1 : 1;
+            }
+        };
+
+        std::vector<uint64_t> cellKeys(unique.size());
+        parallelFor(threads, unique.size(), [&](size_t begin, size_t end) {
+            int64_t c[3];
+            int side[3];
+            for (size_t k = begin; k < end; ++k) {
+                cellOf(nodes[unique[k]], c, side);
+                cellKeys[k] = cellKey(c[0], c[1], c[2]);
+            }
+        });
+        BucketTable table;
+        table.build(unique, cellKeys);
+        // 坐标按表内顺序另存一份，查邻格时顺序读取，不再跳回 nodes
+        std::vector<std::array<double, 3>> pos(table.items.size());
+        parallelFor(threads, pos.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const Node& p = nodes[table.items[k]];
+                pos[k] = {p.x, p.y, p.z};
+            }
+        });
+
+        // 按表内顺序处理，同一个桶里的点连续访问
+        parallelFor(threads, table.items.size(), [&](size_t begin, size_t end) {
+            int64_t c[3];
+            int side[3];
+            for (size_t k = begin; k < end; ++k) {
+                const int i = table.items[k];
+                const std::array<double, 3>& a = pos[k];
+                cellOf(nodes[i], c, side);
+                for (int corner = 0; corner < 8; ++corner) {
+                    const uint64_t key = cellKey(c[0] + ((corner & 1) ? side[0] : 0),
+                                                 c[1] + ((corner & 2) ? side[1] : 0),
+                                                 c[2] + ((corner & 4) ? side[2] : 0));
+                    // 每对点只在下标大的一方处理一次；不同格子落进同一个桶时会重复检查，不影响结果
+                    const size_t first = table.start[key & table.mask];
+                    const size_t last = table.start[(key & table.mask) + 1];
+                    for (size_t m = first; m < last; ++m) {
+                        const int j = table.items[m];
+                        if (j >= i) continue;
+                        const std::array<double, 3>& b = pos[m];
+                        if (distance2(a[0], a[1], a[2], b[0], b[1], b[2]) <= tol2) {
+                            ufUnite(parent.data(), i, j);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // 3. 每个集合保留下标最小的点（根），按原顺序重新编号
+    std::vector<int> remap(n);
+    int kept = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const int root = ufFind(parent.data(), static_cast<int>(i));
+        remap[i] = root == static_cast<int>(i) ? kept++ : remap[root];
+    }
+    stats.mergedNodes = n - kept;
+    if (stats.mergedNodes > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            if (parent[i].load(std::memory_order_relaxed) != static_cast<int>(i)) continue;
+            nodes[remap[i]] = nodes[i];
+            nodes[remap[i]].id = remap[i];
+        }
+        nodes.resize(kept);
+    }
+
+    // 4. 线：端点换成新下标，去掉退化的和重复的，一遍完成
+    std::unordered_set<uint64_t> lines;
+    std::unordered_map<uint64_t, std::vector<int>> arcs; // 两端 -> 已保留的弧线下标
+    lines.reserve(elements.size());
+    size_t out = 0;
+    for (size_t k = 0; k < elements.size(); ++k) {
+        Element e = elements[k];
+        if (e.startNodeId < 0 || e.endNodeId < 0 || static_cast<size_t>(e.startNodeId) >= n
+            || static_cast<size_t>(e.endNodeId) >= n) {
+            ++stats.degenerateElements;
+            continue;
+        }
+        const int a = remap[e.startNodeId];
+        const int b = remap[e.endNodeId];
+        if (a == b) {
+            ++stats.degenerateElements;
+            continue;
+        }
+        const uint64_t key = uint64_t(std::min(a, b)) << 32 | uint32_t(std::max(a, b));
+        if (e.type == TYPE_ARC) {
+            // 两端相同的弧线可能是同一个圆的两半，中间点也重合才算重复
+            std::vector<int>& same = arcs[key];
+            const bool duplicate = std::any_of(same.begin(), same.end(), [&](int j) {
+                const Element& o = elements[j];
+                return distance2(e.midX, e.midY, e.midZ, o.midX, o.midY, o.midZ) <= tol2;
+            });
+            if (duplicate) {
+                ++stats.duplicateElements;
+                continue;
+            }
+            same.push_back(static_cast<int>(out));
+        } else if (!lines.insert(key).second) {
+            ++stats.duplicateElements;
+            continue;
+        }
+        e.id = static_cast<int>(out);
+        e.startNodeId = a;
+        e.endNodeId = b;
+        elements[out++] = e;
+    }
+    elements.resize(out);
+
+    stats.seconds = timer.nsecsElapsed() / 1e9;
+    return stats;
+}
+
+WeldStats weld(MeshData& data, const WeldOptions& options)
+{
+    std::vector<Node> nodes = data.getNodes();
+    std::vector<Element> elements = data.getElements();
+    WeldStats stats = weld(nodes, elements, options);
+    if (stats.changed()) {
+        std::vector<Face> faces;
+        data.swapData(nodes, elements, faces);
+    }
+    return stats;
+}
+
+} // namespace meshweld
@@ -0,0 +1,43 @@
+#ifndef MESHWELD_H
+#define MESHWELD_H
+
+#include <cstddef>
+#include <vector>
+#include "meshdata.h"
+
+// 焊接：合并重合的节点，并删掉由此产生的退化线和重复线。
+// 导入的线框常有重复的点和线，addNode 不会合并，走面时重复的线只有一条起作用，
+// 多出来的点线既占内存也会让面的查找出错
+namespace meshweld {
+
+struct WeldOptions {
+    // 距离不超过 tolerance 的节点合并到下标最小的那个（按距离链传递）；
+    // < 0 时用 defaultTolerance，= 0 时只合并坐标完全相同的点
+    double tolerance = -1.0;
+};
+
+struct WeldStats {
+    size_t mergedNodes = 0;        // 被合并掉的节点数
+    size_t degenerateElements = 0; // 两端合并成同一点（或端点无效）而删掉的线
+    size_t duplicateElements = 0;  // 与前面的线重复而删掉的线
+    double tolerance = 0.0;        // 实际使用的合并距离
+    double seconds = 0.0;
+
+    bool changed() const { return mergedNodes > 0 || degenerateElements > 0 || duplicateElements > 0; }
+};
+
+// 包围盒对角线的 1e-9 倍，只合并浮点误差级别的重合
+double defaultTolerance(const std::vector<Node>& nodes);
+
+// 原地焊接 nodes / elements，剩下的点和线保持原来的相对顺序，ID 按新下标重新编号。
+// 重复的线指两端相同（不分方向）且类型相同的线，弧线还要求中间点在 tolerance 之内；保留最先出现的一条。
+// 没有改动时两个数组保持原样
+WeldStats weld(std::vector<Node>& nodes, std::vector<Element>& elements,
+               const WeldOptions& options = WeldOptions());
+
+// 焊接 data（导入的数据在进场景之前用）。有改动时整体替换，并清空已有的面（点索引已经对不上）
+WeldStats weld(MeshData& data, const WeldOptions& options = WeldOptions());
+
+} // namespace meshweld
+
+#endif // MESHWELD_H
@@ -1,24 +1,30 @@
 #include "nodetablemodel.h"
 
+// 缓存的行数，覆盖几屏可见行即可
+constexpr int kTextCacheRows = 4096;
+
 NodeTableModel::NodeTableModel(MeshData *data, QObject *parent)
-    : QAbstractTableModel(parent), m_data(data)
+    : QAbstractTableModel(parent), m_data(data), m_text(kTextCacheRows)
 {
+    m_rowCount = static_cast<int>(m_data->getNodes().size());
+    m_data->addObserver(this);
 }
-void NodeTableModel::removeRow(int row)
+
+NodeTableModel::~NodeTableModel()
 {
-    beginRemoveRows(QModelIndex(), row, row);
+    m_data->removeObserver(this);
+}
 
-    // 2. 真正的删除数据
+void NodeTableModel::removeRow(int row)
+{
+    // 真正的删除数据；行的删除由 nodesRemoved 通知 View
     m_data->removeNodeAtIndex(row);
-
-    // 3. 通知 View：删除结束，请更新显示
-    endRemoveRows();
 }
 int NodeTableModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid()) return 0;
     // 行数 = 点的个数
-    return static_cast<int>(m_data->getNodes().size());
+    return m_rowCount;
 }
 
 int NodeTableModel::columnCount(const QModelIndex &parent) const
@@ -33,15 +39,27 @@ QVariant NodeTableModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || role != Qt::DisplayRole)
         return QVariant();
 
+    const int row = index.row();
+    if (row >= static_cast<int>(m_data->getNodes().size()))
+        return QVariant();
+
     // 获取当前行对应的点
-    const Node& node = m_data->getNodes()[index.row()];
+    const Node& node = m_data->getNodes()[row];
+    if (index.column() == 0) return node.id;
+
+    RowText *text = m_text.object(row);
+    if (!text) {
+        text = new RowText{QString::number(node.x, 'f', 2), // 保留2位小数
+                           QString::number(node.y, 'f', 2),
+                           QString::number(node.z, 'f', 2)};
+        m_text.insert(row, text);
+    }
 
     // 根据列号决定显示什么
     switch (index.column()) {
-    case 0: return node.id;
-    case 1: return QString::number(node.x, 'f', 2); // 保留2位小数
-    case 2: return QString::number(node.y, 'f', 2);
-    case 3: return QString::number(node.z, 'f', 2);
+    case 1: return text->x;
+    case 2: return text->y;
+    case 3: return text->z;
     default: return QVariant();
     }
 }
@@ -63,6 +81,34 @@ QVariant NodeTableModel::headerData(int section, Qt::Orientation orientation, in
 void NodeTableModel::refresh()
 {
     // 告诉View：数据要重置了，重新读取一下
+    resetRows();
+}
+
+void NodeTableModel::meshChanged(const MeshChangeSet& changes)
+{
+    if (changes.reset) {
+        resetRows();
+        return;
+    }
+    for (const MeshRowRange& r : changes.nodes) {
+        // 行号整体移动，缓存按行号存，直接作废（追加在末尾的不影响）
+        if (!r.inserted || r.first < m_rowCount) m_text.clear();
+        if (r.inserted) {
+            beginInsertRows(QModelIndex(), r.first, r.last);
+            m_rowCount += r.last - r.first + 1;
+            endInsertRows();
+        } else {
+            beginRemoveRows(QModelIndex(), r.first, r.last);
+            m_rowCount -= r.last - r.first + 1;
+            endRemoveRows();
+        }
+    }
+}
+
+void NodeTableModel::resetRows()
+{
     beginResetModel();
+    m_text.clear();
+    m_rowCount = static_cast<int>(m_data->getNodes().size());
     endResetModel();
 }
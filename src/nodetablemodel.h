@@ -2,9 +2,13 @@
 #define NODETABLEMODEL_H
 
 #include <QAbstractTableModel>
+#include <QCache>
+#include <QString>
 #include "meshdata.h" // 包含数据头文件
 
-class NodeTableModel : public QAbstractTableModel
+// 节点表格。监听 MeshData 的变化，只通知增删的行（不整表重置），
+// 坐标文字按行懒格式化并缓存，滚动和重绘时不重复调用 QString::number
+class NodeTableModel : public QAbstractTableModel, public MeshDataObserver
 {
     Q_OBJECT
 
@@ -12,6 +16,8 @@ public:
     void removeRow(int row);
     // 构造函数需要传入 MeshData 的指针，这样Model才能读到数据
     explicit NodeTableModel(MeshData *data, QObject *parent = nullptr);
+    // 会从 MeshData 注销监听，必须先于 MeshData 销毁
+    ~NodeTableModel() override;
 
     // 必须实现的三个虚函数
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -21,11 +27,23 @@ public:
     // 设置表头（显示 ID, X, Y, Z）
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
-    // 自定义函数：通知表格刷新
+    // 自定义函数：整表刷新（一般不需要，变化会自动通知）
     void refresh();
 
+    // MeshDataObserver：按区间依次插入/移除行
+    void meshChanged(const MeshChangeSet& changes) override;
+
 private:
+    void resetRows();
+
+    struct RowText {
+        QString x, y, z;
+    };
+
     MeshData *m_data; // 持有数据的指针
+    // View 看到的行数。MeshData 先改再通知，通知之前 View 仍按旧行数读取
+    int m_rowCount = 0;
+    mutable QCache<int, RowText> m_text;
 };
 
 #endif // NODETABLEMODEL_H
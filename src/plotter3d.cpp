@@ -1,10 +1,16 @@
 #include "plotter3d.h"
 #include <GL/gl.h> // 引入基础GL头文件
+#include <QOpenGLTimeMonitor>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// 流式绘制每帧最多上传的 float 数（4MB）
+constexpr size_t kStreamUploadBudget = 1 << 20;
+
 
 Plotter3D::Plotter3D(QWidget *parent) : QOpenGLWidget(parent)
 {
@@ -12,9 +18,51 @@ Plotter3D::Plotter3D(QWidget *parent) : QOpenGLWidget(parent)
     setFocusPolicy(Qt::StrongFocus);
 }
 
+Plotter3D::~Plotter3D()
+{
+    setMeshData(nullptr);
+
+    // 计时查询属于 GL 上下文，要在上下文当前时释放
+    makeCurrent();
+    for (QOpenGLTimeMonitor*& monitor : m_gpuMonitors) {
+        delete monitor;
+        monitor = nullptr;
+    }
+    doneCurrent();
+}
+
 void Plotter3D::setMeshData(MeshData *data)
 {
+    if (m_data) m_data->removeObserver(this);
     m_data = data;
+    if (m_data) m_data->addObserver(this);
+    update();
+}
+
+void Plotter3D::setSelection(const MeshSelection *selection)
+{
+    if (m_selection) disconnect(m_selection, nullptr, this, nullptr);
+    m_selection = selection;
+    if (m_selection) {
+        connect(m_selection, &MeshSelection::changed, this, [this]() { update(); });
+    }
+    update();
+}
+
+void Plotter3D::meshChanged(const MeshChangeSet& changes)
+{
+    // 高亮按行号保存，行有删除或整体替换时已经对不上
+    bool rowsRemoved = changes.reset;
+    for (const auto* list : {&changes.nodes, &changes.elements}) {
+        for (const MeshRowRange& r : *list) rowsRemoved = rowsRemoved || !r.inserted;
+    }
+    if (rowsRemoved) {
+        m_highlightIDs.clear();
+        m_highlightIndices.clear();
+        m_highlightElementIndices.clear();
+    }
+    // 流式导入时新数据由 collectStreamGeometry 按游标增量取走；重绘请求在一帧内自动合并
+    update();
 }
 
 void Plotter3D::initializeGL()
@@ -27,6 +75,21 @@ void Plotter3D::initializeGL()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f); // 深灰背景
+
+    // GPU 计时：每帧在各阶段之间打时间戳。驱动不支持计时查询时只统计 CPU
+    bool gpuTimer = true;
+    for (QOpenGLTimeMonitor*& monitor : m_gpuMonitors) {
+        monitor = new QOpenGLTimeMonitor;
+        monitor->setSampleCount(RenderStats::StageCount + 1);
+        gpuTimer = gpuTimer && monitor->create();
+    }
+    if (!gpuTimer) {
+        for (QOpenGLTimeMonitor*& monitor : m_gpuMonitors) {
+            delete monitor;
+            monitor = nullptr;
+        }
+    }
+    m_stats.gpuAvailable = gpuTimer;
 }
 
 void Plotter3D::resizeGL(int w, int h)
@@ -52,8 +115,16 @@ void Plotter3D::setShowFaceInfo(bool show)
     m_showFaceInfo = show;
     update(); // 【关键】状态改变后，立即触发重绘
 }
+void Plotter3D::setShowStats(bool show)
+{
+    m_showStats = show;
+    update();
+}
+
 void Plotter3D::paintGL()
 {
+    m_frameClock.start();
+
     // 1. 清除屏幕和深度缓存
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -87,17 +158,277 @@ void Plotter3D::paintGL()
     // m_modelView.translate(m_xPan, m_yPan, m_zoom);
 
 
-    // 3. 开始绘制
+    // 3. 开始绘制（每画完一个阶段记一次时间）
+    beginFrameStats();
+    if (m_streaming) {
+        // 流式导入中：只画已经上传的顶点缓冲，不画逐点文字
+        drawGrid();
+        endStage(RenderStats::Grid);
+        collectStreamGeometry();
+        size_t budget = kStreamUploadBudget;
+        bool done = uploadStream(m_streamLines, budget);
+        done = uploadStream(m_streamPoints, budget) && done;
+        endStage(RenderStats::Upload);
+        endStage(RenderStats::Faces);
+
+        glLineWidth(2.0f);
+        glColor3f(0.0f, 1.0f, 1.0f);
+        drawStream(m_streamLines, GL_LINES);
+        endStage(RenderStats::Lines);
+        glPointSize(8.0f);
+        glColor3f(1.0f, 1.0f, 0.0f);
+        drawStream(m_streamPoints, GL_POINTS);
+        endStage(RenderStats::Nodes);
+        endStage(RenderStats::Labels);
+        endFrameStats();
+
+        // 没传完的留到下一帧
+        if (!done) update();
+        return;
+    }
+
     drawGrid();  // 画网格背景
+    endStage(RenderStats::Grid);
+    endStage(RenderStats::Upload);
     drawFaces();
+    endStage(RenderStats::Faces);
     drawLines();
+    endStage(RenderStats::Lines);
     drawNodes(); // 画我们自己的数据点
+    endStage(RenderStats::Nodes);
 
     drawNodeIDs();
     if (m_showFaceInfo) {
         drawFaceInfo();
     }
+    endStage(RenderStats::Labels);
+    endFrameStats();
+}
+
+const char* RenderStats::stageName(int stage)
+{
+    static const char* const names[StageCount] = {"Grid", "Upload", "Faces", "Lines", "Nodes", "Labels"};
+    return stage >= 0 && stage < StageCount ? names[stage] : "";
+}
+
+void Plotter3D::beginFrameStats()
+{
+    ++m_stats.frame;
+    std::fill(std::begin(m_stats.cpuMs), std::end(m_stats.cpuMs), 0.0);
+    m_stats.drawCalls = 0;
+    m_stats.vertices = 0;
+    m_stats.points = 0;
+    m_stats.lineSegments = 0;
+    m_stats.polygons = 0;
+    m_stats.labels = 0;
+
+    // 先取回已经画完的帧的 GPU 时间；这一组查询还在等结果（GPU 落后太多）时本帧不计 GPU 时间
+    collectGpuStats();
+    m_gpuMonitor = m_gpuMonitors[m_gpuMonitorIndex];
+    if (m_gpuMonitor && m_gpuMonitorFrame[m_gpuMonitorIndex] != 0) m_gpuMonitor = nullptr;
+    if (m_gpuMonitor) m_gpuMonitor->recordSample();
+
+    m_stageStartNs = m_frameClock.nsecsElapsed();
+}
+
+void Plotter3D::endStage(RenderStats::Stage stage)
+{
+    const qint64 now = m_frameClock.nsecsElapsed();
+    m_stats.cpuMs[stage] = (now - m_stageStartNs) / 1e6;
+    m_stageStartNs = now;
+    if (m_gpuMonitor) m_gpuMonitor->recordSample();
+}
+
+void Plotter3D::endFrameStats()
+{
+    if (m_gpuMonitor) {
+        m_gpuMonitorFrame[m_gpuMonitorIndex] = m_stats.frame;
+        m_gpuMonitorIndex = (m_gpuMonitorIndex + 1) % kGpuMonitorCount;
+        m_gpuMonitor = nullptr;
+    }
+    m_stats.cpuFrameMs = m_frameClock.nsecsElapsed() / 1e6;
+
+    // 叠加层本身不计入统计
+    if (m_showStats) drawStatsOverlay();
+}
+
+void Plotter3D::collectGpuStats()
+{
+    // 从最早提交的一组开始，结果可用的依次读出，最后留下的是最新的一帧
+    for (int k = 0; k < kGpuMonitorCount; ++k) {
+        const int index = (m_gpuMonitorIndex + k) % kGpuMonitorCount;
+        QOpenGLTimeMonitor* monitor = m_gpuMonitors[index];
+        if (!monitor || m_gpuMonitorFrame[index] == 0 || !monitor->isResultAvailable()) continue;
+
+        const QList<GLuint64> intervals = monitor->waitForIntervals(); // 纳秒，结果已就绪，不会阻塞
+        if (intervals.size() == RenderStats::StageCount) {
+            m_stats.gpuFrameMs = 0.0;
+            for (int i = 0; i < RenderStats::StageCount; ++i) {
+                m_stats.gpuMs[i] = intervals[i] / 1e6;
+                m_stats.gpuFrameMs += m_stats.gpuMs[i];
+            }
+            m_stats.gpuFrame = m_gpuMonitorFrame[index];
+        }
+        monitor->reset();
+        m_gpuMonitorFrame[index] = 0;
+    }
 }
+
+void Plotter3D::drawStatsOverlay()
+{
+    const RenderStats& s = m_stats;
+    auto ms = [](double v) { return QString("%1").arg(v, 7, 'f', 2); };
+    const bool hasGpu = s.gpuAvailable && s.gpuFrame > 0;
+    const QString noGpu = QString("%1").arg(QString("-"), 7);
+
+    QStringList lines;
+    lines << QString("Frame %1").arg(s.frame)
+          << QString("%1 %2 %3").arg(QString("Stage"), -7).arg(QString("CPU ms"), 7).arg(QString("GPU ms"), 7);
+    for (int i = 0; i < RenderStats::StageCount; ++i) {
+        lines << QString("%1 %2 %3").arg(QString(RenderStats::stageName(i)), -7).arg(ms(s.cpuMs[i]))
+                     .arg(hasGpu ? ms(s.gpuMs[i]) : noGpu);
+    }
+    lines << QString("%1 %2 %3").arg(QString("Total"), -7).arg(ms(s.cpuFrameMs))
+                 .arg(hasGpu ? ms(s.gpuFrameMs) : noGpu);
+    if (hasGpu && s.gpuFrame != s.frame) {
+        lines << QString("(GPU from frame %1)").arg(s.gpuFrame);
+    }
+    lines << QString("Draw calls %1").arg(s.drawCalls)
+          << QString("Vertices   %1").arg(s.vertices)
+          << QString("Points %1  Segments %2").arg(s.points).arg(s.lineSegments)
+          << QString("Polygons %1  Labels %2").arg(s.polygons).arg(s.labels)
+          << (s.lastPickMs < 0 ? QString("Pick    -") : QString("Pick %1 ms").arg(s.lastPickMs, 0, 'f', 2));
+
+    QPainter painter(this);
+    QFont font("Courier New", 9);
+    font.setStyleHint(QFont::Monospace);
+    painter.setFont(font);
+    const QFontMetrics fm = painter.fontMetrics();
+
+    int textWidth = 0;
+    for (const QString& line : lines) textWidth = std::max(textWidth, fm.horizontalAdvance(line));
+    const int margin = 6;
+    const QRect box(8, 8, textWidth + 2 * margin, fm.lineSpacing() * lines.size() + 2 * margin);
+    painter.fillRect(box, QColor(0, 0, 0, 160));
+
+    painter.setPen(Qt::white);
+    int y = box.top() + margin + fm.ascent();
+    for (const QString& line : lines) {
+        painter.drawText(box.left() + margin, y, line);
+        y += fm.lineSpacing();
+    }
+}
+void Plotter3D::beginStreaming()
+{
+    m_streaming = true;
+    m_streamNodeCursor = 0;
+    m_streamElementCursor = 0;
+    for (StreamBuffer* buf : {&m_streamPoints, &m_streamLines}) {
+        buf->verts.clear();
+        buf->uploaded = 0;
+    }
+    update();
+}
+
+void Plotter3D::endStreaming()
+{
+    m_streaming = false;
+
+    // 回到常规绘制，释放缓冲
+    makeCurrent();
+    for (StreamBuffer* buf : {&m_streamPoints, &m_streamLines}) {
+        buf->vbo.destroy();
+        buf->verts = std::vector<float>();
+        buf->uploaded = 0;
+        buf->capacity = 0;
+    }
+    doneCurrent();
+    update();
+}
+
+void Plotter3D::collectStreamGeometry()
+{
+    if (!m_data) return;
+    const auto& nodes = m_data->getNodes();
+    const auto& elements = m_data->getElements();
+
+    // 新到的点
+    for (; m_streamNodeCursor < nodes.size(); ++m_streamNodeCursor) {
+        const Node& n = nodes[m_streamNodeCursor];
+        m_streamPoints.verts.insert(m_streamPoints.verts.end(), {float(n.x), float(n.y), float(n.z)});
+    }
+
+    // 新到的线（ID 即下标）。端点还没读到的线留到后面的帧
+    for (; m_streamElementCursor < elements.size(); ++m_streamElementCursor) {
+        const Element& elem = elements[m_streamElementCursor];
+        if (elem.startNodeId < 0 || elem.endNodeId < 0) continue;
+        if (static_cast<size_t>(elem.startNodeId) >= nodes.size()
+            || static_cast<size_t>(elem.endNodeId) >= nodes.size()) {
+            break;
+        }
+        const Node& n1 = nodes[elem.startNodeId];
+        const Node& n2 = nodes[elem.endNodeId];
+
+        auto& v = m_streamLines.verts;
+        if (elem.type == TYPE_ARC) {
+            std::vector<QVector3D> arcPts = generateArcPoints(n1, n2, elem);
+            for (size_t k = 0; k + 1 < arcPts.size(); ++k) {
+                v.insert(v.end(), {arcPts[k].x(), arcPts[k].y(), arcPts[k].z(),
+                                   arcPts[k + 1].x(), arcPts[k + 1].y(), arcPts[k + 1].z()});
+            }
+        } else {
+            v.insert(v.end(), {float(n1.x), float(n1.y), float(n1.z),
+                               float(n2.x), float(n2.y), float(n2.z)});
+        }
+    }
+}
+
+bool Plotter3D::uploadStream(StreamBuffer& buf, size_t& budget)
+{
+    if (!buf.vbo.isCreated()) {
+        buf.vbo.create();
+        buf.vbo.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    }
+    buf.vbo.bind();
+
+    // 容量不够时按倍数扩容，已上传的部分一次性重传，避免画面闪烁
+    if (buf.verts.size() > buf.capacity) {
+        buf.capacity = std::max({buf.verts.size(), buf.capacity * 2, size_t(1) << 16});
+        buf.vbo.allocate(static_cast<int>(buf.capacity * sizeof(float)));
+        if (buf.uploaded > 0) {
+            buf.vbo.write(0, buf.verts.data(), static_cast<int>(buf.uploaded * sizeof(float)));
+        }
+    }
+
+    // 增量上传新顶点，受每帧预算限制（按整顶点对齐，线按两个顶点对齐）
+    size_t pending = buf.verts.size() - buf.uploaded;
+    size_t count = pending <= budget ? pending : budget / 6 * 6;
+    if (count > 0) {
+        buf.vbo.write(static_cast<int>(buf.uploaded * sizeof(float)),
+                      buf.verts.data() + buf.uploaded, static_cast<int>(count * sizeof(float)));
+        buf.uploaded += count;
+        budget -= count;
+    }
+    buf.vbo.release();
+    return buf.uploaded == buf.verts.size();
+}
+
+void Plotter3D::drawStream(StreamBuffer& buf, GLenum mode)
+{
+    if (buf.uploaded == 0) return;
+
+    buf.vbo.bind();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    glDrawArrays(mode, 0, static_cast<GLsizei>(buf.uploaded / 3));
+    ++m_stats.drawCalls;
+    m_stats.vertices += buf.uploaded / 3;
+    if (mode == GL_POINTS) m_stats.points += buf.uploaded / 3;
+    else m_stats.lineSegments += buf.uploaded / 6;
+    glDisableClientState(GL_VERTEX_ARRAY);
+    buf.vbo.release();
+}
+
 int Plotter3D::pickNode(const QPoint& mousePos)
 {
     if (!m_data) return -1;
@@ -161,6 +492,10 @@ void Plotter3D::drawGrid()
     glColor3f(0.0, 1.0, 0.0); glVertex3f(0,0,0); glVertex3f(0,2,0); // Y绿
     glColor3f(0.0, 0.0, 1.0); glVertex3f(0,0,0); glVertex3f(0,0,2); // Z蓝
     glEnd();
+
+    m_stats.drawCalls += 2;
+    m_stats.lineSegments += 21 * 2 + 3;
+    m_stats.vertices += (21 * 2 + 3) * 2;
 }
 
 void Plotter3D::setHighlightIndices(const std::vector<int>& ids) // 参数改名 ids
@@ -178,10 +513,12 @@ void Plotter3D::drawNodes()
     glPointSize(8.0f);
     glBegin(GL_POINTS);
 
-    for (const auto& node : nodes) {
-        // 【核心修复】这里比对的是 node.id，而不是循环变量 i
-        bool isSelected = std::find(m_highlightIDs.begin(), m_highlightIDs.end(), node.id)
-                          != m_highlightIDs.end();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Node& node = nodes[i];
+        // 表格选中查位图；临时高亮比对的是 node.id，列表只有一两个
+        bool isSelected = (m_selection && m_selection->nodes().contains(static_cast<int>(i)))
+                          || std::find(m_highlightIDs.begin(), m_highlightIDs.end(), node.id)
+                                 != m_highlightIDs.end();
 
         if (isSelected) {
             glColor3f(0.0f, 1.0f, 0.0f); // 绿
@@ -191,68 +528,48 @@ void Plotter3D::drawNodes()
         glVertex3f(node.x, node.y, node.z);
     }
     glEnd();
+
+    ++m_stats.drawCalls;
+    m_stats.points += nodes.size();
+    m_stats.vertices += nodes.size();
 }
 
-std::vector<QVector3D> Plotter3D::generateArcPoints(const Node& n1, const Node& n2, const Node& n3)
+std::vector<QVector3D> Plotter3D::generateArcPoints(const Node& start, const Node& end, const Element& elem)
 {
     std::vector<QVector3D> points;
-    QVector3D p1(n1.x, n1.y, n1.z);
-    QVector3D p2(n2.x, n2.y, n2.z);
-    QVector3D p3(n3.x, n3.y, n3.z);
-
-    // 1. 共线检查
-    QVector3D v1 = p2 - p1;
-    QVector3D v2 = p3 - p1;
-    if (QVector3D::crossProduct(v1, v2).length() < 0.001f) {
-        points.push_back(p1); points.push_back(p2); points.push_back(p3);
+    const QVector3D p1(start.x, start.y, start.z);
+    const QVector3D p3(end.x, end.y, end.z);
+    const cgal_tools::ArcGeometry& arc = elem.arc;
+
+    // 1. 共线（或几何量还没算出）：按折线 起点 -> 中间点 -> 终点 画
+    if (!(arc.radius > 0.0) || !std::isfinite(arc.center[0])) {
+        points.push_back(p1);
+        points.push_back(QVector3D(elem.midX, elem.midY, elem.midZ));
+        points.push_back(p3);
         return points;
     }
 
-    // 2. 计算圆心 (经典公式)
-    QVector3D normal = QVector3D::crossProduct(v1, v2); // 法向量（未归一化）
-    float nSq = normal.lengthSquared();
-    QVector3D temp = v1.lengthSquared() * v2 - v2.lengthSquared() * v1;
-    QVector3D centerOffset = QVector3D::crossProduct(temp, normal) / (2.0f * nSq);
-    QVector3D center = p1 + centerOffset;
-    float radius = centerOffset.length();
-
-    // 3. 构建局部坐标系 (Basis)
-    QVector3D X = (p1 - center).normalized();            // X轴指向起点
-    QVector3D Z = normal.normalized();                   // Z轴是法线
-    QVector3D Y = QVector3D::crossProduct(Z, X).normalized(); // Y轴垂直于X
-
-    // 4. 计算角度 (在 X-Y 平面上)
-    // 起点肯定是 0度，因为 X轴就是 center->p1
-    double angStart = 0.0;
-
-    // 计算中间点角度
-    QVector3D vecP2 = (p2 - center).normalized();
-    double angMid = std::atan2(QVector3D::dotProduct(vecP2, Y), QVector3D::dotProduct(vecP2, X));
-
-    // 计算终点角度
-    QVector3D vecP3 = (p3 - center).normalized();
-    double angEnd = std::atan2(QVector3D::dotProduct(vecP3, Y), QVector3D::dotProduct(vecP3, X));
-
-    // 5. 强制角度顺序： Start(0) < Mid < End
-    // 这样保证我们画的弧线一定是从 1 经过 2 到 3
-    if (angMid < 0) angMid += 2.0 * M_PI; // 确保 Mid 是正的
-    if (angEnd < 0) angEnd += 2.0 * M_PI; // 确保 End 是正的
-
-    // 如果 End 比 Mid 小，说明转过头了，要加一圈
-    if (angEnd < angMid) angEnd += 2.0 * M_PI;
-
-    // 6. 插值生成点
-    int segments = 40;
-    for (int i = 0; i <= segments; ++i) {
-        float t = (float)i / segments;
-        // 在 Start 和 End 之间插值
-        float ang = angStart + t * (angEnd - angStart);
-
-        // 转回 3D 坐标
-        QVector3D pt = center + radius * (std::cos(ang) * X + std::sin(ang) * Y);
-        points.push_back(pt);
+    // 2. 局部坐标系（double）：X 轴指向起点，Z 轴为 -normal（绕它从起点经中间点转到终点）
+    const double* c = arc.center.data();
+    const double r = arc.radius;
+    const double X[3] = {(start.x - c[0]) / r, (start.y - c[1]) / r, (start.z - c[2]) / r};
+    const double nLen = std::sqrt(arc.normal[0] * arc.normal[0] + arc.normal[1] * arc.normal[1]
+                                  + arc.normal[2] * arc.normal[2]);
+    const double Z[3] = {-arc.normal[0] / nLen, -arc.normal[1] / nLen, -arc.normal[2] / nLen};
+    const double Y[3] = {Z[1] * X[2] - Z[2] * X[1], Z[2] * X[0] - Z[0] * X[2], Z[0] * X[1] - Z[1] * X[0]};
+
+    // 3. 按圆心角插值，首尾直接用端点，与直线、面的顶点严格重合
+    const int segments = 40;
+    points.reserve(segments + 1);
+    points.push_back(p1);
+    for (int i = 1; i < segments; ++i) {
+        const double ang = arc.sweep * i / segments;
+        const double cs = r * std::cos(ang), sn = r * std::sin(ang);
+        points.push_back(QVector3D(c[0] + cs * X[0] + sn * Y[0],
+                                   c[1] + cs * X[1] + sn * Y[1],
+                                   c[2] + cs * X[2] + sn * Y[2]));
     }
-
+    points.push_back(p3);
     return points;
 }
 // --- 交互逻辑 ---
@@ -263,16 +580,19 @@ void Plotter3D::mousePressEvent(QMouseEvent *event)
 
     if (event->button() == Qt::LeftButton) {
         // 策略：优先选点，如果点没选中，再试着选线
+        QElapsedTimer pickTimer;
+        pickTimer.start();
         int pickedNodeId = pickNode(m_lastPos);
+        // 如果没点中点，尝试点线
+        int pickedElemId = pickedNodeId == -1 ? pickLine(m_lastPos) : -1;
+        // 只计拾取本身，不含信号连着的表格更新
+        m_stats.lastPickMs = pickTimer.nsecsElapsed() / 1e6;
+        if (m_showStats) update();
 
         if (pickedNodeId != -1) {
             emit nodeClicked(pickedNodeId);
-        } else {
-            // 如果没点中点，尝试点线
-            int pickedElemId = pickLine(m_lastPos);
-            if (pickedElemId != -1) {
-                emit elementClicked(pickedElemId); // 发射新信号
-            }
+        } else if (pickedElemId != -1) {
+            emit elementClicked(pickedElemId); // 发射新信号
         }
     }
 }
@@ -316,14 +636,10 @@ void Plotter3D::setHighlightElementIndices(const std::vector<int>& indices)
 void Plotter3D::drawLines()
 {
     if (!m_data) return;
-    const auto& nodes = m_data->getNodes();
     const auto& elements = m_data->getElements();
 
-    // 查找节点的 Lambda
-    auto findNode = [&](int id) -> const Node* {
-        for (const auto& n : nodes) if (n.id == id) return &n;
-        return nullptr;
-    };
+    // 查找节点的 Lambda（ID 即下标，O(1)）
+    auto findNode = [&](int id) -> const Node* { return m_data->findNode(id); };
 
     // 遍历所有单元
     for (size_t i = 0; i < elements.size(); ++i) {
@@ -334,9 +650,10 @@ void Plotter3D::drawLines()
         if (!n1 || !n2) continue;
 
         // --- 1. 先决定样式 (高亮/颜色) ---
-        // 检查索引 i 是否在高亮列表中
-        bool isSelected = std::find(m_highlightElementIndices.begin(), m_highlightElementIndices.end(), static_cast<int>(i))
-                          != m_highlightElementIndices.end();
+        // 检查索引 i 是否被选中（位图 O(1)），或在额外的高亮列表中
+        bool isSelected = (m_selection && m_selection->elements().contains(static_cast<int>(i)))
+                          || std::find(m_highlightElementIndices.begin(), m_highlightElementIndices.end(), static_cast<int>(i))
+                                 != m_highlightElementIndices.end();
 
         if (isSelected) {
             glLineWidth(4.0f);           // 选中：粗线
@@ -353,15 +670,13 @@ void Plotter3D::drawLines()
             glVertex3f(n1->x, n1->y, n1->z);
             glVertex3f(n2->x, n2->y, n2->z);
             glEnd();
+            ++m_stats.drawCalls;
+            ++m_stats.lineSegments;
+            m_stats.vertices += 2;
         }
         else if (elem.type == TYPE_ARC) {
-            // 画弧线
-            Node nMid;
-            nMid.x = elem.midX;
-            nMid.y = elem.midY;
-            nMid.z = elem.midZ;
-
-            std::vector<QVector3D> arcPts = generateArcPoints(*n1, nMid, *n2);
+            // 画弧线（圆心、圆心角在数据层已经算好）
+            std::vector<QVector3D> arcPts = generateArcPoints(*n1, *n2, elem);
 
             // 注意：弧线是由多段小直线组成的，所以用 LINE_STRIP
             glBegin(GL_LINE_STRIP);
@@ -369,6 +684,9 @@ void Plotter3D::drawLines()
                 glVertex3f(pt.x(), pt.y(), pt.z());
             }
             glEnd();
+            ++m_stats.drawCalls;
+            m_stats.lineSegments += arcPts.size() - 1;
+            m_stats.vertices += arcPts.size();
         }
     }
 }
@@ -377,17 +695,13 @@ void Plotter3D::drawLines()
 int Plotter3D::pickLine(const QPoint& mousePos)
 {
     if (!m_data) return -1;
-    const auto& nodes = m_data->getNodes();
     const auto& elements = m_data->getElements();
 
     int closestId = -1;
     double minDist = 10.0; // 容差像素
     QRect viewport(0, 0, width(), height());
 
-    auto findNode = [&](int id) -> const Node* {
-        for (const auto& n : nodes) if (n.id == id) return &n;
-        return nullptr;
-    };
+    auto findNode = [&](int id) -> const Node* { return m_data->findNode(id); };
 
     for (const auto& elem : elements) {
         const Node* n1 = findNode(elem.startNodeId);
@@ -402,8 +716,7 @@ int Plotter3D::pickLine(const QPoint& mousePos)
             checkPoints.push_back(QVector3D(n2->x, n2->y, n2->z));
         }
         else if (elem.type == TYPE_ARC) {
-            Node nMid; nMid.x = elem.midX; nMid.y = elem.midY; nMid.z = elem.midZ;
-            checkPoints = generateArcPoints(*n1, nMid, *n2);
+            checkPoints = generateArcPoints(*n1, *n2, elem);
         }
 
         // 遍历所有小线段，计算距离
@@ -464,6 +777,7 @@ void Plotter3D::drawNodeIDs()
 
         // 绘制文字
         painter.drawText(QPointF(x + 5, y - 5), QString::number(node.id));
+        ++m_stats.labels;
     }
 
 }
@@ -471,13 +785,10 @@ void Plotter3D::drawNodeIDs()
 void Plotter3D::drawFaces()
 {
     if (!m_data) return;
-    const auto& nodes = m_data->getNodes();
 
     const auto& faces = m_data->getFaces();
-    auto findNode = [&](int id) -> const Node* {
-        for (const auto& n : nodes) if (n.id == id) return &n;
-        return nullptr;
-    };
+    const auto& elements = m_data->getElements();
+    auto findNode = [&](int id) -> const Node* { return m_data->findNode(id); };
 
     // --- 设置样式 ---
     glColor4f(0.3f, 0.3f, 0.3f, 0.4f);
@@ -491,13 +802,35 @@ void Plotter3D::drawFaces()
         glBegin(GL_POLYGON);
 
         // 遍历构成这个面的所有点索引
-        for (int nodeId : face.nodeIndices) {
-            const Node* n = findNode(nodeId);
-            if (n) {
-                glVertex3f(n->x, n->y, n->z);
+        const size_t count = face.nodeIndices.size();
+        const bool hasEdges = face.edgeIndices.size() == count;
+        for (size_t i = 0; i < count; ++i) {
+            const Node* n = findNode(face.nodeIndices[i]);
+            if (!n) continue;
+            glVertex3f(n->x, n->y, n->z);
+            ++m_stats.vertices;
+
+            // 经过弧线时补上弧上的点（单元 ID 即下标），面的轮廓才是弯的
+            if (!hasEdges) continue;
+            const int edgeId = face.edgeIndices[i];
+            if (edgeId < 0 || static_cast<size_t>(edgeId) >= elements.size()) continue;
+            const Element& elem = elements[edgeId];
+            if (elem.type != TYPE_ARC) continue;
+            const Node* n1 = findNode(elem.startNodeId);
+            const Node* n2 = findNode(elem.endNodeId);
+            if (!n1 || !n2) continue;
+            std::vector<QVector3D> arcPts = generateArcPoints(*n1, *n2, elem);
+            // 面沿反方向经过这条弧时倒序输出；首尾两点就是面的顶点，跳过
+            const bool reversed = face.nodeIndices[i] != elem.startNodeId;
+            for (size_t k = 1; k + 1 < arcPts.size(); ++k) {
+                const QVector3D& p = arcPts[reversed ? arcPts.size() - 1 - k : k];
+                glVertex3f(p.x(), p.y(), p.z());
+                ++m_stats.vertices;
             }
         }
         glEnd();
+        ++m_stats.drawCalls;
+        ++m_stats.polygons;
     }
 
     glDisable(GL_POLYGON_OFFSET_FILL);
@@ -532,5 +865,6 @@ void Plotter3D::drawFaceInfo()
         // 文字居中处理
         int textWidth = painter.fontMetrics().horizontalAdvance(text);
         painter.drawText(x - textWidth / 2, y, text);
+        ++m_stats.labels;
     }
 }
@@ -6,12 +6,44 @@
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include "meshdata.h" // 引用数据头文件
+#include "meshselection.h"
 #include <QMatrix4x4> // <--- 必须加
 #include <QVector3D>
 #include <QPainter>
+#include <QOpenGLBuffer>
+#include <QElapsedTimer>
+
+class QOpenGLTimeMonitor;
+
+// 渲染统计：最近一帧各阶段的 CPU / GPU 耗时、图元数，以及最近一次拾取的耗时。
+// GPU 时间来自计时查询，结果要等 GPU 画完才能取回，因此比 CPU 数据晚一两帧（见 gpuFrame）
+struct RenderStats {
+    // 阶段按一帧内的执行顺序排列；流式导入时 Upload 为整理并上传顶点缓冲，常规绘制时为空
+    enum Stage { Grid, Upload, Faces, Lines, Nodes, Labels, StageCount };
+    static const char* stageName(int stage);
+
+    quint64 frame = 0;              // 已绘制的帧数（即最近一帧的序号）
+    double cpuMs[StageCount] = {};  // 各阶段提交绘制命令的 CPU 耗时
+    double cpuFrameMs = 0.0;        // 整帧（含清屏、设置矩阵）的 CPU 耗时
+
+    // 驱动不支持计时查询时 gpuAvailable 为 false，其余 GPU 字段无意义
+    bool gpuAvailable = false;
+    quint64 gpuFrame = 0;           // GPU 时间对应的帧序号，0 表示还没有结果
+    double gpuMs[StageCount] = {};
+    double gpuFrameMs = 0.0;
+
+    // 图元数（最近一帧）
+    size_t drawCalls = 0;           // glBegin / glDrawArrays 次数
+    size_t vertices = 0;
+    size_t points = 0;
+    size_t lineSegments = 0;
+    size_t polygons = 0;
+    size_t labels = 0;              // 文字标签（节点 ID、面积）
+
+    double lastPickMs = -1.0;       // 最近一次鼠标拾取（点 + 线）的耗时，还没拾取过为 -1
+};
 
-
-class Plotter3D : public QOpenGLWidget, protected QOpenGLFunctions
+class Plotter3D : public QOpenGLWidget, protected QOpenGLFunctions, public MeshDataObserver
 {
     Q_OBJECT
 signals:
@@ -21,12 +53,27 @@ signals:
 
 public:
     explicit Plotter3D(QWidget *parent = nullptr);
+    ~Plotter3D() override;
 
-    // 传入数据指针
+    // 传入数据指针，并监听它的变化（数据变了自动重绘）。传 nullptr 解除监听
     void setMeshData(MeshData* data);
+    // 表格的选中状态（按行号），选中变化时自动重绘
+    void setSelection(const MeshSelection* selection);
+    // 连线/画弧过程中的临时高亮（节点 ID，通常只有一两个）
     void setHighlightIndices(const std::vector<int>& indices);
     void setHighlightElementIndices(const std::vector<int>& indices);
     void setShowFaceInfo(bool show);
+    // 在左上角叠加显示渲染统计
+    void setShowStats(bool show);
+    const RenderStats& renderStats() const { return m_stats; }
+
+    // 流式导入期间数据只在末尾追加：新到的点/线增量追加进顶点缓冲，
+    // 每帧只上传一部分，用顶点数组整批绘制，帧率不随已加载的数据量下降
+    void beginStreaming();
+    void endStreaming();
+
+    // MeshDataObserver
+    void meshChanged(const MeshChangeSet& changes) override;
 protected:
     // --- OpenGL 核心三个函数 ---
     void initializeGL() override; // 初始化
@@ -51,11 +98,47 @@ private:
     void drawFaceInfo();
 
 
-    // 生成弧线点
-    std::vector<QVector3D> generateArcPoints(const Node& n1, const Node& n2, const Node& n3);
+    // 生成弧线上的点（首尾为两端点），使用 Element 里预先算好的圆心、圆心角
+    std::vector<QVector3D> generateArcPoints(const Node& start, const Node& end, const Element& elem);
     void drawNodeIDs();
 
+    // 渲染统计
+    void beginFrameStats();
+    void endStage(RenderStats::Stage stage); // 按 Stage 顺序调用，没有内容的阶段也要调用
+    void endFrameStats();
+    void collectGpuStats();
+    void drawStatsOverlay();
+
+    RenderStats m_stats;
+    bool m_showStats = false;
+    QElapsedTimer m_frameClock;
+    qint64 m_stageStartNs = 0;
+    // 计时查询轮流使用几组，读取上一两帧的结果时不用等 GPU
+    static constexpr int kGpuMonitorCount = 3;
+    QOpenGLTimeMonitor* m_gpuMonitors[kGpuMonitorCount] = {};
+    quint64 m_gpuMonitorFrame[kGpuMonitorCount] = {}; // 在等结果的帧序号，0 表示空闲
+    QOpenGLTimeMonitor* m_gpuMonitor = nullptr;     // 当前帧使用的一组，本帧不计时为 nullptr
+    int m_gpuMonitorIndex = 0;
+
+    // 流式绘制
+    struct StreamBuffer {
+        QOpenGLBuffer vbo;
+        std::vector<float> verts; // xyz
+        size_t uploaded = 0;      // 已上传到 vbo 的 float 数
+        size_t capacity = 0;      // vbo 容量（float 数）
+    };
+    void collectStreamGeometry();
+    bool uploadStream(StreamBuffer& buf, size_t& budget);
+    void drawStream(StreamBuffer& buf, GLenum mode);
+
+    bool m_streaming = false;
+    size_t m_streamNodeCursor = 0;    // 已转成顶点的点数
+    size_t m_streamElementCursor = 0; // 已转成顶点的线数
+    StreamBuffer m_streamPoints;
+    StreamBuffer m_streamLines;       // GL_LINES 顶点对，弧线拆成小段
+
     MeshData* m_data = nullptr; // 数据源
+    const MeshSelection* m_selection = nullptr;
 
 
     // 相机参数